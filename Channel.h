@@ -0,0 +1,438 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "Channel.h needs C++20 coroutines (compile with -std=c++20)"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "LinkedList.h"
+#include "RingBuffer.h"
+using namespace std;
+
+// A LinkedList that coroutines can wait on: co_await channel.PopHead() suspends until data
+// arrives, and AddTail hands the data straight to the longest-waiting coroutine and schedules it
+// on a LocalExecutor. Everything runs on the executor's thread, so there are no locks, and
+// waiting allocates nothing: a waiter lives in its coroutine's frame.
+
+
+// A fire-and-forget coroutine for a LocalExecutor. It starts suspended, runs when the executor
+// gets to it and frees its own frame when it finishes. An exception escaping it terminates.
+class Task {
+
+	public:
+
+	struct promise_type {
+		Task get_return_object() {
+			return Task(coroutine_handle<promise_type>::from_promise(*this));
+		}
+		suspend_always initial_suspend() noexcept {
+			return {};
+		}
+		suspend_never final_suspend() noexcept {
+			return {};
+		}
+		void return_void() {
+		}
+		void unhandled_exception() {
+			terminate();
+		}
+	};
+
+	private:
+
+	// data members of the Task class
+	coroutine_handle<promise_type> handle;	// the coroutine until an executor takes it
+
+
+	public:
+
+	/* ---------- CONSTRUCTION / DESTRUCTION ---------- */
+
+	// a Task owns its coroutine, so it can be moved but not copied
+	Task(Task&& other) noexcept {
+		handle = exchange(other.handle, nullptr);
+	}
+
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+
+	// Destructor
+	// Destroys the coroutine if no executor ever took it.
+	~Task() {
+		if (handle) {
+			handle.destroy();
+		}
+	}
+
+
+	/* ---------- BEHAVIORS ---------- */
+
+	// Gives up ownership of the coroutine to whoever will resume it.
+	coroutine_handle<> Release() {
+		return exchange(handle, nullptr);
+	}
+
+
+	private:
+
+	explicit Task(coroutine_handle<promise_type> coroutine) {
+		handle = coroutine;
+	}
+};
+
+
+// Runs coroutines one at a time on the thread that calls Run, in the order they became ready.
+// The ready queue is a Ring LinkedList, so scheduling does not allocate once it has grown.
+class LocalExecutor {
+
+	// data members of the LocalExecutor class
+	LinkedList<coroutine_handle<>, Ring> ready;		// coroutines waiting for their turn
+	unsigned long long resumed;						// coroutines resumed so far
+
+
+	public:
+
+	// the awaitable returned by Yield
+	struct YieldAwaiter {
+		LocalExecutor& executor;
+
+		bool await_ready() const noexcept {
+			return false;
+		}
+		void await_suspend(coroutine_handle<> coroutine) {
+			executor.Post(coroutine);
+		}
+		void await_resume() const noexcept {
+		}
+	};
+
+	/* ---------- CONSTRUCTION / DESTRUCTION ---------- */
+
+	// Constructor
+	// Creates an executor with nothing to run.
+	LocalExecutor() {
+		resumed = 0;
+	}
+
+	// coroutines hold on to their executor by address
+	LocalExecutor(const LocalExecutor&) = delete;
+	LocalExecutor& operator=(const LocalExecutor&) = delete;
+
+	// Destructor
+	// Destroys the coroutines that were scheduled but never got to run again.
+	~LocalExecutor() {
+		while (ready.NodeCount() > 0) {
+			coroutine_handle<> coroutine = ready.Head()->data;
+			ready.RemoveHead();
+			coroutine.destroy();
+		}
+	}
+
+
+	/* ---------- BEHAVIORS ---------- */
+
+	// Takes a Task and schedules its first run.
+	void Spawn(Task task) {
+		Post(task.Release());
+	}
+
+	// Schedules a suspended coroutine to be resumed.
+	void Post(coroutine_handle<> coroutine) {
+		ready.AddTail(coroutine);
+	}
+
+	// Resumes the next ready coroutine until it suspends or finishes.
+	// Returns false if none was ready.
+	bool RunOne() {
+		if (ready.NodeCount() == 0) {
+			return false;
+		}
+		coroutine_handle<> coroutine = ready.Head()->data;
+		ready.RemoveHead();
+		resumed++;
+		coroutine.resume();
+		return true;
+	}
+
+	// Resumes coroutines until none is ready, including those made ready along the way.
+	// Returns the number of resumptions.
+	unsigned long long Run() {
+		unsigned long long count = 0;
+		while (RunOne()) {
+			count++;
+		}
+		return count;
+	}
+
+	// Returns an awaitable that lets every other ready coroutine run before the caller continues.
+	YieldAwaiter Yield() {
+		return YieldAwaiter{ *this };
+	}
+
+
+	/* ---------- ACCESSORS ---------- */
+
+	// Returns the number of coroutines waiting to be resumed.
+	unsigned int Pending() const {
+		return ready.NodeCount();
+	}
+
+	// Returns the number of resumptions since the executor was created.
+	unsigned long long Resumed() const {
+		return resumed;
+	}
+};
+
+
+// A LinkedList<T, Storage> with the AddTail/PopHead vocabulary of a channel. Producers call
+// AddTail or AddNodesTail; consumer coroutines co_await PopHead for one element or PopNodesHead
+// for up to a batch. Waiters are served first come, first served, and each is handed its data
+// when it is woken, so no other consumer can take it before it runs; data that goes straight to a
+// waiter never becomes a Node. AddNodesTail is the batch wake: one call feeds and schedules as
+// many waiters as its data reaches, and PopNodesHead lets one resumption take many elements.
+// A Channel and its executor belong to one thread. Close it and Run the executor before
+// destroying it, so that waiting coroutines finish.
+template<typename T, typename Storage = Nodes>
+class Channel {
+
+	// a suspended consumer, stored in its coroutine frame by the awaitables below
+	struct Waiter {
+		coroutine_handle<> coroutine;	// resumed once the Waiter has data or the Channel closes
+		Waiter* next;					// next Waiter in line
+		optional<T>* single;			// where PopHead's element goes, or nullptr
+		vector<T>* batch;				// where PopNodesHead's elements go, or nullptr
+		unsigned int most;				// the largest batch PopNodesHead takes
+		unsigned int taken;				// elements handed to the Waiter
+	};
+
+	// data members of the Channel class
+	LinkedList<T, Storage> list;	// data no consumer has taken yet
+	LocalExecutor& executor;		// where woken consumers are resumed
+	Waiter* first;					// longest-waiting consumer; only set while list is empty
+	Waiter* last;					// most recent waiter
+	unsigned int waiting;			// number of Waiters
+	bool closed;					// set once no more data will be added
+
+
+	public:
+
+	// the awaitable returned by PopHead; co_await gives the element, or nullopt once the Channel
+	// is closed and empty
+	class PopHeadAwaiter {
+		Channel& channel;
+		Waiter waiter;
+		optional<T> value;
+
+		public:
+
+		explicit PopHeadAwaiter(Channel& owner) : channel(owner) {
+		}
+		bool await_ready() {
+			if (channel.list.NodeCount() > 0) {
+				value.emplace(channel.TakeHead());
+				return true;
+			}
+			return channel.closed;
+		}
+		void await_suspend(coroutine_handle<> coroutine) {
+			waiter = Waiter{ coroutine, nullptr, &value, nullptr, 1, 0 };
+			channel.Enqueue(&waiter);
+		}
+		optional<T> await_resume() {
+			return std::move(value);
+		}
+	};
+
+	// the awaitable returned by PopNodesHead; co_await gives the number of elements appended,
+	// 0 only once the Channel is closed and empty
+	class PopNodesAwaiter {
+		Channel& channel;
+		Waiter waiter;
+		vector<T>& outData;
+		unsigned int most;
+		unsigned int taken;
+
+		public:
+
+		PopNodesAwaiter(Channel& owner, vector<T>& out, unsigned int count) : channel(owner), outData(out) {
+			waiter.taken = 0;
+			most = count;
+			taken = 0;
+		}
+		bool await_ready() {
+			while (taken < most && channel.list.NodeCount() > 0) {
+				outData.push_back(channel.TakeHead());
+				taken++;
+			}
+			return taken > 0 || most == 0 || channel.closed;
+		}
+		void await_suspend(coroutine_handle<> coroutine) {
+			waiter = Waiter{ coroutine, nullptr, nullptr, &outData, most, 0 };
+			channel.Enqueue(&waiter);
+		}
+		unsigned int await_resume() {
+			return taken + waiter.taken;
+		}
+	};
+
+	/* ---------- CONSTRUCTION / DESTRUCTION ---------- */
+
+	// Constructor
+	// Creates an empty Channel whose consumers are resumed on executor.
+	explicit Channel(LocalExecutor& onExecutor) : executor(onExecutor) {
+		first = nullptr;
+		last = nullptr;
+		waiting = 0;
+		closed = false;
+	}
+
+	// waiters point back at the Channel
+	Channel(const Channel&) = delete;
+	Channel& operator=(const Channel&) = delete;
+
+
+	/* ---------- ACCESSORS ---------- */
+
+	// Returns the number of elements no consumer has taken yet.
+	unsigned int NodeCount() const {
+		return list.NodeCount();
+	}
+
+	// Returns the number of consumers suspended in PopHead or PopNodesHead.
+	unsigned int Waiting() const {
+		return waiting;
+	}
+
+	// Returns true once Close has been called.
+	bool IsClosed() const {
+		return closed;
+	}
+
+
+	/* ---------- INSERTION ---------- */
+
+	// Adds data at the tail, or hands it to the longest-waiting consumer and schedules it.
+	// Returns false if the Channel is closed.
+	bool AddTail(const T& data) {
+		if (closed) {
+			return false;
+		}
+		if (first != nullptr) {
+			Feed(&data, 1);
+		}
+		else {
+			list.AddTail(data);
+		}
+		return true;
+	}
+
+	// Wakes waiting consumers in order, each with its share of the array, until the data or the
+	// waiters run out, then adds what is left at the tail as one chain.
+	// Returns false if the Channel is closed.
+	bool AddNodesTail(const T* data, unsigned int count) {
+		if (closed) {
+			return false;
+		}
+		unsigned int given = Feed(data, count);
+		if (given < count) {
+			list.AddNodesTail(data + given, count - given);
+		}
+		return true;
+	}
+
+
+	/* ---------- REMOVAL ---------- */
+
+	// Returns an awaitable for the head; co_await suspends while the Channel is empty.
+	PopHeadAwaiter PopHead() {
+		return PopHeadAwaiter(*this);
+	}
+
+	// Returns an awaitable that appends up to count elements to outData; co_await suspends while
+	// the Channel is empty and then takes whatever has arrived, up to count.
+	PopNodesAwaiter PopNodesHead(vector<T>& outData, unsigned int count) {
+		return PopNodesAwaiter(*this, outData, count);
+	}
+
+	// Moves the head into outData without waiting.
+	// Returns false if the Channel is empty.
+	bool TryPopHead(T& outData) {
+		if (list.NodeCount() == 0) {
+			return false;
+		}
+		outData = TakeHead();
+		return true;
+	}
+
+	// Stops further additions and wakes every waiting consumer empty-handed.
+	// Data already added can still be taken.
+	void Close() {
+		closed = true;
+		while (first != nullptr) {
+			Wake(first);
+		}
+	}
+
+
+	private:
+
+	/* ---------- Helper Functions ---------- */
+
+	// Moves the head out of the list.
+	T TakeHead() {
+		T data = std::move(list.Head()->data);
+		list.RemoveHead();
+		return data;
+	}
+
+	// Hands elements of data to waiting consumers, first come first served, and schedules each.
+	// Waiters only exist while the list is empty, so this keeps the order the data was added in.
+	// Returns the number of elements handed out.
+	unsigned int Feed(const T* data, unsigned int count) {
+		unsigned int given = 0;
+		while (first != nullptr && given < count) {
+			Waiter* waiter = first;
+			if (waiter->single != nullptr) {
+				waiter->single->emplace(data[given++]);
+				waiter->taken = 1;
+			}
+			else {
+				while (waiter->taken < waiter->most && given < count) {
+					waiter->batch->push_back(data[given++]);
+					waiter->taken++;
+				}
+			}
+			Wake(waiter);
+		}
+		return given;
+	}
+
+	// Puts a suspended consumer at the end of the line.
+	void Enqueue(Waiter* waiter) {
+		if (last != nullptr) {
+			last->next = waiter;
+		}
+		else {
+			first = waiter;
+		}
+		last = waiter;
+		waiting++;
+	}
+
+	// Takes the first consumer out of the line and schedules it.
+	void Wake(Waiter* waiter) {
+		first = waiter->next;
+		if (first == nullptr) {
+			last = nullptr;
+		}
+		waiting--;
+		executor.Post(waiter->coroutine);
+	}
+};
+
+#endif
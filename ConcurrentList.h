@@ -0,0 +1,377 @@
+#ifndef CONCURRENTLIST_H
+#define CONCURRENTLIST_H
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// A doubly-linked list that many threads may edit at once, including in the middle.
+// Every Node has its own lock and locks are always taken from head toward tail, so edits
+// to disjoint regions proceed in parallel without deadlock. Index-based operations walk
+// hand-over-hand (lock the next Node before releasing the previous one). Node-based
+// operations lock optimistically and then validate that the neighbors are still adjacent
+// and not removed, as in the lazy list of Heller et al.
+//
+// Removed Nodes stay allocated (marked removed) until Reclaim or destruction, so a Node*
+// returned by Find or an insertion may always be passed back in safely.
+template<typename T>
+class ConcurrentList {
+
+	public:
+
+	// a small test-and-set lock; it is only held for a few pointer updates
+	class SpinLock {
+		atomic_flag flag = ATOMIC_FLAG_INIT;
+
+		public:
+
+		void lock() {
+			while (flag.test_and_set(memory_order_acquire)) {
+				this_thread::yield();
+			}
+		}
+
+		void unlock() {
+			flag.clear(memory_order_release);
+		}
+	};
+
+	// a class for the construction of Nodes
+	struct Node {
+
+		// data members of the Node class
+		SpinLock lock;				// guards the links of this Node
+		atomic<Node*> prev;			// pointer to the previous Node
+		atomic<Node*> next;			// pointer to the next Node
+		atomic<bool> removed;		// set, under lock, once the Node is unlinked
+		Node* retired;				// link in the list of removed Nodes awaiting Reclaim
+		T data;						// storage for the Node's data
+
+		Node() : prev(nullptr), next(nullptr), removed(false), retired(nullptr), data() {}
+	};
+
+	private:
+
+	// data members of the ConcurrentList class
+	Node first;						// sentinel before the head, never removed
+	Node last;						// sentinel after the tail, never removed
+	atomic<unsigned int> size;		// number of Nodes currently in the list
+	atomic<Node*> retiredNodes;		// removed Nodes not yet freed
+
+
+	public:
+
+	/* ---------- CONSTRUCTION / DESTRUCTION ---------- */
+
+	// Constructor
+	// Links the two sentinels together.
+	ConcurrentList() : size(0), retiredNodes(nullptr) {
+		first.next.store(&last, memory_order_relaxed);
+		last.prev.store(&first, memory_order_relaxed);
+	}
+
+	// the list is shared by address between threads, so it cannot be copied
+	ConcurrentList(const ConcurrentList&) = delete;
+	ConcurrentList& operator=(const ConcurrentList&) = delete;
+
+	// Destructor
+	// Deletes all Nodes, including removed ones. No thread may still be using the list.
+	~ConcurrentList() {
+		Node* current = first.next.load(memory_order_relaxed);
+		while (current != &last) {
+			Node* queued = current->next.load(memory_order_relaxed);
+			delete current;
+			current = queued;
+		}
+		Reclaim();
+	}
+
+
+	private:
+
+	/* ---------- Helper Functions ---------- */
+
+	// Creates a Node and links it between two locked, adjacent Nodes.
+	Node* Link(Node* before, Node* after, const T& data) {
+		Node* newNode = new Node();
+		newNode->data = data;
+		newNode->prev.store(before, memory_order_relaxed);
+		newNode->next.store(after, memory_order_relaxed);
+		before->next.store(newNode, memory_order_release);
+		after->prev.store(newNode, memory_order_release);
+		size.fetch_add(1, memory_order_relaxed);
+		return newNode;
+	}
+
+	// Unlinks a locked Node whose locked neighbors are before and after, and retires it.
+	void Unlink(Node* before, Node* node, Node* after) {
+		before->next.store(after, memory_order_release);
+		after->prev.store(before, memory_order_release);
+		node->removed.store(true, memory_order_release);
+		size.fetch_sub(1, memory_order_relaxed);
+
+		node->retired = retiredNodes.load(memory_order_relaxed);
+		while (!retiredNodes.compare_exchange_weak(node->retired, node, memory_order_release)) {}
+	}
+
+	// Locks a Node's predecessor and the Node itself, retrying until they are still adjacent.
+	// Returns the locked predecessor, or nullptr (with nothing locked) if the Node was removed.
+	Node* LockWithPrev(Node* node) {
+		while (true) {
+			if (node->removed.load(memory_order_acquire)) {
+				return nullptr;
+			}
+			Node* before = node->prev.load(memory_order_acquire);
+			before->lock.lock();
+			node->lock.lock();
+			if (node->removed.load(memory_order_relaxed)) {
+				node->lock.unlock();
+				before->lock.unlock();
+				return nullptr;
+			}
+			if (!before->removed.load(memory_order_relaxed)
+				&& before->next.load(memory_order_relaxed) == node) {
+				return before;
+			}
+			node->lock.unlock();
+			before->lock.unlock();
+		}
+	}
+
+	// Walks hand-over-hand until after is the Node at index and before is the one preceding it
+	// (before may be the head sentinel and after the tail sentinel). Returns with both locked,
+	// or false with nothing locked if the list is shorter than index.
+	bool LockPosition(unsigned int index, Node*& before, Node*& after) {
+		before = &first;
+		before->lock.lock();
+		after = before->next.load(memory_order_acquire);
+		after->lock.lock();
+		for (unsigned int i = 0; i < index; i++) {
+			if (after == &last) {
+				after->lock.unlock();
+				before->lock.unlock();
+				return false;
+			}
+			before->lock.unlock();
+			before = after;
+			after = after->next.load(memory_order_acquire);
+			after->lock.lock();
+		}
+		return true;
+	}
+
+
+	public:
+
+	/* ---------- ACCESSORS ---------- */
+
+	// Returns the number of Nodes in the list.
+	// Only a snapshot: other threads may change it before the caller looks at the result.
+	unsigned int NodeCount() const {
+		return size.load(memory_order_relaxed);
+	}
+
+	// Returns a pointer to the first Node with the specified data, or nullptr.
+	// Takes no locks: unlinked Nodes still point forward into the list, so the walk is always safe.
+	Node* Find(const T& data) {
+		Node* current = first.next.load(memory_order_acquire);
+		while (current != &last) {
+			if (current->data == data && !current->removed.load(memory_order_acquire)) {
+				return current;
+			}
+			current = current->next.load(memory_order_acquire);
+		}
+		return nullptr;
+	}
+
+	// Fills a vector with the data of every Node, walking hand-over-hand from head to tail.
+	void Snapshot(vector<T>& outData) const {
+		Node* before = const_cast<Node*>(&first);
+		before->lock.lock();
+		Node* current = before->next.load(memory_order_acquire);
+		while (current != &last) {
+			current->lock.lock();
+			before->lock.unlock();
+			outData.push_back(current->data);
+			before = current;
+			current = current->next.load(memory_order_acquire);
+		}
+		before->lock.unlock();
+	}
+
+	// Checks that every next link is mirrored by a prev link and that the count matches.
+	// Only meaningful while no other thread is editing the list.
+	bool Validate() const {
+		unsigned int count = 0;
+		const Node* current = &first;
+		while (current != &last) {
+			const Node* queued = current->next.load(memory_order_acquire);
+			if (queued == nullptr || queued->prev.load(memory_order_acquire) != current
+				|| queued->removed.load(memory_order_acquire)) {
+				return false;
+			}
+			if (queued != &last) {
+				count++;
+			}
+			current = queued;
+		}
+		return count == size.load(memory_order_relaxed);
+	}
+
+
+	/* ---------- INSERTION ---------- */
+
+	// Creates a new Node at the beginning of the list and returns it.
+	Node* AddHead(const T& data) {
+		Node* after;
+		Node* before;
+		LockPosition(0, before, after);
+		Node* newNode = Link(before, after, data);
+		after->lock.unlock();
+		before->lock.unlock();
+		return newNode;
+	}
+
+	// Creates a new Node at the end of the list and returns it.
+	Node* AddTail(const T& data) {
+		Node* before = LockWithPrev(&last);
+		Node* newNode = Link(before, &last, data);
+		last.lock.unlock();
+		before->lock.unlock();
+		return newNode;
+	}
+
+	// Inserts a new Node containing the specified data before the passed-in Node.
+	// Returns the new Node, or nullptr if the passed-in Node has been removed.
+	Node* InsertBefore(Node* node, const T& data) {
+		Node* before = LockWithPrev(node);
+		if (before == nullptr) {
+			return nullptr;
+		}
+		Node* newNode = Link(before, node, data);
+		node->lock.unlock();
+		before->lock.unlock();
+		return newNode;
+	}
+
+	// Inserts a new Node containing the specified data after the passed-in Node.
+	// Returns the new Node, or nullptr if the passed-in Node has been removed.
+	Node* InsertAfter(Node* node, const T& data) {
+		node->lock.lock();
+		if (node->removed.load(memory_order_relaxed)) {
+			node->lock.unlock();
+			return nullptr;
+		}
+		Node* after = node->next.load(memory_order_relaxed);
+		after->lock.lock();
+		Node* newNode = Link(node, after, data);
+		after->lock.unlock();
+		node->lock.unlock();
+		return newNode;
+	}
+
+	// Inserts a new Node containing the specified data at the specified index.
+	// Returns false if the index is past the end of the list when the walk reaches it.
+	bool InsertAt(const T& data, unsigned int index) {
+		Node* before;
+		Node* after;
+		if (!LockPosition(index, before, after)) {
+			return false;
+		}
+		Link(before, after, data);
+		after->lock.unlock();
+		before->lock.unlock();
+		return true;
+	}
+
+
+	/* ---------- REMOVAL ---------- */
+
+	// Removes the passed-in Node.
+	// Returns false if it had already been removed.
+	bool Remove(Node* node) {
+		Node* before = LockWithPrev(node);
+		if (before == nullptr) {
+			return false;
+		}
+		Node* after = node->next.load(memory_order_relaxed);
+		after->lock.lock();
+		Unlink(before, node, after);
+		after->lock.unlock();
+		node->lock.unlock();
+		before->lock.unlock();
+		return true;
+	}
+
+	// Removes all Nodes containing the specified data, walking hand-over-hand.
+	// Returns the number of Nodes removed.
+	unsigned int Remove(const T& data) {
+		unsigned int numRemoved = 0;
+		Node* before = &first;
+		before->lock.lock();
+		Node* current = before->next.load(memory_order_acquire);
+		current->lock.lock();
+		while (current != &last) {
+			Node* after = current->next.load(memory_order_acquire);
+			after->lock.lock();
+			if (current->data == data) {
+				Unlink(before, current, after);
+				current->lock.unlock();
+				numRemoved++;
+			}
+			else {
+				before->lock.unlock();
+				before = current;
+			}
+			current = after;
+		}
+		current->lock.unlock();
+		before->lock.unlock();
+		return numRemoved;
+	}
+
+	// Removes the Node at the specified index, copying its data to outData if given.
+	// Returns false if there is no Node at that index when the walk reaches it.
+	bool RemoveAt(unsigned int index, T* outData = nullptr) {
+		Node* before;
+		Node* node;
+		if (!LockPosition(index, before, node)) {
+			return false;
+		}
+		if (node == &last) {
+			node->lock.unlock();
+			before->lock.unlock();
+			return false;
+		}
+		Node* after = node->next.load(memory_order_relaxed);
+		after->lock.lock();
+		if (outData != nullptr) {
+			*outData = node->data;
+		}
+		Unlink(before, node, after);
+		after->lock.unlock();
+		node->lock.unlock();
+		before->lock.unlock();
+		return true;
+	}
+
+	// Removes every Node from the list, one at a time from the head.
+	void Clear() {
+		while (RemoveAt(0)) {}
+	}
+
+	// Frees every removed Node.
+	// The caller must ensure no other thread is using the list and no removed Node* is still held.
+	void Reclaim() {
+		Node* current = retiredNodes.exchange(nullptr, memory_order_acquire);
+		while (current != nullptr) {
+			Node* queued = current->retired;
+			delete current;
+			current = queued;
+		}
+	}
+};
+
+#endif
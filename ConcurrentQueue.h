@@ -0,0 +1,371 @@
+#ifndef CONCURRENTQUEUE_H
+#define CONCURRENTQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+using namespace std;
+
+// A bounded multi-producer, multi-consumer queue with the AddTail/RemoveHead vocabulary of LinkedList.
+// Producers and consumers claim cells of a fixed ring with atomic tickets (Dmitry Vyukov's bounded
+// MPMC design), so the common path takes no lock. Threads only sleep on a mutex and condition
+// variable when the queue is full or empty, which is also how backpressure reaches producers.
+template<typename T>
+class ConcurrentQueue {
+
+	private:
+
+	// a slot of the ring; sequence tells producers and consumers whose turn it is
+	struct Cell {
+		atomic<size_t> sequence;	// position the cell is ready for
+		T data;						// storage for the queued data
+	};
+
+	// keep the two tickets on separate cache lines so producers and consumers do not share one
+	struct alignas(64) Ticket {
+		atomic<size_t> position;
+	};
+
+	// data members of the ConcurrentQueue class
+	Cell* cells;						// ring of capacity cells
+	size_t mask;						// capacity - 1, capacity is a power of two
+	Ticket tail;						// next position to add at
+	Ticket head;						// next position to remove from
+	atomic<bool> closed;				// set once no more data will be added
+
+	// data members used only by threads that have to block
+	mutex sleepLock;					// guards sleeping on the condition variables
+	condition_variable notEmpty;		// signalled when data is added
+	condition_variable notFull;			// signalled when data is removed
+	atomic<unsigned int> waitingConsumers;
+	atomic<unsigned int> waitingProducers;
+
+	static const unsigned int spins = 64;	// attempts before a blocking call goes to sleep
+
+
+	public:
+
+	/* ---------- CONSTRUCTION / DESTRUCTION ---------- */
+
+	// Constructor
+	// Creates an empty queue holding at most capacity elements (rounded up to a power of two).
+	explicit ConcurrentQueue(unsigned int capacity = 1024) {
+		size_t cellCount = 2;
+		while (cellCount < capacity) {
+			cellCount *= 2;
+		}
+		cells = new Cell[cellCount];
+		for (size_t i = 0; i < cellCount; i++) {
+			cells[i].sequence.store(i, memory_order_relaxed);
+		}
+		mask = cellCount - 1;
+		tail.position.store(0, memory_order_relaxed);
+		head.position.store(0, memory_order_relaxed);
+		closed.store(false, memory_order_relaxed);
+		waitingConsumers.store(0, memory_order_relaxed);
+		waitingProducers.store(0, memory_order_relaxed);
+	}
+
+	// the queue is shared by address between threads, so it cannot be copied
+	ConcurrentQueue(const ConcurrentQueue&) = delete;
+	ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+	// Destructor
+	// No thread may still be using the queue.
+	~ConcurrentQueue() {
+		delete[] cells;
+	}
+
+
+	/* ---------- ACCESSORS ---------- */
+
+	// Returns the number of elements the queue can hold.
+	unsigned int Capacity() const {
+		return (unsigned int)(mask + 1);
+	}
+
+	// Returns the number of queued elements.
+	// Only a snapshot: other threads may change it before the caller looks at the result.
+	unsigned int NodeCount() const {
+		size_t added = tail.position.load(memory_order_acquire);
+		size_t removed = head.position.load(memory_order_acquire);
+		return added > removed ? (unsigned int)(added - removed) : 0;
+	}
+
+	// Returns true once Close has been called.
+	bool IsClosed() const {
+		return closed.load(memory_order_acquire);
+	}
+
+
+	/* ---------- INSERTION ---------- */
+
+	// Adds data at the tail if there is room.
+	// Returns false if the queue is full or closed.
+	bool TryAddTail(const T& data) {
+		if (closed.load(memory_order_relaxed) || !Push(data)) {
+			return false;
+		}
+		WakeConsumers(1);
+		return true;
+	}
+
+	// Adds data at the tail, waiting for room while the queue is full.
+	// Returns false if the queue is closed.
+	bool AddTail(const T& data) {
+		return AddTailUntil(data, nullptr);
+	}
+
+	// Adds data at the tail, waiting at most timeout for room.
+	// Returns false if the time runs out or the queue is closed.
+	template<typename Rep, typename Period>
+	bool AddTail(const T& data, chrono::duration<Rep, Period> timeout) {
+		chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + timeout;
+		return AddTailUntil(data, &deadline);
+	}
+
+	// Adds an array of data at the tail, waiting for room as needed, and wakes consumers once.
+	// Returns the number of elements added, which is less than count only if the queue is closed.
+	unsigned int AddNodesTail(const T* data, unsigned int count) {
+		unsigned int added = TryAddNodesTail(data, count);
+		while (added < count && AddTail(data[added])) {
+			added++;
+			added += TryAddNodesTail(data + added, count - added);
+		}
+		return added;
+	}
+
+	// Adds as many elements of the array as fit without waiting and wakes consumers once.
+	// Returns the number of elements added.
+	unsigned int TryAddNodesTail(const T* data, unsigned int count) {
+		unsigned int added = 0;
+		if (!closed.load(memory_order_relaxed)) {
+			while (added < count && Push(data[added])) {
+				added++;
+			}
+		}
+		WakeConsumers(added);
+		return added;
+	}
+
+
+	/* ---------- REMOVAL ---------- */
+
+	// Moves the head into outData if the queue is not empty.
+	// Returns false if the queue is empty.
+	bool TryRemoveHead(T& outData) {
+		if (!Pop(outData)) {
+			return false;
+		}
+		WakeProducers(1);
+		return true;
+	}
+
+	// Moves the head into outData, waiting while the queue is empty.
+	// Returns false only once the queue is closed and drained.
+	bool RemoveHead(T& outData) {
+		return RemoveHeadUntil(outData, nullptr);
+	}
+
+	// Moves the head into outData, waiting at most timeout for data.
+	// Returns false if the time runs out or the queue is closed and drained.
+	template<typename Rep, typename Period>
+	bool RemoveHead(T& outData, chrono::duration<Rep, Period> timeout) {
+		chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + timeout;
+		return RemoveHeadUntil(outData, &deadline);
+	}
+
+	// Waits for at least one element, then moves up to count elements into outData.
+	// Wakes producers once. Returns 0 only once the queue is closed and drained.
+	unsigned int RemoveNodesHead(T* outData, unsigned int count) {
+		if (count == 0 || !RemoveHead(outData[0])) {
+			return 0;
+		}
+		return 1 + TryRemoveNodesHead(outData + 1, count - 1);
+	}
+
+	// Moves up to count elements into outData without waiting and wakes producers once.
+	// Returns the number of elements removed.
+	unsigned int TryRemoveNodesHead(T* outData, unsigned int count) {
+		unsigned int removed = 0;
+		while (removed < count && Pop(outData[removed])) {
+			removed++;
+		}
+		WakeProducers(removed);
+		return removed;
+	}
+
+	// Stops further additions and wakes every waiting thread.
+	// Consumers can still remove whatever is left.
+	void Close() {
+		lock_guard<mutex> guard(sleepLock);
+		closed.store(true, memory_order_seq_cst);
+		notEmpty.notify_all();
+		notFull.notify_all();
+	}
+
+
+	private:
+
+	/* ---------- Helper Functions ---------- */
+
+	// Claims the next free cell and stores data in it. Returns false if the queue is full.
+	bool Push(const T& data) {
+		size_t position = tail.position.load(memory_order_relaxed);
+		while (true) {
+			Cell& cell = cells[position & mask];
+			size_t sequence = cell.sequence.load(memory_order_acquire);
+			ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)position;
+			if (difference == 0) {
+				if (tail.position.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+					cell.data = data;
+					cell.sequence.store(position + 1, memory_order_release);
+					return true;
+				}
+			}
+			else if (difference < 0) {
+				return false;
+			}
+			else {
+				position = tail.position.load(memory_order_relaxed);
+			}
+		}
+	}
+
+	// Claims the next full cell and moves its data out. Returns false if the queue is empty.
+	bool Pop(T& outData) {
+		size_t position = head.position.load(memory_order_relaxed);
+		while (true) {
+			Cell& cell = cells[position & mask];
+			size_t sequence = cell.sequence.load(memory_order_acquire);
+			ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)(position + 1);
+			if (difference == 0) {
+				if (head.position.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+					outData = std::move(cell.data);
+					cell.sequence.store(position + mask + 1, memory_order_release);
+					return true;
+				}
+			}
+			else if (difference < 0) {
+				return false;
+			}
+			else {
+				position = head.position.load(memory_order_relaxed);
+			}
+		}
+	}
+
+	// Wakes consumers sleeping on an empty queue after count elements were added.
+	// The fence pairs with the one in RemoveHeadUntil so an added element and a sleeper
+	// cannot miss each other.
+	void WakeConsumers(unsigned int count) {
+		atomic_thread_fence(memory_order_seq_cst);
+		if (count > 0 && waitingConsumers.load(memory_order_relaxed) > 0) {
+			lock_guard<mutex> guard(sleepLock);
+			if (count == 1) {
+				notEmpty.notify_one();
+			}
+			else {
+				notEmpty.notify_all();
+			}
+		}
+	}
+
+	// Wakes producers sleeping on a full queue after count elements were removed.
+	void WakeProducers(unsigned int count) {
+		atomic_thread_fence(memory_order_seq_cst);
+		if (count > 0 && waitingProducers.load(memory_order_relaxed) > 0) {
+			lock_guard<mutex> guard(sleepLock);
+			if (count == 1) {
+				notFull.notify_one();
+			}
+			else {
+				notFull.notify_all();
+			}
+		}
+	}
+
+	// Adds data, spinning briefly and then sleeping until there is room or the deadline passes.
+	bool AddTailUntil(const T& data, const chrono::steady_clock::time_point* deadline) {
+		for (unsigned int i = 0; i < spins; i++) {
+			if (TryAddTail(data)) {
+				return true;
+			}
+			if (closed.load(memory_order_relaxed)) {
+				return false;
+			}
+			this_thread::yield();
+		}
+
+		unique_lock<mutex> sleeper(sleepLock);
+		waitingProducers.fetch_add(1, memory_order_relaxed);
+		atomic_thread_fence(memory_order_seq_cst);
+		bool added = false;
+		while (!closed.load(memory_order_relaxed)) {
+			if (Push(data)) {
+				added = true;
+				break;
+			}
+			if (deadline == nullptr) {
+				notFull.wait(sleeper);
+			}
+			else if (notFull.wait_until(sleeper, *deadline) == cv_status::timeout) {
+				added = Push(data);
+				break;
+			}
+		}
+		waitingProducers.fetch_sub(1, memory_order_relaxed);
+		sleeper.unlock();
+
+		if (added) {
+			WakeConsumers(1);
+		}
+		return added;
+	}
+
+	// Removes the head, spinning briefly and then sleeping until data arrives or the deadline passes.
+	bool RemoveHeadUntil(T& outData, const chrono::steady_clock::time_point* deadline) {
+		for (unsigned int i = 0; i < spins; i++) {
+			if (TryRemoveHead(outData)) {
+				return true;
+			}
+			if (closed.load(memory_order_acquire) && NodeCount() == 0) {
+				return TryRemoveHead(outData);
+			}
+			this_thread::yield();
+		}
+
+		unique_lock<mutex> sleeper(sleepLock);
+		waitingConsumers.fetch_add(1, memory_order_relaxed);
+		atomic_thread_fence(memory_order_seq_cst);
+		bool removed = false;
+		while (true) {
+			if (Pop(outData)) {
+				removed = true;
+				break;
+			}
+			if (closed.load(memory_order_relaxed)) {
+				break;
+			}
+			if (deadline == nullptr) {
+				notEmpty.wait(sleeper);
+			}
+			else if (notEmpty.wait_until(sleeper, *deadline) == cv_status::timeout) {
+				removed = Pop(outData);
+				break;
+			}
+		}
+		waitingConsumers.fetch_sub(1, memory_order_relaxed);
+		sleeper.unlock();
+
+		if (removed) {
+			WakeProducers(1);
+		}
+		return removed;
+	}
+};
+
+#endif
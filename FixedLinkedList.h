@@ -0,0 +1,436 @@
+#ifndef FIXEDLINKEDLIST_H
+#define FIXEDLINKEDLIST_H
+
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+// A LinkedList of at most N elements that never allocates: its Nodes live in an array inside the
+// object, linked by indices as small as N allows (1 byte up to 254 elements), and removed Nodes
+// go on a free list for reuse. A short list therefore fits in a few cache lines and can sit on the
+// stack or inside another object. Everything but printing and FindAll is constexpr, so for a
+// literal T a list can be built and searched at compile time.
+// The interface follows LinkedList; since links are indices, a Node is walked with Next and Prev
+// instead of node->next and node->prev. Adding to a full list throws length_error.
+template<typename T, unsigned int N>
+class FixedLinkedList {
+
+	static_assert(N > 0 && N < 0xFFFFFFFFu,
+		"FixedLinkedList needs a capacity of at least one element and below 0xFFFFFFFF, which means none");
+
+	public:
+
+	// the smallest unsigned type that can index every Node and still has a value left for "none"
+	typedef typename conditional<(N < 0xFFu), unsigned char,
+		typename conditional<(N < 0xFFFFu), unsigned short, unsigned int>::type>::type Index;
+
+	// a Node in the inline array
+	struct Node {
+
+		// data members of the Node class
+		Index prev;		// index of the previous Node, or none
+		Index next;		// index of the next Node, or none (also links the free list)
+		T data;			// storage for the Node's data
+	};
+
+	private:
+
+	static constexpr Index none = numeric_limits<Index>::max();
+
+	// data members of the FixedLinkedList class
+	Node nodes[N] = {};			// every Node, in use or not
+	Index head = none;			// index of the head
+	Index tail = none;			// index of the tail
+	Index freeNodes = none;		// first released Node, reused before untouched ones
+	Index untouched = 0;		// Nodes from here on have never been used
+	unsigned int size = 0;		// number of Nodes currently in the list
+
+
+	public:
+
+	/* ---------- CONSTRUCTION ---------- */
+	// the defaults copy the whole array, which is all the state there is, so there are no big 5
+
+	// Constructor
+	// Creates an empty list.
+	constexpr FixedLinkedList() {
+	}
+
+
+	/* ---------- OPERATORS ---------- */
+
+	// Returns the data from the Node at the specified index.
+	// Throws an out_of_range error if no such Node exists.
+	constexpr T& operator[](unsigned int index) {
+		return GetNode(index)->data;
+	}
+
+	// Returns a constant version of the data from the Node at the specified index.
+	// Throws an out_of_range error if no such Node exists.
+	constexpr const T& operator[](unsigned int index) const {
+		return GetNode(index)->data;
+	}
+
+	// Determines whether two lists hold the same data in the same order.
+	constexpr bool operator==(const FixedLinkedList& rhs) const {
+		if (size != rhs.size) {
+			return false;
+		}
+		for (Index left = head, right = rhs.head; left != none; left = nodes[left].next, right = rhs.nodes[right].next) {
+			if (nodes[left].data != rhs.nodes[right].data) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	private:
+
+	/* ---------- Helper Functions ---------- */
+
+	// Returns the index of a Node of this list.
+	constexpr Index IndexOf(const Node* node) const {
+		return (Index)(node - nodes);
+	}
+
+	// Returns the Node at an index, or nullptr for none.
+	constexpr Node* At(Index index) {
+		return index != none ? &nodes[index] : nullptr;
+	}
+
+	constexpr const Node* At(Index index) const {
+		return index != none ? &nodes[index] : nullptr;
+	}
+
+	// Takes an unused Node, from the free list first, and stores data in it.
+	// Throws length_error if all N are in use.
+	constexpr Index NewNode(const T& data) {
+		Index index = freeNodes;
+		if (index != none) {
+			freeNodes = nodes[index].next;
+		}
+		else if (untouched < N) {
+			index = untouched++;
+		}
+		else {
+			throw length_error("");
+		}
+		nodes[index].data = data;
+		return index;
+	}
+
+	// Links an unused Node in between prev and next, either of which may be none.
+	constexpr void Link(Index index, Index prev, Index next) {
+		nodes[index].prev = prev;
+		nodes[index].next = next;
+		if (prev != none) {
+			nodes[prev].next = index;
+		}
+		else {
+			head = index;
+		}
+		if (next != none) {
+			nodes[next].prev = index;
+		}
+		else {
+			tail = index;
+		}
+		size++;
+	}
+
+	// Detaches a Node and puts it on the free list. Data that owns resources is reset so that
+	// they are released now rather than when the Node is reused.
+	constexpr void Release(Index index) {
+		Node& node = nodes[index];
+		if (node.prev != none) {
+			nodes[node.prev].next = node.next;
+		}
+		else {
+			head = node.next;
+		}
+		if (node.next != none) {
+			nodes[node.next].prev = node.prev;
+		}
+		else {
+			tail = node.prev;
+		}
+		if (!is_trivially_destructible<T>::value) {
+			node.data = T();
+		}
+		node.next = freeNodes;
+		freeNodes = index;
+		size--;
+	}
+
+	// Returns the index of the Node at the specified position, which must exist.
+	// InsertAt and RemoveAt walk to the Node before the one they change and take the last hop
+	// themselves: that link was usually written by the previous call, and a load in this loop that
+	// often reads a just-stored link makes the CPU hold every later load of the loop behind stores,
+	// which costs several times the walk.
+	constexpr Index Walk(unsigned int position) const {
+		Index index = head;
+		for (unsigned int i = 0; i < position; i++) {
+			index = nodes[index].next;
+		}
+		return index;
+	}
+
+
+	public:
+
+	/* ---------- BEHAVIORS ---------- */
+
+	// Prints all Nodes in the list from beginning to end.
+	void PrintForward() const {
+		for (Index index = head; index != none; index = nodes[index].next) {
+			cout << nodes[index].data << endl;
+		}
+	}
+
+	// Prints all Nodes in the list from end to beginning.
+	void PrintReverse() const {
+		for (Index index = tail; index != none; index = nodes[index].prev) {
+			cout << nodes[index].data << endl;
+		}
+	}
+
+
+	/* ---------- ACCESSORS ---------- */
+
+	// Returns the number of Nodes in the list.
+	constexpr unsigned int NodeCount() const {
+		return size;
+	}
+
+	// Returns the most Nodes the list can hold.
+	static constexpr unsigned int Capacity() {
+		return N;
+	}
+
+	// Returns true if no more Nodes can be added.
+	constexpr bool Full() const {
+		return size == N;
+	}
+
+	// Returns a pointer to the first Node with the specified data, or nullptr.
+	constexpr Node* Find(const T& data) {
+		return const_cast<Node*>(static_cast<const FixedLinkedList*>(this)->Find(data));
+	}
+
+	// Returns a constant pointer to the first Node with the specified data, or nullptr.
+	constexpr const Node* Find(const T& data) const {
+		for (Index index = head; index != none; index = nodes[index].next) {
+			if (nodes[index].data == data) {
+				return &nodes[index];
+			}
+		}
+		return nullptr;
+	}
+
+	// Fills a vector with pointers to every Node containing the specified value, head first.
+	void FindAll(vector<Node*>& outData, const T& value) {
+		for (Index index = head; index != none; index = nodes[index].next) {
+			if (nodes[index].data == value) {
+				outData.push_back(&nodes[index]);
+			}
+		}
+	}
+
+	// Returns a pointer to the Node at the specified index.
+	// Throws an out_of_range error if no such Node exists.
+	constexpr Node* GetNode(unsigned int index) {
+		if (index >= size) {
+			throw out_of_range("");
+		}
+		return &nodes[Walk(index)];
+	}
+
+	// Returns a constant pointer to the Node at the specified index.
+	// Throws an out_of_range error if no such Node exists.
+	constexpr const Node* GetNode(unsigned int index) const {
+		if (index >= size) {
+			throw out_of_range("");
+		}
+		return &nodes[Walk(index)];
+	}
+
+	// Returns a pointer to the head of the list, or nullptr if it is empty.
+	constexpr Node* Head() {
+		return At(head);
+	}
+
+	constexpr const Node* Head() const {
+		return At(head);
+	}
+
+	// Returns a pointer to the tail of the list, or nullptr if it is empty.
+	constexpr Node* Tail() {
+		return At(tail);
+	}
+
+	constexpr const Node* Tail() const {
+		return At(tail);
+	}
+
+	// Returns the Node after the specified one, or nullptr at the tail.
+	constexpr Node* Next(const Node* node) {
+		return At(node->next);
+	}
+
+	constexpr const Node* Next(const Node* node) const {
+		return At(node->next);
+	}
+
+	// Returns the Node before the specified one, or nullptr at the head.
+	constexpr Node* Prev(const Node* node) {
+		return At(node->prev);
+	}
+
+	constexpr const Node* Prev(const Node* node) const {
+		return At(node->prev);
+	}
+
+
+	/* ---------- INSERTION ---------- */
+
+	// Adds a new Node at the beginning of the list.
+	// Throws length_error if the list is full.
+	constexpr void AddHead(const T& data) {
+		Link(NewNode(data), none, head);
+	}
+
+	// Adds a new Node at the end of the list.
+	// Throws length_error if the list is full.
+	constexpr void AddTail(const T& data) {
+		Link(NewNode(data), tail, none);
+	}
+
+	// Adds an array of data to the head of the list, keeping its order.
+	// Throws length_error, before adding anything, if it does not fit.
+	constexpr void AddNodesHead(const T* data, unsigned int count) {
+		if (count > N - size) {
+			throw length_error("");
+		}
+		for (unsigned int i = count; i > 0; i--) {
+			AddHead(data[i-1]);
+		}
+	}
+
+	// Adds an array of data to the tail of the list.
+	// Throws length_error, before adding anything, if it does not fit.
+	constexpr void AddNodesTail(const T* data, unsigned int count) {
+		if (count > N - size) {
+			throw length_error("");
+		}
+		for (unsigned int i = 0; i < count; i++) {
+			AddTail(data[i]);
+		}
+	}
+
+	// Inserts a new Node containing the specified data before the passed-in Node.
+	// Throws length_error if the list is full.
+	constexpr void InsertBefore(Node* node, const T& data) {
+		Link(NewNode(data), node->prev, IndexOf(node));
+	}
+
+	// Inserts a new Node containing the specified data after the passed-in Node.
+	// Throws length_error if the list is full.
+	constexpr void InsertAfter(Node* node, const T& data) {
+		Link(NewNode(data), IndexOf(node), node->next);
+	}
+
+	// Inserts a new Node containing the specified data at the specified index.
+	// Throws an out_of_range exception if passed-in index is not valid, length_error if the list is full.
+	constexpr void InsertAt(const T& data, unsigned int index) {
+		if (index > size) {
+			throw out_of_range("");
+		}
+		if (index == 0) {
+			AddHead(data);
+		}
+		else if (index == size) {
+			AddTail(data);
+		}
+		else {
+			Index prev = Walk(index - 1);
+			Link(NewNode(data), prev, nodes[prev].next);
+		}
+	}
+
+
+	/* ---------- REMOVAL ---------- */
+
+	// Removes the first Node in the list.
+	// Returns true if removal is successful and false if the list is empty.
+	constexpr bool RemoveHead() {
+		if (head == none) {
+			return false;
+		}
+		Release(head);
+		return true;
+	}
+
+	// Removes the last Node in the list.
+	// Returns true if removal is successful and false if the list is empty.
+	constexpr bool RemoveTail() {
+		if (tail == none) {
+			return false;
+		}
+		Release(tail);
+		return true;
+	}
+
+	// Removes all Nodes containing the specified data.
+	// Returns the number of Nodes removed.
+	constexpr unsigned int Remove(const T& data) {
+		unsigned int numRemoved = 0;
+		Index index = head;
+		while (index != none) {
+			Index next = nodes[index].next;
+			if (nodes[index].data == data) {
+				Release(index);
+				numRemoved++;
+			}
+			index = next;
+		}
+		return numRemoved;
+	}
+
+	// Removes the Node at the specified index.
+	// Returns true if removal is successful and false if there is no such Node.
+	constexpr bool RemoveAt(unsigned int index) {
+		if (index >= size) {
+			return false;
+		}
+		if (index == 0) {
+			Release(head);
+		}
+		else if (index == size - 1) {
+			Release(tail);
+		}
+		else {
+			Release(nodes[Walk(index - 1)].next);
+		}
+		return true;
+	}
+
+	// Removes all Nodes. Only data that owns resources needs its Nodes visited.
+	constexpr void Clear() {
+		if (!is_trivially_destructible<T>::value) {
+			for (Index index = head; index != none; index = nodes[index].next) {
+				nodes[index].data = T();
+			}
+		}
+		head = none;
+		tail = none;
+		freeNodes = none;
+		untouched = 0;
+		size = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef HUGEPAGES_H
+#define HUGEPAGES_H
+
+#include <cstddef>
+#include <cstdio>
+#include <linux/mempolicy.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "LinkedList.h"
+using namespace std;
+
+// A block source for a NodePool (see NodePool.h) that backs the blocks of Nodes with huge pages,
+// placed on chosen NUMA nodes, and the allocator of LinkedLists with HugePages storage. Include
+// this header to use LinkedList<T, HugePages>; it needs Linux.
+
+// Where the pages of a block are placed on a machine with several NUMA nodes.
+struct NumaPlacement {
+	enum Policy {
+		Default,		// wherever the kernel puts them, usually the node of the first thread to touch them
+		Bind,			// only on the given node
+		Interleave		// spread page by page over every node with memory
+	};
+
+	Policy policy;
+	int node;			// the node for Bind
+
+	static NumaPlacement OnNode(int numaNode) {
+		NumaPlacement placement = { Bind, numaNode };
+		return placement;
+	}
+
+	static NumaPlacement Interleaved() {
+		NumaPlacement placement = { Interleave, 0 };
+		return placement;
+	}
+};
+
+// Blocks made of whole 2 MB pages, so a long traversal needs one dTLB entry per 2 MB instead of
+// one per 4 KB. A block comes from the reserved huge page pool (MAP_HUGETLB) when the system has
+// one; otherwise it is an ordinary mapping aligned to 2 MB and marked MADV_HUGEPAGE, which the
+// kernel backs with transparent huge pages when they are enabled and with 4 KB pages when not, so
+// the source works on any Linux machine. Blocks can also be bound to a NUMA node or interleaved;
+// if the kernel refuses (no NUMA support, no such node) the pages stay where they would have been.
+// Blocks are at least 2 MB, so this only pays off for lists of many thousands of Nodes.
+class HugePageBlocks {
+
+	// data members of the HugePageBlocks class
+	NumaPlacement placement;	// where new blocks are placed
+	size_t hugeBlocks;			// blocks from the huge page pool
+	size_t advisedBlocks;		// blocks left to transparent huge pages
+	size_t placedBlocks;		// blocks the kernel accepted the NUMA placement for
+
+
+	public:
+
+	static const size_t pageBytes = 2 << 20;
+
+	/* ---------- CONSTRUCTION ---------- */
+
+	// Constructor
+	// Places blocks by the kernel's default policy until SetPlacement says otherwise.
+	HugePageBlocks() {
+		placement.policy = NumaPlacement::Default;
+		placement.node = 0;
+		hugeBlocks = 0;
+		advisedBlocks = 0;
+		placedBlocks = 0;
+	}
+
+
+	/* ---------- BEHAVIORS ---------- */
+
+	// Returns a 2 MB aligned block of at least bytes; bytes is rounded up to whole huge pages.
+	// Throws bad_alloc if no memory can be mapped at all.
+	void* AllocateBlock(size_t& bytes) {
+		bytes = (bytes + pageBytes - 1) & ~(pageBytes - 1);
+		void* block = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (block != MAP_FAILED) {
+			hugeBlocks++;
+		}
+		else {
+			block = MapAligned(bytes);
+			madvise(block, bytes, MADV_HUGEPAGE);
+			advisedBlocks++;
+		}
+		if (placement.policy != NumaPlacement::Default && Place(block, bytes)) {
+			placedBlocks++;
+		}
+		return block;
+	}
+
+	// Unmaps a block returned by AllocateBlock.
+	void ReleaseBlock(void* block, size_t bytes) {
+		munmap(block, bytes);
+	}
+
+	// Sets where blocks allocated from now on are placed.
+	void SetPlacement(NumaPlacement numaPlacement) {
+		placement = numaPlacement;
+	}
+
+
+	/* ---------- ACCESSORS ---------- */
+
+	// Returns where new blocks are placed.
+	NumaPlacement GetPlacement() const {
+		return placement;
+	}
+
+	// Returns the number of blocks taken from the reserved huge page pool.
+	size_t HugeBlocks() const {
+		return hugeBlocks;
+	}
+
+	// Returns the number of blocks left to transparent huge pages.
+	size_t AdvisedBlocks() const {
+		return advisedBlocks;
+	}
+
+	// Returns the number of blocks the NUMA placement was applied to.
+	size_t PlacedBlocks() const {
+		return placedBlocks;
+	}
+
+
+	private:
+
+	/* ---------- Helper Functions ---------- */
+
+	// Maps bytes of ordinary memory starting on a 2 MB boundary, so the kernel can use huge pages.
+	static void* MapAligned(size_t bytes) {
+		void* mapped = mmap(nullptr, bytes + pageBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mapped == MAP_FAILED) {
+			throw bad_alloc();
+		}
+		char* start = static_cast<char*>(mapped);
+		char* aligned = reinterpret_cast<char*>(((size_t)start + pageBytes - 1) & ~(pageBytes - 1));
+		if (aligned > start) {
+			munmap(start, aligned - start);
+		}
+		size_t after = (start + bytes + pageBytes) - (aligned + bytes);
+		if (after > 0) {
+			munmap(aligned + bytes, after);
+		}
+		return aligned;
+	}
+
+	// Applies the NUMA placement to a block before its pages are touched.
+	// Returns false if the kernel refused it.
+	bool Place(void* block, size_t bytes) const {
+		unsigned long mask = 0;
+		int mode = MPOL_BIND;
+		if (placement.policy == NumaPlacement::Bind) {
+			if (placement.node < 0 || placement.node >= (int)(8 * sizeof(mask))) {
+				return false;
+			}
+			mask = 1ul << placement.node;
+		}
+		else {
+			mode = MPOL_INTERLEAVE;
+			mask = MemoryNodes();
+		}
+		return syscall(SYS_mbind, block, bytes, mode, &mask, 8 * sizeof(mask), 0) == 0;
+	}
+
+	// Returns a mask of the NUMA nodes that have memory, read from sysfs as e.g. "0-1" or "0,2".
+	// A machine without NUMA support has only node 0.
+	static unsigned long MemoryNodes() {
+		unsigned long mask = 0;
+		FILE* file = fopen("/sys/devices/system/node/has_memory", "r");
+		if (file != nullptr) {
+			int first, last;
+			char separator;
+			while (fscanf(file, "%d", &first) == 1) {
+				last = first;
+				separator = (char)fgetc(file);
+				if (separator == '-' && fscanf(file, "%d", &last) == 1) {
+					separator = (char)fgetc(file);
+				}
+				for (int node = first; node <= last && node < (int)(8 * sizeof(mask)); node++) {
+					mask |= 1ul << node;
+				}
+				if (separator != ',') {
+					break;
+				}
+			}
+			fclose(file);
+		}
+		return mask != 0 ? mask : 1;
+	}
+};
+
+// LinkedList<T, HugePages> takes its Nodes from a NodePool of huge page blocks.
+template<typename Node>
+struct StorageAllocator<HugePages, Node> {
+	typedef NodePool<Node, HugePageBlocks> type;
+};
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "LinkedList.h"
+#include "StringArena.h"
+using namespace std;
+
+// Streaming loaders that split text into tokens and append them to a LinkedList, reading input
+// in large blocks and finding delimiters with memchr instead of extracting a token at a time.
+// Tokens follow getline(in, token, delimiter): consecutive delimiters give empty tokens, and a
+// delimiter at the very end does not start another one.
+//	LinkedList<string>		each token is moved into its Node
+//	LinkedList<string_view>	each token's characters stay in a StringArena the caller owns:
+//							a regular file is mapped by the arena and the views point into
+//							it; other input is read straight into the arena's blocks
+// The loaders return false if the input cannot be read; tokens read before the error stay in
+// the list. They need a POSIX system.
+
+const size_t ingestBlockBytes = 1 << 20;	// bytes read at a time
+
+// Calls emit(token, length) for every token in [begin, end) that is followed by a delimiter.
+// Returns the start of the last, unterminated token.
+template<typename Emit>
+const char* SplitTokens(const char* begin, const char* end, char delimiter, Emit& emit) {
+	const char* start = begin;
+	const char* found;
+	if (begin == end) {
+		return begin;
+	}
+	while ((found = static_cast<const char*>(memchr(start, delimiter, end - start))) != nullptr) {
+		emit(start, (size_t)(found - start));
+		start = found + 1;
+	}
+	return start;
+}
+
+// Reads up to bytes from fd, retrying when interrupted. Returns 0 at the end, -1 on error.
+inline ssize_t ReadBlock(int fd, char* buffer, size_t bytes) {
+	ssize_t got;
+	do {
+		got = read(fd, buffer, bytes);
+	} while (got < 0 && errno == EINTR);
+	return got;
+}
+
+
+/* ---------- FROM A FILE DESCRIPTOR ---------- */
+
+// Reads fd to the end, appending every token to list as a string.
+template<typename Stats>
+bool IngestTokens(int fd, LinkedList<string, Nodes, Stats>& list, char delimiter = '\n') {
+	auto emit = [&list](const char* token, size_t length) {
+		list.AddTail(string(token, length));
+	};
+	vector<char> buffer(ingestBlockBytes);
+	size_t carry = 0;		// bytes of an unterminated token at the front of buffer
+	for (;;) {
+		if (buffer.size() - carry < ingestBlockBytes / 2) {
+			buffer.resize(buffer.size() * 2);
+		}
+		ssize_t got = ReadBlock(fd, buffer.data() + carry, buffer.size() - carry);
+		if (got < 0) {
+			return false;
+		}
+		if (got == 0) {
+			if (carry > 0) {
+				emit(buffer.data(), carry);
+			}
+			return true;
+		}
+		const char* end = buffer.data() + carry + got;
+		const char* rest = SplitTokens(buffer.data(), end, delimiter, emit);
+		carry = (size_t)(end - rest);
+		memmove(buffer.data(), rest, carry);
+	}
+}
+
+// Reads fd to the end into arena, appending a view of every token to list.
+template<typename Stats>
+bool IngestTokens(int fd, LinkedList<string_view, Nodes, Stats>& list, StringArena& arena, char delimiter = '\n') {
+	auto emit = [&list](const char* token, size_t length) {
+		list.AddTail(string_view(token, length));
+	};
+	char* space = nullptr;	// the unterminated token, followed by room to read into
+	size_t room = 0;		// bytes reserved at space
+	size_t carry = 0;		// bytes of the token read so far
+	for (;;) {
+		if (room - carry < ingestBlockBytes / 2) {
+			// reserving more after the token, doubling for a long one so it is copied only a few
+			// times, and moving it unless the arena had the room in place
+			room = max(2 * carry, carry + ingestBlockBytes);
+			char* moved = arena.Reserve(room);
+			if (carry > 0 && moved != space) {
+				memcpy(moved, space, carry);
+			}
+			space = moved;
+		}
+		ssize_t got = ReadBlock(fd, space + carry, room - carry);
+		if (got < 0) {
+			return false;
+		}
+		if (got == 0) {
+			if (carry > 0) {
+				arena.Commit(carry);
+				emit(space, carry);
+			}
+			return true;
+		}
+		// only the new bytes can end the token
+		const char* end = space + carry + got;
+		const char* found = static_cast<const char*>(memchr(space + carry, delimiter, (size_t)got));
+		if (found == nullptr) {
+			carry += (size_t)got;
+			continue;
+		}
+		emit(space, (size_t)(found - space));
+		size_t done = (size_t)(SplitTokens(found + 1, end, delimiter, emit) - space);
+		arena.Commit(done);
+		space += done;
+		room -= done;
+		carry = (size_t)(end - space);
+	}
+}
+
+
+/* ---------- FROM MEMORY ---------- */
+
+// Appends every token of data to list as a string.
+template<typename Stats>
+void IngestTokens(const char* data, size_t length, LinkedList<string, Nodes, Stats>& list, char delimiter = '\n') {
+	auto emit = [&list](const char* token, size_t size) {
+		list.AddTail(string(token, size));
+	};
+	const char* end = data + length;
+	const char* rest = SplitTokens(data, end, delimiter, emit);
+	if (rest != end) {
+		emit(rest, (size_t)(end - rest));
+	}
+}
+
+// Appends a view of every token of data to list. The views point into data, which must
+// outlive them (e.g. a mapping of the input file kept open).
+template<typename Stats>
+void IngestTokens(const char* data, size_t length, LinkedList<string_view, Nodes, Stats>& list, char delimiter = '\n') {
+	auto emit = [&list](const char* token, size_t size) {
+		list.AddTail(string_view(token, size));
+	};
+	const char* end = data + length;
+	const char* rest = SplitTokens(data, end, delimiter, emit);
+	if (rest != end) {
+		emit(rest, (size_t)(end - rest));
+	}
+}
+
+
+/* ---------- FROM A FILE ---------- */
+
+// Maps the file at path and appends every token to list as a string.
+template<typename Stats>
+bool IngestFile(const string& path, LinkedList<string, Nodes, Stats>& list, char delimiter = '\n') {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		close(fd);
+		return false;
+	}
+	void* mapped = MAP_FAILED;
+	if (S_ISREG(info.st_mode) && info.st_size > 0) {
+		mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	if (mapped == MAP_FAILED) {
+		// e.g. an empty file, a pipe or a character device: read it instead
+		bool complete = IngestTokens(fd, list, delimiter);
+		close(fd);
+		return complete;
+	}
+	close(fd);
+	madvise(mapped, (size_t)info.st_size, MADV_SEQUENTIAL);
+	IngestTokens(static_cast<const char*>(mapped), (size_t)info.st_size, list, delimiter);
+	munmap(mapped, (size_t)info.st_size);
+	return true;
+}
+
+// Has arena map the file at path, or read it if it cannot be mapped, and appends a view of
+// every token to list.
+template<typename Stats>
+bool IngestFile(const string& path, LinkedList<string_view, Nodes, Stats>& list, StringArena& arena, char delimiter = '\n') {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	string_view text;
+	bool complete = true;
+	if (arena.MapFile(fd, text)) {
+		IngestTokens(text.data(), text.size(), list, delimiter);
+	}
+	else {
+		complete = IngestTokens(fd, list, arena, delimiter);
+	}
+	close(fd);
+	return complete;
+}
+
+#endif
@@ -1,9 +1,76 @@
+#ifndef LINKEDLIST_H
+#define LINKEDLIST_H
+
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
+#include <utility>
+#include "ListStats.h"
+#include "NodePool.h"
+#include "PerfCounters.h"
+#include "Reclaimer.h"
 using namespace std;
 
-template<typename T>
-class LinkedList {
+// Storage backends for a LinkedList, selected with its second template argument.
+struct Nodes {};	// one heap-allocated Node per element (default)
+struct Arena {};	// Nodes allocated from blocks owned by the list, freed whole by Clear (see NodePool.h)
+struct HugePages {};	// as Arena, with blocks of 2 MB pages that can be NUMA placed (needs HugePages.h)
+struct Ring {};		// growable ring buffer for head/tail-only use (see RingBuffer.h)
+struct Strings {};	// strings stored inline in arena-allocated Nodes (see StringList.h)
+
+// Where the Nodes of a LinkedList with the given storage come from (see NodePool.h). HugePages.h
+// adds the allocator for HugePages, so only lists that use it need its Linux headers.
+template<typename Storage, typename Node>
+struct StorageAllocator {
+	static_assert(!is_same<Storage, HugePages>::value, "HugePages storage needs HugePages.h");
+	typedef NodeHeap<Node> type;
+};
+
+template<typename Node>
+struct StorageAllocator<Arena, Node> {
+	typedef NodePool<Node> type;
+};
+
+// Orderings a LinkedList can apply to itself after each successful Find.
+// Moving frequently searched Nodes toward the head shortens later searches on skewed workloads.
+enum class SearchOrder {
+	None,			// never reorder (default)
+	MoveToFront,	// move the found Node to the head
+	Transpose,		// swap the found Node with the Node before it
+	Count			// keep Nodes ordered by how many times they have been found
+};
+
+// Asks the CPU to start loading the cache line at address. Never faults, so the address may be
+// stale or null.
+#if defined(__GNUC__) || defined(__clang__)
+#define LINKEDLIST_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define LINKEDLIST_PREFETCH(address) ((void)(address))
+#endif
+
+// Lets an empty member share its address with the members before it, so a Node of an empty T is
+// just its two pointers.
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(no_unique_address)
+#define LINKEDLIST_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+#endif
+#if !defined(LINKEDLIST_NO_UNIQUE_ADDRESS)
+#define LINKEDLIST_NO_UNIQUE_ADDRESS
+#endif
+
+// Stats selects per-instance operation statistics: NoStats (default) or ListStats (see ListStats.h).
+template<typename T, typename Storage = Nodes, typename Stats = NoStats>
+class LinkedList : public Stats {
+
+	// Ring and Strings lists are separate classes (RingBuffer.h, StringList.h) without statistics;
+	// any other combination with them would silently be an ordinary Node list
+	static_assert(!is_same<Storage, Ring>::value && !is_same<Storage, Strings>::value,
+		"Ring storage needs RingBuffer.h and Strings storage needs StringList.h with T = string, "
+		"and neither takes a Stats policy");
 
 	public:
 
@@ -14,11 +81,99 @@ class LinkedList {
 		// data members of the Node class
 		Node* prev;         // pointer to the previous Node
 		Node* next;			// pointer to the next Node
-		T data;				// storage for the Node's data
+		LINKEDLIST_NO_UNIQUE_ADDRESS T data;	// storage for the Node's data
 
 		// not defining the big 5 because we do not need anything special for the Node class
 	};
 
+	// where Nodes come from: the heap one at a time, or blocks of the list's own
+	typedef typename StorageAllocator<Storage, Node>::type Allocator;
+
+	// a bidirectional iterator over the data of the Nodes, for range-based for loops, <algorithm>,
+	// std::ranges and the views in Views.h; end() is one past the tail and can be decremented
+	template<bool Const>
+	class Iterator {
+
+		friend class Iterator<!Const>;
+		typedef typename conditional<Const, const Node, Node>::type NodeType;
+		typedef typename conditional<Const, const LinkedList, LinkedList>::type ListType;
+
+		// data members of the Iterator class
+		NodeType* node;		// the current Node, or nullptr at the end
+		ListType* list;		// the list, for stepping back from the end
+
+		public:
+
+		typedef bidirectional_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef ptrdiff_t difference_type;
+		typedef typename conditional<Const, const T*, T*>::type pointer;
+		typedef typename conditional<Const, const T&, T&>::type reference;
+
+		Iterator() {
+			node = nullptr;
+			list = nullptr;
+		}
+
+		Iterator(NodeType* at, ListType* owner) {
+			node = at;
+			list = owner;
+		}
+
+		// an iterator converts to a const_iterator
+		template<bool WasConst, typename = typename enable_if<Const && !WasConst>::type>
+		Iterator(const Iterator<WasConst>& other) {
+			node = other.node;
+			list = other.list;
+		}
+
+		reference operator*() const {
+			return node->data;
+		}
+
+		pointer operator->() const {
+			return &node->data;
+		}
+
+		Iterator& operator++() {
+			node = node->next;
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator before = *this;
+			node = node->next;
+			return before;
+		}
+
+		Iterator& operator--() {
+			node = node != nullptr ? node->prev : list->tail;
+			return *this;
+		}
+
+		Iterator operator--(int) {
+			Iterator before = *this;
+			--*this;
+			return before;
+		}
+
+		bool operator==(const Iterator& other) const {
+			return node == other.node;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return node != other.node;
+		}
+
+		// Returns the current Node, for InsertBefore and the like, or nullptr at the end.
+		NodeType* GetNode() const {
+			return node;
+		}
+	};
+
+	typedef Iterator<false> iterator;
+	typedef Iterator<true> const_iterator;
+
 	private:
 
 	// data members of the LinkedList class
@@ -29,6 +184,13 @@ class LinkedList {
 	mutable Node* current;		// iterator for printing, deleting, etc.
 	mutable Node* queued;		// stores prev/next pointer of current Node
 	unsigned int size;			// number of Nodes currently in the LinkedList
+	SearchOrder order;			// how Find reorders the LinkedList after a hit
+	unordered_map<const Node*, unsigned int> hits;	// times Find returned each Node, under SearchOrder::Count only
+	bool deferClear;			// whether Clear hands the Nodes to the Reclaimer thread
+	unsigned int prefetchDistance;			// Nodes ahead that traversals prefetch, 0 for none
+	mutable vector<const Node*> path;		// Nodes in order from the head, recorded by traversals
+	mutable unsigned int pathKnown;			// leading entries of path that are still correct
+	Allocator allocator;		// memory for the Nodes
     
 
 	public:
@@ -38,23 +200,27 @@ class LinkedList {
 
 	// Constructor
 	// Sets all pointers to null and size to zero.
-	LinkedList<T>() {
+	LinkedList() {
 		head = nullptr;
 		tail = nullptr;
 		current = nullptr;
 		queued = nullptr;
 		size = 0;
+		order = SearchOrder::None;
+		deferClear = false;
+		prefetchDistance = 0;
+		pathKnown = 0;
 	}
 
 	// Copy Constructor
     // Creates a new LinkedList and adds a copy of each Node from the other LinkedList to the new LinkedList.
-	LinkedList<T>(const LinkedList<T>& otherList) {
+	LinkedList(const LinkedList& otherList) : Stats() {
 		Clone(otherList);
 	}
 
 	// Destructor
 	// Deletes all Nodes and resets data members to nullptr and 0.
-	~LinkedList<T>() {
+	~LinkedList() {
 		Clear();
 		
 		// reset list data members
@@ -77,13 +243,15 @@ class LinkedList {
     // Returns a constant version of the data from the Node at the specified index.
     // Throws an out_of_range error if no such Node exists.
 	const T& operator[](unsigned int index) const {
-		Node* node = GetNode(index);
+		const Node* node = GetNode(index);
 		const T& constData = node->data;
 		return constData;
 	}
 
     // Determines whether two LinkedLists are exactly equal.
-    bool operator==(const LinkedList<T>& rhs) const {
+    bool operator==(const LinkedList& rhs) const {
+        LINKEDLIST_PERF_SCOPE(Traverse);
+        this->StatsCall(ListOp::Compare);
         if (size != rhs.size) {
             return false;
         }
@@ -91,21 +259,35 @@ class LinkedList {
             return true;
         }
         current = head;
-        rhs.current = head;
+        rhs.current = rhs.head;
+        unsigned int visited = 0;
         while (current != nullptr) {
+            if (prefetchDistance != 0) {
+                PrefetchAhead(current, visited);
+            }
+            if (rhs.prefetchDistance != 0) {
+                rhs.PrefetchAhead(rhs.current, visited);
+            }
+            visited++;
             if (current->data != rhs.current->data) {
+                this->StatsVisit(ListOp::Compare, visited);
                 return false;
             }
             current = current->next;
             rhs.current = rhs.current->next;
         }
+        this->StatsVisit(ListOp::Compare, visited);
         return true;
     }
 
 	// Deletes a LinkedList and re-constructs it using the Copy Constructor.
-    LinkedList<T>& operator=(const LinkedList<T>& rhs) {
+    LinkedList& operator=(const LinkedList& rhs) {
+		LINKEDLIST_PERF_SCOPE(Traverse);
+		if (this == &rhs) {
+			return *this;
+		}
 		Clear();
-        LinkedList<T>& list = *Clone(rhs);
+        LinkedList& list = *Clone(rhs);
         return list;
     }
 
@@ -115,30 +297,243 @@ class LinkedList {
 	/* ---------- Helper Functions ---------- */
 
     // Copies all member variables and Nodes from one LinkedList to another.
-    LinkedList<T>* Clone(const LinkedList<T>& otherList) {
-        LinkedList<T>();
+    LinkedList* Clone(const LinkedList& otherList) {
+		LINKEDLIST_PERF_SCOPE(Traverse);
+		this->StatsCall(ListOp::Copy);
+		this->StatsVisit(ListOp::Copy, otherList.size);
+		head = nullptr;
+		tail = nullptr;
 		size = 0;
+		order = otherList.order;
+		deferClear = otherList.deferClear;
+		prefetchDistance = otherList.prefetchDistance;
+		pathKnown = 0;
+		this->StatsCall(ListOp::AddTail, otherList.size);
 		otherList.current = otherList.head;
-		while (otherList.current != nullptr) {
-            AddTail(otherList.current->data);
+		SpliceChain(nullptr, nullptr, otherList.size, [&otherList](unsigned int) -> const T& {
+			const T& data = otherList.current->data;
 			otherList.current = otherList.current->next;
-		}
-        size = otherList.size;
+			return data;
+		});
 		return this;
     }
 
 	// Iterates through a LinkedList and returns the Node with the specified value.
-	Node* Search(Node* start, const T& value) const {
+	// index is the position of start on the way in and that of the Node found on the way out.
+	// Counts the Nodes compared for the operation that searched.
+	Node* Search(Node* start, unsigned int& index, const T& value, ListOp op) const {
+		unsigned int visited = 0;
 		current = start;
 		while(current != nullptr) {
+			if (prefetchDistance != 0) {
+				PrefetchAhead(current, index + visited);
+			}
+			visited++;
 			if (current->data == value) {
+				this->StatsVisit(op, visited);
+				index += visited - 1;
 				return current;
 			}
 			current = current->next;
 		}
+		this->StatsVisit(op, visited);
 		return nullptr;
 	}
 
+	// Called with each Node a traversal from the head reaches and its position. Prefetches the Node
+	// prefetchDistance further on when path knows it, and otherwise records this one in path, so
+	// the next traversal can prefetch. A stale entry only costs a useless prefetch.
+	void PrefetchAhead(const Node* node, unsigned int index) const {
+		if (index < pathKnown) {
+			if (index + prefetchDistance < pathKnown) {
+				LINKEDLIST_PREFETCH(path[index + prefetchDistance]);
+			}
+		}
+		else if (index == pathKnown) {
+			if (index < path.size()) {
+				path[index] = node;
+			}
+			else {
+				path.push_back(node);
+			}
+			pathKnown++;
+		}
+	}
+
+	// Forgets the path from the specified position on, after the Nodes there changed.
+	void TrimPath(unsigned int position) {
+		if (position < pathKnown) {
+			pathKnown = position;
+		}
+	}
+
+	// Detaches a Node from its neighbors, updating head and tail if needed.
+	void Unlink(Node* node) {
+		if (node->prev != nullptr) {
+			node->prev->next = node->next;
+		}
+		else {
+			head = node->next;
+		}
+		if (node->next != nullptr) {
+			node->next->prev = node->prev;
+		}
+		else {
+			tail = node->prev;
+		}
+	}
+
+	// Creates an unlinked Node from the list's allocator, constructing its data in place from value
+	// rather than default-constructing it and assigning (a plain copy for trivially copyable T).
+	// Always inlined, like NodeHeap::Allocate, so heap allocations are attributed to the caller.
+	template<typename Value>
+	NODEPOOL_ALWAYS_INLINE Node* NewNode(Value&& value) {
+		return ConstructNode(allocator.Allocate(), std::forward<Value>(value));
+	}
+
+	// Constructs an unlinked Node in memory from the list's allocator, as NewNode does. If the
+	// data's constructor throws, the memory goes back to the allocator.
+	template<typename Value>
+	Node* ConstructNode(void* memory, Value&& value) {
+		Node* node;
+		if (is_nothrow_constructible<T, Value&&>::value) {
+			node = new (memory) Node{ nullptr, nullptr, std::forward<Value>(value) };
+		}
+		else {
+			try {
+				node = new (memory) Node{ nullptr, nullptr, std::forward<Value>(value) };
+			}
+			catch (...) {
+				allocator.Release(memory);
+				throw;
+			}
+		}
+		this->StatsAllocate(sizeof(Node));
+		return node;
+	}
+
+	// Creates count Nodes with the values get(0) to get(count - 1), linked in that order, and
+	// links the chain in between prev and next in one step instead of one Node at a time.
+	// Room for all of them is reserved first, so Arena storage takes them from one block.
+	template<typename Get>
+	void SpliceChain(Node* prev, Node* next, unsigned int count, Get get) {
+		if (count == 0) {
+			return;
+		}
+		allocator.Reserve(count);
+		Node* first = NewNode(get(0));
+		Node* last = first;
+		try {
+			for (unsigned int i = 1; i < count; i++) {
+				Node* node = NewNode(get(i));
+				node->prev = last;
+				last->next = node;
+				last = node;
+			}
+		}
+		catch (...) {
+			// the LinkedList is untouched until the chain is complete
+			while (first != nullptr) {
+				Node* following = first->next;
+				DeleteNode(first);
+				first = following;
+			}
+			throw;
+		}
+		first->prev = prev;
+		last->next = next;
+		if (prev != nullptr) {
+			prev->next = first;
+		}
+		else {
+			head = first;
+		}
+		if (next != nullptr) {
+			next->prev = last;
+		}
+		else {
+			tail = last;
+		}
+		size += count;
+	}
+
+	// Destroys a Node and gives its memory back to the list's allocator.
+	void DeleteNode(Node* node) {
+		this->StatsRelease(sizeof(Node));
+		if (!hits.empty()) {
+			hits.erase(node);
+		}
+		node->~Node();
+		allocator.Release(node);
+	}
+
+	// Destroys every Node from first onward and frees their memory. A pool that frees all of its
+	// blocks at once only needs the Nodes visited when T has a destructor to run. The first known
+	// entries of ahead, if given, are the Nodes in order, to be prefetched distance Nodes ahead.
+	// Returns the number of Nodes visited.
+	static unsigned int DeleteChain(Node* first, Allocator& nodes, const Node* const* ahead = nullptr,
+		unsigned int known = 0, unsigned int distance = 0) {
+		unsigned int visited = 0;
+		if (!Allocator::releasesAll || !is_trivially_destructible<T>::value) {
+			while (first != nullptr) {
+				if (visited + distance < known) {
+					LINKEDLIST_PREFETCH(ahead[visited + distance]);
+				}
+				Node* next = first->next;
+				first->~Node();
+				if (!Allocator::releasesAll) {
+					nodes.Release(first);
+				}
+				first = next;
+				visited++;
+			}
+		}
+		nodes.Reset();
+		return visited;
+	}
+
+	// Links a detached Node into the LinkedList directly before the target Node.
+	void LinkBefore(Node* target, Node* node) {
+		node->prev = target->prev;
+		node->next = target;
+		if (target->prev != nullptr) {
+			target->prev->next = node;
+		}
+		else {
+			head = node;
+		}
+		target->prev = node;
+	}
+
+	// Returns the number of times Find has returned a Node under SearchOrder::Count.
+	unsigned int Hits(const Node* node) const {
+		typename unordered_map<const Node*, unsigned int>::const_iterator found = hits.find(node);
+		return found != hits.end() ? found->second : 0;
+	}
+
+	// Moves a Node returned by Find toward the head according to the SearchOrder.
+	void Reorder(Node* node) {
+		Node* target = nullptr;
+		if (order == SearchOrder::MoveToFront) {
+			target = head;
+		}
+		else if (order == SearchOrder::Transpose) {
+			target = node->prev;
+		}
+		else if (order == SearchOrder::Count) {
+			unsigned int count = ++hits[node];
+			target = node;
+			while (target->prev != nullptr && Hits(target->prev) < count) {
+				target = target->prev;
+			}
+		}
+		if (target != nullptr && target != node) {
+			Unlink(node);
+			LinkBefore(target, node);
+			TrimPath(0);
+		}
+	}
+
 
 	public:
 
@@ -146,8 +541,15 @@ class LinkedList {
 
 	// Prints all Nodes in the LinkedList from beginning to end.
 	void PrintForward() const {
+		LINKEDLIST_PERF_SCOPE(Traverse);
+		this->StatsCall(ListOp::Print);
+		this->StatsVisit(ListOp::Print, size);
 		current = head;
+		unsigned int index = 0;
 		while (current != nullptr) {
+			if (prefetchDistance != 0) {
+				PrefetchAhead(current, index++);
+			}
 			cout << current->data << endl;
 			current = current->next;
 		}
@@ -155,6 +557,9 @@ class LinkedList {
 
 	// Prints all Nodes in the LinkedList from end to beginning.
 	void PrintReverse() const {
+		LINKEDLIST_PERF_SCOPE(Traverse);
+		this->StatsCall(ListOp::Print);
+		this->StatsVisit(ListOp::Print, size);
 		current = tail;
 		while (current != nullptr) {
 			cout << current->data << endl;
@@ -164,6 +569,7 @@ class LinkedList {
 
 	// Uses recursion to visit all nodes from a specified index to the end of the LinkedList.
 	void PrintForwardRecursive(const Node* node) const {
+		LINKEDLIST_PERF_SCOPE(Traverse);
 		if (node == tail) {
 			cout << node->data << endl;
 		}
@@ -176,6 +582,7 @@ class LinkedList {
 
 	// Uses recursion to visit all nodes from a specified index to the beginning of the LinkedList.
 	void PrintReverseRecursive(const Node* node) const {
+		LINKEDLIST_PERF_SCOPE(Traverse);
 		if (node == head) {
 			cout << node->data << endl;
 		}
@@ -194,64 +601,138 @@ class LinkedList {
 		return size;
 	}
 
+	// Returns how Find reorders the LinkedList after a successful search.
+	SearchOrder GetSearchOrder() const {
+		return order;
+	}
+
+	// Sets how Find reorders the LinkedList after a successful search.
+	// SearchOrder::Count keeps its counts beside the Nodes, so the other orders cost no memory per
+	// Node; leaving Count forgets them.
+	void SetSearchOrder(SearchOrder searchOrder) {
+		order = searchOrder;
+		if (order != SearchOrder::Count) {
+			unordered_map<const Node*, unsigned int>().swap(hits);
+		}
+	}
+
+	// Returns how many Nodes ahead traversals prefetch, 0 if they do not.
+	unsigned int GetPrefetch() const {
+		return prefetchDistance;
+	}
+
+	// Sets how many Nodes ahead Search, GetNode, Clear, PrintForward and operator== prefetch, 0 to
+	// stop (the default). A Node's successor is only known once the Node itself has arrived, so
+	// the list keeps the order of its Nodes beside them (8 bytes per Node while prefetching is on),
+	// recorded as traversals from the head walk it and trimmed wherever Nodes are added or removed.
+	// A traversal after a change records the path again; the ones after that prefetch from it.
+	// Distances of 4 to 16 suit Nodes scattered in memory.
+	void SetPrefetch(unsigned int distance) {
+		prefetchDistance = distance;
+		pathKnown = 0;
+		if (distance == 0) {
+			vector<const Node*>().swap(path);
+		}
+	}
+
+	// Returns the allocator the Nodes come from, e.g. to place a HugePages list's blocks with
+	// NodeAllocator().SetPlacement(NumaPlacement::OnNode(1)) before adding to it.
+	Allocator& NodeAllocator() {
+		return allocator;
+	}
+
+	// Returns whether Clear and the destructor leave deleting the Nodes to the Reclaimer thread.
+	bool GetDeferredClear() const {
+		return deferClear;
+	}
+
+	// Sets whether Clear and the destructor leave deleting the Nodes to the Reclaimer thread, so
+	// dropping a long list costs the caller O(1). Nothing else may refer to the Nodes afterwards.
+	void SetDeferredClear(bool deferred) {
+		deferClear = deferred;
+	}
+
     // Returns a pointer to the first Node with the specified data.
+    // Reorders the LinkedList according to its SearchOrder when the data is found.
 	Node* Find(const T& data) {
+		LINKEDLIST_PERF_SCOPE(Search);
+		this->StatsCall(ListOp::Find);
 		if (size > 0) {
-			Node* foundNode = Search(head, data);
+			unsigned int index = 0;
+			Node* foundNode = Search(head, index, data, ListOp::Find);
+			if (foundNode != nullptr && order != SearchOrder::None) {
+				Reorder(foundNode);
+			}
 			return foundNode;
 		}
 		return nullptr;
 	}
 
 	// Returns a constant pointer to the first Node with the specified data.
+	// Never reorders the LinkedList.
 	const Node* Find(const T& data) const {
+		LINKEDLIST_PERF_SCOPE(Search);
+		this->StatsCall(ListOp::Find);
 		if (size > 0) {
-			const Node* foundNode = Search(head, data);
+			unsigned int index = 0;
+			const Node* foundNode = Search(head, index, data, ListOp::Find);
 			return foundNode;
 		}
 		return nullptr;
 	}
 
-	// Fills a vector with 
+	// Fills a vector with pointers to every Node containing the specified value, head first.
 	void FindAll(vector<Node*>& outData, const T& value) const {
-		if (size > 0) {
-			current = head;
-			Node* foundNode = nullptr;
-			while (current != nullptr) {
-				foundNode = Search(current, value);
-				outData.push_back(foundNode);
-				current = foundNode->next;
-			}
+		LINKEDLIST_PERF_SCOPE(Search);
+		this->StatsCall(ListOp::FindAll);
+		unsigned int index = 0;
+		Node* foundNode = Search(head, index, value, ListOp::FindAll);
+		while (foundNode != nullptr) {
+			outData.push_back(foundNode);
+			index++;
+			foundNode = Search(foundNode->next, index, value, ListOp::FindAll);
 		}
 	}
     
     // Returns a pointer to the Node at the specified index.
     // Throws an out_of_range error if no such Node exists.
     Node* GetNode(unsigned int index) {
-        if (index > size || size == 0) {
+        LINKEDLIST_PERF_SCOPE(Search);
+        this->StatsCall(ListOp::GetNode);
+        if (index >= size) {
             throw out_of_range("");
         }
         current = head;
         unsigned int currentIndex = 0;
         while (currentIndex != index) {
+            if (prefetchDistance != 0) {
+                PrefetchAhead(current, currentIndex);
+            }
             current = current->next;
             currentIndex++;
         }
+        this->StatsVisit(ListOp::GetNode, index + 1);
         return current;
     }
 
     // Returns a constant pointer to the Node at the specified index.
     // Throws an out_of_range error if no such index exists.
     const Node* GetNode(unsigned int index) const {
-		if (index > size || size == 0) {
+		LINKEDLIST_PERF_SCOPE(Search);
+		this->StatsCall(ListOp::GetNode);
+		if (index >= size) {
             throw out_of_range("");
         }
         current = head;
         unsigned int currentIndex = 0;
         while (currentIndex != index) {
+            if (prefetchDistance != 0) {
+                PrefetchAhead(current, currentIndex);
+            }
             current = current->next;
             currentIndex++;
         }
+        this->StatsVisit(ListOp::GetNode, index + 1);
         const Node* constNode = current;
 		return constNode;
     }
@@ -278,14 +759,33 @@ class LinkedList {
         return constTail;
     }
 
+	// Returns an iterator to the head's data.
+	iterator begin() {
+		return iterator(head, this);
+	}
+
+	const_iterator begin() const {
+		return const_iterator(head, this);
+	}
+
+	// Returns an iterator one past the tail's data.
+	iterator end() {
+		return iterator(nullptr, this);
+	}
+
+	const_iterator end() const {
+		return const_iterator(nullptr, this);
+	}
+
 
 	/* ---------- INSERTION ---------- */
 
 	// Creates a new Node and adds it at the beginning of the LinkedList.
     // Increments the size of the LinkedList.
 	void AddHead(const T& data) {
-        Node* newNode = new Node();
-		newNode->data = data;
+        LINKEDLIST_PERF_SCOPE(Insert);
+        this->StatsCall(ListOp::AddHead);
+        Node* newNode = NewNode(data);
         if (size == 0) {
             newNode->next = nullptr;
             tail = newNode;
@@ -297,13 +797,15 @@ class LinkedList {
         newNode->prev = nullptr;
         head = newNode;
 		size++;
+		TrimPath(0);
 	}
 
 	// Creates a new Node and adds it at the end of the LinkedList.
     // Increments the size of the LinkedList.
 	void AddTail(const T& data) {
-		Node* newNode = new Node();
-		newNode->data = data;
+		LINKEDLIST_PERF_SCOPE(Insert);
+		this->StatsCall(ListOp::AddTail);
+		Node* newNode = NewNode(data);
         if (size == 0) {
             newNode->prev = nullptr;
             head = newNode;
@@ -317,47 +819,78 @@ class LinkedList {
 		size++;
 	}
 
+	// Creates a new Node and moves the data into it at the end of the LinkedList.
+	// Lets loaders hand over strings they built without copying them again.
+	void AddTail(T&& data) {
+		LINKEDLIST_PERF_SCOPE(Insert);
+		this->StatsCall(ListOp::AddTail);
+		Node* newNode = NewNode(std::move(data));
+		newNode->prev = tail;
+		newNode->next = nullptr;
+		if (size == 0) {
+			head = newNode;
+		}
+		else {
+			tail->next = newNode;
+		}
+		tail = newNode;
+		size++;
+	}
+
     // Adds an array of data to the head of the LinkedList, creating a new Node for each datum.
+    // The Nodes are linked to each other first and to the LinkedList once.
 	void AddNodesHead(const T* data, unsigned int count) {
-		for (unsigned int i = count; i > 0; i--) {
-			AddHead(data[i-1]);
-		}
+		LINKEDLIST_PERF_SCOPE(Insert);
+		this->StatsCall(ListOp::AddHead, count);
+		SpliceChain(nullptr, head, count, [data](unsigned int i) -> const T& {
+			return data[i];
+		});
+		TrimPath(0);
 	}
 
     // Adds an array of data to the tail of the LinkedList, creating a new Node for each datum.
+    // The Nodes are linked to each other first and to the LinkedList once.
 	void AddNodesTail(const T* data, unsigned int count) {
-		for (unsigned int i = 0; i < count; i++) {
-			AddTail(data[i]);
-		}
+		LINKEDLIST_PERF_SCOPE(Insert);
+		this->StatsCall(ListOp::AddTail, count);
+		SpliceChain(tail, nullptr, count, [data](unsigned int i) -> const T& {
+			return data[i];
+		});
 	}
 
 	// Inserts a new Node containing the specified data before the passed-in Node.
 	void InsertBefore(Node* node, const T& data) {
-		Node* newNode = new Node();
-		newNode->data = data;
+		LINKEDLIST_PERF_SCOPE(Insert);
+		this->StatsCall(ListOp::InsertBefore);
+		Node* newNode = NewNode(data);
 		queued = node->prev;
 		node->prev = newNode;
 		newNode->next = node;
 		queued->next = newNode;
 		newNode->prev = queued;
 		size++;
+		TrimPath(0);
 	}
 
 	// Inserts a new Node containing the specified data after the passed-in Node.
 	void InsertAfter(Node* node, const T& data) {
-		Node* newNode = new Node();
-		newNode->data = data;
+		LINKEDLIST_PERF_SCOPE(Insert);
+		this->StatsCall(ListOp::InsertAfter);
+		Node* newNode = NewNode(data);
 		queued = node->next;
 		node->next = newNode;
 		newNode->prev = node;
 		queued->prev = newNode;
 		newNode->next = queued;
 		size++;
+		TrimPath(0);
 	}
 
 	// Inserts a new Node containing the specified data at the specified index.
 	// Throws an out_of_range exception if passed-in index is not valid.
 	void InsertAt(const T& data, unsigned int index) {
+		LINKEDLIST_PERF_SCOPE(Insert);
+		this->StatsCall(ListOp::InsertAt);
 		if (index > size) {
 			throw out_of_range("");
 		}
@@ -368,18 +901,19 @@ class LinkedList {
 			AddTail(data);
 		}
 		else {
-			Node* newNode = new Node();
-			newNode->data = data;
+			Node* newNode = NewNode(data);
 			current = head;
 			for (unsigned int i = 0; i < index - 1; i++) {
 				current = current->next;
 			}
+			this->StatsVisit(ListOp::InsertAt, index);
 			queued = current->next;
 			current->next = newNode;
 			newNode->prev = current;
 			queued->prev = newNode;
 			newNode->next = queued;
 			size++;
+			TrimPath(index);
 		}
 	}
 
@@ -389,19 +923,22 @@ class LinkedList {
 	// Removes the first Node in the LinkedList.
 	// Returns true if removal is successful and false if removal is unsuccessful.
 	bool RemoveHead() {
+        LINKEDLIST_PERF_SCOPE(Remove);
+        this->StatsCall(ListOp::RemoveHead);
         if (head != nullptr) {
             if (head == tail) {
-                delete head;
+                DeleteNode(head);
                 head = nullptr;
                 tail = nullptr;
             }
             else {
                 queued = head->next;
-                delete head;
+                DeleteNode(head);
                 head = queued;
                 head->prev = nullptr;
             }
             size--;
+            TrimPath(0);
             return true;
         }
         else {
@@ -412,19 +949,22 @@ class LinkedList {
 	// Removes the last Node in the LinkedList.
 	// Returns true if removal is successful and false if removal is unsuccessful.
 	bool RemoveTail() {
+        LINKEDLIST_PERF_SCOPE(Remove);
+        this->StatsCall(ListOp::RemoveTail);
         if (tail != nullptr) {
             if (head == tail) {
-                delete tail;
+                DeleteNode(tail);
                 head = nullptr;
                 tail = nullptr;
             }
             else {
                 queued = tail->prev;
-                delete tail;
+                DeleteNode(tail);
                 tail = queued;
                 tail->next = nullptr;
             }
             size--;
+            TrimPath(size);
             return true;
         }
         else {
@@ -435,32 +975,25 @@ class LinkedList {
 	// Remove all Nodes containing the specified data.
 	// Returns the number of nodes removed.
 	unsigned int Remove(const T& data) {
+		LINKEDLIST_PERF_SCOPE(Remove);
+		this->StatsCall(ListOp::Remove);
+		this->StatsVisit(ListOp::Remove, size);
 		unsigned int numRemoved = 0;
-		preceding = head;
-		current = preceding->next;
-		queued = current->next;
-		while (queued != nullptr) {
+		unsigned int kept = 0;
+		current = head;
+		while (current != nullptr) {
+			queued = current->next;
 			if (current->data == data) {
-				delete current;
-				current = nullptr;
-				preceding->next = queued;
-				queued->prev = preceding;
-				current = queued;
-				queued = current->next;
+				Unlink(current);
+				DeleteNode(current);
 				size--;
 				numRemoved++;
+				TrimPath(kept);
 			}
 			else {
-				preceding = current;
-				current = queued;
-				queued = current->next;
+				kept++;
 			}
-		}
-		if (head->data == data) {
-			RemoveHead();
-		}
-		if (tail->data == data) {
-			RemoveTail();
+			current = queued;
 		}
 		return numRemoved;
 	}
@@ -468,7 +1001,9 @@ class LinkedList {
 	// Remove the Node at the specified index.
 	// Return true if removal is successful and false if removal is unsuccessful.
 	bool RemoveAt(unsigned int index) {
-		if (index > size - 1) {
+		LINKEDLIST_PERF_SCOPE(Remove);
+		this->StatsCall(ListOp::RemoveAt);
+		if (index >= size) {
 			return false;
 		}
 		if (index == 0) {
@@ -486,25 +1021,265 @@ class LinkedList {
 				current = queued;
 				queued = current->next;
 			}
-			delete current;
+			this->StatsVisit(ListOp::RemoveAt, index + 1);
+			DeleteNode(current);
 			current = nullptr;
 			preceding->next = queued;
 			queued->prev = preceding;
 			size--;
+			TrimPath(index);
 		}
 		return true;
 	}
 
 	// Deletes all Nodes from the LinkedList and resets size to 0.
+	// With Arena storage the blocks are freed whole, without visiting the Nodes unless T has a
+	// destructor. With SetDeferredClear(true) the Nodes are handed to the Reclaimer thread instead,
+	// so the caller only unhooks them.
 	void Clear() {
-		current = tail;
-		while (current != nullptr) {
-			queued = current->prev;
-			delete current;
-			current = queued;
-            size--;
+		LINKEDLIST_PERF_SCOPE(Remove);
+		this->StatsCall(ListOp::Clear);
+		if (size > 0) {
+			this->StatsRelease(sizeof(Node), size);
+		}
+		if (deferClear && head != nullptr) {
+			Node* first = head;
+			Allocator* nodes = new Allocator(std::move(allocator));
+			Reclaimer::Instance().Submit([first, nodes]() {
+				DeleteChain(first, *nodes);
+				delete nodes;
+			});
+		}
+		else if (prefetchDistance != 0) {
+			this->StatsVisit(ListOp::Clear, DeleteChain(head, allocator, path.data(), pathKnown, prefetchDistance));
+		}
+		else {
+			this->StatsVisit(ListOp::Clear, DeleteChain(head, allocator));
 		}
 		head = nullptr;
 		tail = nullptr;
+		current = nullptr;
+		queued = nullptr;
+		size = 0;
+		pathKnown = 0;
+		hits.clear();
 	}
-};
\ No newline at end of file
+
+
+	/* ---------- BATCHES ---------- */
+
+	// Records InsertAt, RemoveAt and AddTail edits and applies them together: Apply sorts them by
+	// position and makes them in one walk from the head, creating every new Node before it starts,
+	// so K edits to a list of N Nodes cost O(N + K log K) instead of a walk each.
+	// Positions refer to the list as it was when the edits were recorded, so recording RemoveAt(3)
+	// and then InsertAt(x, 5) removes the Node that was at 3 and inserts before the one that was
+	// at 5. Several insertions at one position keep the order they were recorded in, before the
+	// Node there, and removing a position twice removes it once. The list must not be changed
+	// by other means between recording and Apply.
+	class Batch {
+
+		static const unsigned int removal = ~0u;
+
+		// one recorded edit
+		struct Edit {
+			unsigned int position;	// Node the edit removes or inserts before; size for the end
+			unsigned int value;		// index into values for an insertion, removal for a removal
+		};
+
+		// data members of the Batch class
+		LinkedList& list;		// the list the edits are for
+		vector<Edit> edits;		// edits in the order they were recorded
+		vector<T> values;		// data of the insertions
+
+
+		public:
+
+		/* ---------- CONSTRUCTION ---------- */
+
+		// Constructor
+		// Creates an empty Batch of edits to target.
+		explicit Batch(LinkedList& target) : list(target) {
+		}
+
+
+		/* ---------- RECORDING ---------- */
+
+		// Records an insertion of data before the Node now at the specified index.
+		// Throws an out_of_range exception if passed-in index is not valid.
+		void InsertAt(const T& data, unsigned int index) {
+			if (index > list.size) {
+				throw out_of_range("");
+			}
+			edits.push_back(Edit{ index, (unsigned int)values.size() });
+			values.push_back(data);
+		}
+
+		// Records an insertion of data at the end of the list.
+		void AddTail(const T& data) {
+			InsertAt(data, list.size);
+		}
+
+		// Records a removal of the Node now at the specified index.
+		// Returns false if there is no such Node.
+		bool RemoveAt(unsigned int index) {
+			if (index >= list.size) {
+				return false;
+			}
+			edits.push_back(Edit{ index, removal });
+			return true;
+		}
+
+		// Returns the number of edits recorded since the last Apply.
+		unsigned int EditCount() const {
+			return (unsigned int)edits.size();
+		}
+
+		// Forgets the recorded edits without applying them.
+		void Clear() {
+			edits.clear();
+			values.clear();
+		}
+
+
+		/* ---------- APPLYING ---------- */
+
+		// Makes every recorded edit to the list and empties the Batch.
+		// Throws an out_of_range exception if the list has shrunk so that an edit's position is no
+		// longer in it. If that happens, or creating a Node throws, the list is unchanged and the
+		// edits are kept.
+		void Apply() {
+			LINKEDLIST_PERF_SCOPE(Insert);
+			list.StatsCall(ListOp::Apply);
+			if (edits.empty()) {
+				return;
+			}
+			for (const Edit& edit : edits) {
+				if (edit.value != removal ? edit.position > list.size : edit.position >= list.size) {
+					throw out_of_range("");
+				}
+			}
+			stable_sort(edits.begin(), edits.end(), [](const Edit& left, const Edit& right) {
+				if (left.position != right.position) {
+					return left.position < right.position;
+				}
+				return left.value != removal && right.value == removal;
+			});
+
+			// new Nodes first, chained in the order they go in, so the walk below cannot fail
+			Node* created = CreateNodes();
+
+			Node* node = list.head;
+			unsigned int index = 0;
+			unsigned int added = 0;
+			unsigned int removed = 0;
+			for (const Edit& edit : edits) {
+				if (edit.position < index) {
+					// a second removal of a Node already removed
+					continue;
+				}
+				while (index < edit.position) {
+					node = node->next;
+					index++;
+				}
+				if (edit.value != removal) {
+					Node* newNode = created;
+					created = created->next;
+					if (node != nullptr) {
+						list.LinkBefore(node, newNode);
+					}
+					else {
+						newNode->prev = list.tail;
+						newNode->next = nullptr;
+						if (list.tail != nullptr) {
+							list.tail->next = newNode;
+						}
+						else {
+							list.head = newNode;
+						}
+						list.tail = newNode;
+					}
+					added++;
+				}
+				else {
+					Node* following = node->next;
+					list.Unlink(node);
+					list.DeleteNode(node);
+					node = following;
+					index++;
+					removed++;
+				}
+			}
+			list.StatsVisit(ListOp::Apply, index);
+			list.size = list.size + added - removed;
+			list.TrimPath(edits[0].position);
+			Clear();
+		}
+
+
+		private:
+
+		/* ---------- Helper Functions ---------- */
+
+		// Creates the Nodes for the insertions in the order they go in, linked by next, with room
+		// for all of them reserved together. The memory for every Node is taken before any data:
+		// then data is moved out of values only when moving cannot throw, and otherwise copied, so
+		// if anything throws, values still holds every insertion's data.
+		// Returns the first, or nullptr if there are none; if one throws, deletes the others.
+		Node* CreateNodes() {
+			list.allocator.Reserve((unsigned int)values.size());
+			// unused memory, chained through its first bytes
+			void* memory = nullptr;
+			try {
+				for (unsigned int i = 0; i < values.size(); i++) {
+					void* more = list.allocator.Allocate();
+					*static_cast<void**>(more) = memory;
+					memory = more;
+				}
+			}
+			catch (...) {
+				ReleaseMemory(memory);
+				throw;
+			}
+			Node* first = nullptr;
+			Node* last = nullptr;
+			try {
+				for (const Edit& edit : edits) {
+					if (edit.value != removal) {
+						void* at = memory;
+						memory = *static_cast<void**>(at);
+						Node* node = list.ConstructNode(at, move_if_noexcept(values[edit.value]));
+						if (last != nullptr) {
+							last->next = node;
+						}
+						else {
+							first = node;
+						}
+						last = node;
+					}
+				}
+			}
+			catch (...) {
+				// ConstructNode released the memory of the Node that threw
+				ReleaseMemory(memory);
+				while (first != nullptr) {
+					Node* following = first->next;
+					list.DeleteNode(first);
+					first = following;
+				}
+				throw;
+			}
+			return first;
+		}
+
+		// Gives a chain of unused Node memory back to the allocator.
+		void ReleaseMemory(void* memory) {
+			while (memory != nullptr) {
+				void* next = *static_cast<void**>(memory);
+				list.allocator.Release(memory);
+				memory = next;
+			}
+		}
+	};
+};
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef LISTSTATS_H
+#define LISTSTATS_H
+
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+using namespace std;
+
+// Per-instance operation statistics for a LinkedList, selected with its third template argument:
+//	LinkedList<int, Nodes, ListStats> list;
+//	...
+//	list.Statistics().PrintJson(cout);
+// NoStats (the default) keeps nothing and its hooks compile away; ListStats counts calls and the
+// Nodes each operation visits, so O(n^2) patterns such as operator[] in a loop stand out as a
+// high visited/call for GetNode. An operation that calls another (InsertAt at an end calls
+// AddHead or AddTail, copying calls AddTail) counts for both.
+
+// Operations counted by ListStats; operator[] counts as GetNode.
+enum class ListOp {
+	AddHead,
+	AddTail,
+	InsertBefore,
+	InsertAfter,
+	InsertAt,
+	Find,
+	FindAll,
+	GetNode,
+	RemoveHead,
+	RemoveTail,
+	Remove,
+	RemoveAt,
+	Clear,
+	Copy,
+	Compare,
+	Print,
+	Apply,		// Batch::Apply
+	Count
+};
+
+// Statistics policy that records nothing.
+struct NoStats {
+
+	protected:
+
+	void StatsCall(ListOp, unsigned int = 1) const {}
+	void StatsVisit(ListOp, unsigned int) const {}
+	void StatsAllocate(size_t) const {}
+	void StatsRelease(size_t, unsigned int = 1) const {}
+};
+
+// Statistics policy that counts calls, Nodes visited, size and bytes allocated.
+class ListStats {
+
+	public:
+
+	// A copy of the counters at one point in time.
+	struct Snapshot {
+		unsigned long long calls[(int)ListOp::Count];	// times each operation was called
+		unsigned long long visited[(int)ListOp::Count];	// Nodes each operation walked over
+		unsigned long long allocations;		// Nodes created
+		unsigned long long releases;		// Nodes deleted
+		unsigned long long bytesAllocated;	// bytes of all Nodes ever created
+		unsigned long long bytesLive;		// bytes of the Nodes currently in the list
+		unsigned long long size;			// Nodes currently in the list
+		unsigned long long peakSize;		// largest size reached
+
+		// Returns the average number of Nodes visited per call of an operation.
+		double VisitedPerCall(ListOp op) const {
+			unsigned long long count = calls[(int)op];
+			return count > 0 ? (double)visited[(int)op] / count : 0;
+		}
+
+		// Prints the counters as a table, one line per operation used.
+		void PrintText(ostream& out) const {
+			out << "size: " << size << "  peak size: " << peakSize << "  allocations: " << allocations
+				<< "  bytes allocated: " << bytesAllocated << "  bytes live: " << bytesLive << endl;
+			out << left << setw(14) << "operation" << setw(14) << "calls" << setw(16) << "nodes visited"
+				<< "visited/call" << endl;
+			for (int op = 0; op < (int)ListOp::Count; op++) {
+				if (calls[op] > 0) {
+					out << left << setw(14) << Name((ListOp)op) << setw(14) << calls[op] << setw(16) << visited[op]
+						<< fixed << setprecision(1) << VisitedPerCall((ListOp)op) << endl;
+				}
+			}
+		}
+
+		// Prints the counters as a JSON object, listing only the operations used.
+		void PrintJson(ostream& out) const {
+			out << "{\"size\": " << size << ", \"peak_size\": " << peakSize << ", \"allocations\": " << allocations
+				<< ", \"releases\": " << releases << ", \"bytes_allocated\": " << bytesAllocated
+				<< ", \"bytes_live\": " << bytesLive << ", \"operations\": {";
+			bool first = true;
+			for (int op = 0; op < (int)ListOp::Count; op++) {
+				if (calls[op] > 0) {
+					out << (first ? "" : ", ") << "\"" << Name((ListOp)op) << "\": {\"calls\": " << calls[op]
+						<< ", \"nodes_visited\": " << visited[op] << "}";
+					first = false;
+				}
+			}
+			out << "}}" << endl;
+		}
+	};
+
+	// Returns the name an operation is printed under.
+	static const char* Name(ListOp op) {
+		static const char* const names[(int)ListOp::Count] = { "AddHead", "AddTail", "InsertBefore",
+			"InsertAfter", "InsertAt", "Find", "FindAll", "GetNode", "RemoveHead", "RemoveTail", "Remove",
+			"RemoveAt", "Clear", "Copy", "Compare", "Print", "Apply" };
+		return names[(int)op];
+	}
+
+	ListStats() {
+		counters = Snapshot();
+	}
+
+	// Copies do not inherit the counters of the list they were copied from.
+	ListStats(const ListStats&) : ListStats() {}
+	ListStats& operator=(const ListStats&) {
+		return *this;
+	}
+
+	// Returns a copy of the counters.
+	Snapshot Statistics() const {
+		return counters;
+	}
+
+	// Sets every counter to zero except the current size and bytes, which stay accurate.
+	void ResetStatistics() {
+		unsigned long long size = counters.size;
+		unsigned long long bytesLive = counters.bytesLive;
+		counters = Snapshot();
+		counters.size = size;
+		counters.peakSize = size;
+		counters.bytesLive = bytesLive;
+	}
+
+
+	protected:
+
+	// Counts calls of an operation; bulk operations count one per element in a single call.
+	void StatsCall(ListOp op, unsigned int calls = 1) const {
+		counters.calls[(int)op] += calls;
+	}
+
+	// Counts Nodes an operation walked over.
+	void StatsVisit(ListOp op, unsigned int nodes) const {
+		counters.visited[(int)op] += nodes;
+	}
+
+	// Counts a Node of the given size added to the list.
+	void StatsAllocate(size_t bytes) const {
+		counters.allocations++;
+		counters.bytesAllocated += bytes;
+		counters.bytesLive += bytes;
+		if (++counters.size > counters.peakSize) {
+			counters.peakSize = counters.size;
+		}
+	}
+
+	// Counts Nodes of the given size deleted from the list.
+	void StatsRelease(size_t bytes, unsigned int nodes = 1) const {
+		counters.releases += nodes;
+		counters.bytesLive -= bytes * nodes;
+		counters.size -= nodes;
+	}
+
+
+	private:
+
+	// mutable so that const operations such as Find and GetNode are counted too
+	mutable Snapshot counters;
+};
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// Where a LinkedList gets the memory for its Nodes. The storage tag picks the allocator:
+//	Nodes		NodeHeap, one operator new per Node
+//	Arena		NodePool, Nodes carved out of heap blocks the list owns
+//	HugePages	NodePool with blocks of 2 MB pages, optionally NUMA placed (see HugePages.h)
+// All hand out raw memory for one Node; the LinkedList constructs and destroys the Node in it.
+// releasesAll tells the LinkedList that Reset gives back every Node at once, so a Clear only has
+// to visit Nodes whose data has a destructor to run.
+
+// Inlines a function even when not optimizing. NodeHeap's allocations go through it so that a tool
+// naming allocations by the address operator new returns to (such as leaker) sees the LinkedList
+// operation that added the Node, not NodeHeap::Allocate.
+#if defined(__GNUC__) || defined(__clang__)
+#define NODEPOOL_ALWAYS_INLINE __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define NODEPOOL_ALWAYS_INLINE __forceinline
+#else
+#define NODEPOOL_ALWAYS_INLINE
+#endif
+
+// Allocates every Node separately from the heap.
+template<typename Node>
+class NodeHeap {
+
+	public:
+
+	static const bool releasesAll = false;
+
+	// Returns memory for one Node; always inlined into the caller (see NODEPOOL_ALWAYS_INLINE).
+	NODEPOOL_ALWAYS_INLINE void* Allocate() {
+		return ::operator new(sizeof(Node));
+	}
+
+	// Frees the memory of one Node.
+	void Release(void* node) {
+		::operator delete(node);
+	}
+
+	// Nothing to do: every Node is allocated on its own.
+	void Reserve(size_t) {
+	}
+
+	// Nothing to do: every Node was released on its own.
+	void Reset() {
+	}
+
+	// Returns the number of blocks held, always 0.
+	size_t Blocks() const {
+		return 0;
+	}
+};
+
+// Blocks for a NodePool from the heap. A block source may provide more than asked for.
+class HeapBlocks {
+
+	public:
+
+	// Returns a block of at least bytes; bytes is set to the size actually provided.
+	void* AllocateBlock(size_t& bytes) {
+		return ::operator new(bytes);
+	}
+
+	// Frees a block returned by AllocateBlock.
+	void ReleaseBlock(void* block, size_t) {
+		::operator delete(block);
+	}
+};
+
+// Allocates Nodes from blocks owned by one LinkedList, taken from a block Source. Blocks start at
+// 16 Nodes and double up to 65536 (or whatever larger size the Source rounds them to), so short
+// lists stay small and long ones make few allocations. Released Nodes go on a free list for reuse;
+// Reset frees every block without looking at the Nodes in them. The Source's own members (e.g.
+// HugePageBlocks::SetPlacement) are available on the pool.
+template<typename Node, typename Source = HeapBlocks>
+class NodePool : public Source {
+
+	// a free Slot holds the link to the next free one
+	union Slot {
+		Slot* nextFree;
+		alignas(Node) unsigned char bytes[sizeof(Node)];
+	};
+
+	// data members of the NodePool class
+	vector<pair<Slot*, size_t>> blocks;	// every block allocated and its bytes, newest last
+	Slot* freeSlots;			// released Slots, most recent first
+	unsigned int used;			// Slots handed out of the newest block
+	unsigned int blockSlots;	// number of Slots in the newest block
+
+	static const unsigned int firstBlockSlots = 16;
+	static const unsigned int maxBlockSlots = 1 << 16;
+
+
+	public:
+
+	static const bool releasesAll = true;
+
+	/* ---------- CONSTRUCTION / DESTRUCTION ---------- */
+
+	// Constructor
+	// No block is allocated until the first Node.
+	NodePool() {
+		freeSlots = nullptr;
+		used = 0;
+		blockSlots = 0;
+	}
+
+	// Nodes belong to one list, so a pool cannot be copied, only handed over
+	NodePool(const NodePool&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+
+	NodePool(NodePool&& other) noexcept : Source(other) {
+		blocks.swap(other.blocks);
+		freeSlots = other.freeSlots;
+		used = other.used;
+		blockSlots = other.blockSlots;
+		other.freeSlots = nullptr;
+		other.used = 0;
+		other.blockSlots = 0;
+	}
+
+	// Destructor
+	// Frees every block.
+	~NodePool() {
+		Reset();
+	}
+
+
+	/* ---------- BEHAVIORS ---------- */
+
+	// Returns memory for one Node, reusing a released one if there is any.
+	void* Allocate() {
+		if (freeSlots != nullptr) {
+			Slot* slot = freeSlots;
+			freeSlots = slot->nextFree;
+			return slot;
+		}
+		if (used == blockSlots) {
+			AddBlock(NextBlockSlots(1));
+		}
+		return &blocks.back().first[used++];
+	}
+
+	// Makes sure the next count Allocates come from released Nodes or one block, allocating a block
+	// large enough for the rest if needed. The block is at least the size growth would pick next,
+	// so many small reservations still make few, growing blocks.
+	void Reserve(size_t count) {
+		size_t available = blockSlots - used;
+		for (Slot* slot = freeSlots; slot != nullptr && available < count; slot = slot->nextFree) {
+			available++;
+		}
+		if (available >= count) {
+			return;
+		}
+		// the rest of the current block goes on the free list so it is not lost
+		for (unsigned int i = used; i < blockSlots; i++) {
+			Release(&blocks.back().first[i]);
+		}
+		used = blockSlots;
+		AddBlock(NextBlockSlots(count - available));
+	}
+
+	// Keeps the memory of one Node for reuse.
+	void Release(void* node) {
+		Slot* slot = static_cast<Slot*>(node);
+		slot->nextFree = freeSlots;
+		freeSlots = slot;
+	}
+
+	// Frees every block, and with them every Node.
+	void Reset() {
+		for (const pair<Slot*, size_t>& block : blocks) {
+			this->ReleaseBlock(block.first, block.second);
+		}
+		blocks.clear();
+		freeSlots = nullptr;
+		used = 0;
+		blockSlots = 0;
+	}
+
+
+	/* ---------- ACCESSORS ---------- */
+
+	// Returns the number of blocks held.
+	size_t Blocks() const {
+		return blocks.size();
+	}
+
+
+	private:
+
+	/* ---------- Helper Functions ---------- */
+
+	// Returns the number of Slots for the next block: twice the newest block up to maxBlockSlots,
+	// never fewer than the newest, and at least needed.
+	size_t NextBlockSlots(size_t needed) const {
+		size_t slots = firstBlockSlots;
+		if (!blocks.empty()) {
+			slots = blockSlots < maxBlockSlots ? (size_t)blockSlots * 2 : blockSlots;
+		}
+		return slots < needed ? needed : slots;
+	}
+
+	// Allocates a block of at least slots Slots and hands out Slots from it next.
+	void AddBlock(size_t slots) {
+		size_t bytes = slots * sizeof(Slot);
+		blocks.reserve(blocks.size() + 1);	// so push_back cannot throw and lose the block
+		Slot* block = static_cast<Slot*>(this->AllocateBlock(bytes));
+		blocks.push_back(make_pair(block, bytes));
+		blockSlots = (unsigned int)(bytes / sizeof(Slot));
+		used = 0;
+	}
+};
+
+#endif
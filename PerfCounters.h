@@ -0,0 +1,243 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <iostream>
+#include <string>
+using namespace std;
+
+// Hardware performance counters per group of LinkedList operations, read with perf_event_open.
+// Only built when LINKEDLIST_PERF is defined (and only on Linux); otherwise the scopes placed in
+// LinkedList compile to nothing and Report/Reset are empty.
+//
+// Counters are per thread and count user space only. Each operation reads the counter group on
+// entry and exit (two read() system calls), so the figures describe the operation plus that
+// fixed cost; compare them between sizes or element types rather than taking them as absolute.
+// Operations called from other operations (e.g. InsertAt calling AddTail) count only once, in
+// the outermost group. Needs kernel.perf_event_paranoid <= 2 and a machine or VM that exposes
+// the PMU; events the kernel refuses are reported as n/a.
+
+// Groups of operations counters are kept for.
+enum class PerfGroup {
+	Insert,		// AddHead, AddTail, AddNodes*, Insert*, Batch::Apply
+	Search,		// Find, FindAll, GetNode, operator[]
+	Remove,		// Remove*, Clear
+	Traverse,	// Print*, operator==, copying
+	Count
+};
+
+#if defined(LINKEDLIST_PERF) && defined(__linux__)
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+class PerfCounters {
+
+	public:
+
+	static const int events = 6;
+
+	private:
+
+	// cumulative counts for one PerfGroup
+	struct Totals {
+		unsigned long long calls;
+		unsigned long long values[events];
+	};
+
+	int fds[events];				// one file descriptor per event, -1 if not available
+	int slots[events];				// position of each event in a group read, -1 if not available
+	int opened;						// number of events in the group
+	int error;						// errno from opening the group leader, 0 if it opened
+	int depth;						// PerfScopes currently open on this thread
+	Totals totals[(int)PerfGroup::Count];
+
+	// Opens every event in one group led by the first that opens, and starts counting.
+	PerfCounters() {
+		const unsigned long long cache[] = {
+			PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+			PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+			PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+		};
+		const unsigned int types[events] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+			PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE };
+		const unsigned long long configs[events] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+			cache[0], cache[1], cache[2], PERF_COUNT_HW_BRANCH_MISSES };
+
+		opened = 0;
+		error = 0;
+		depth = 0;
+		Reset();
+		int leader = -1;
+		for (int e = 0; e < events; e++) {
+			perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = types[e];
+			attr.config = configs[e];
+			attr.read_format = PERF_FORMAT_GROUP;
+			attr.disabled = leader == -1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			fds[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+			slots[e] = fds[e] >= 0 ? opened++ : -1;
+			if (fds[e] >= 0 && leader == -1) {
+				leader = fds[e];
+			}
+			else if (fds[e] < 0 && leader == -1 && error == 0) {
+				error = errno;
+			}
+		}
+		if (leader != -1) {
+			error = 0;
+			ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+			ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		}
+	}
+
+	~PerfCounters() {
+		for (int e = 0; e < events; e++) {
+			if (fds[e] >= 0) {
+				close(fds[e]);
+			}
+		}
+	}
+
+	// Returns the file descriptor of the group leader, or -1 when nothing could be opened.
+	int Leader() const {
+		for (int e = 0; e < events; e++) {
+			if (fds[e] >= 0) {
+				return fds[e];
+			}
+		}
+		return -1;
+	}
+
+
+	public:
+
+	// Returns this thread's counters, opening them on first use.
+	static PerfCounters& Instance() {
+		static thread_local PerfCounters counters;
+		return counters;
+	}
+
+	// Marks the start of an operation; returns true if it is the outermost one.
+	bool Enter() {
+		return depth++ == 0 && opened > 0;
+	}
+
+	// Marks the end of an operation.
+	void Leave() {
+		depth--;
+	}
+
+	// Reads the current value of every event; events that are not available read as 0.
+	void Read(unsigned long long* values) const {
+		unsigned long long buffer[events + 1] = { 0 };
+		if (read(Leader(), buffer, sizeof(buffer)) < (ssize_t)sizeof(unsigned long long)) {
+			buffer[0] = 0;
+		}
+		for (int e = 0; e < events; e++) {
+			values[e] = slots[e] >= 0 && (unsigned long long)slots[e] < buffer[0] ? buffer[slots[e] + 1] : 0;
+		}
+	}
+
+	// Adds the difference between two reads to a group's totals.
+	void Add(PerfGroup group, const unsigned long long* start, const unsigned long long* stop) {
+		Totals& total = totals[(int)group];
+		total.calls++;
+		for (int e = 0; e < events; e++) {
+			total.values[e] += stop[e] - start[e];
+		}
+	}
+
+	// Clears the totals of every group.
+	void Reset() {
+		memset(totals, 0, sizeof(totals));
+	}
+
+	// Prints the average of each event per operation for every group that was used.
+	void Report(ostream& out, const string& indent = "") const {
+		const char* names[(int)PerfGroup::Count] = { "insert", "search", "remove", "traverse" };
+		if (opened == 0) {
+			out << indent << "hardware counters unavailable: " << strerror(error) << endl;
+			return;
+		}
+		out << indent << left << setw(10) << "group" << setw(12) << "calls" << setw(14) << "cycles/op"
+			<< setw(14) << "instr/op" << setw(14) << "L1D miss/op" << setw(14) << "LLC miss/op"
+			<< setw(14) << "dTLB miss/op" << "branch miss/op" << endl;
+		for (int g = 0; g < (int)PerfGroup::Count; g++) {
+			const Totals& total = totals[g];
+			if (total.calls == 0) {
+				continue;
+			}
+			out << indent << left << setw(10) << names[g] << setw(12) << total.calls << fixed << setprecision(1);
+			for (int e = 0; e < events; e++) {
+				out << setw(e == events - 1 ? 0 : 14);
+				if (fds[e] >= 0) {
+					out << (double)total.values[e] / total.calls;
+				}
+				else {
+					out << "n/a";
+				}
+			}
+			out << endl;
+		}
+	}
+};
+
+// Counts the enclosing LinkedList operation into a PerfGroup.
+class PerfScope {
+	PerfGroup group;
+	bool outer;
+	unsigned long long start[PerfCounters::events];
+
+	public:
+
+	explicit PerfScope(PerfGroup perfGroup) {
+		group = perfGroup;
+		outer = PerfCounters::Instance().Enter();
+		if (outer) {
+			PerfCounters::Instance().Read(start);
+		}
+	}
+
+	~PerfScope() {
+		PerfCounters& counters = PerfCounters::Instance();
+		if (outer) {
+			unsigned long long stop[PerfCounters::events];
+			counters.Read(stop);
+			counters.Add(group, start, stop);
+		}
+		counters.Leave();
+	}
+
+	PerfScope(const PerfScope&) = delete;
+	PerfScope& operator=(const PerfScope&) = delete;
+};
+
+#define LINKEDLIST_PERF_SCOPE(group) PerfScope perfScope(PerfGroup::group)
+
+#else
+
+// Stand-in with the same interface that does nothing.
+class PerfCounters {
+	public:
+	static PerfCounters& Instance() {
+		static PerfCounters counters;
+		return counters;
+	}
+	void Reset() {}
+	void Report(ostream&, const string& = "") const {}
+};
+
+#define LINKEDLIST_PERF_SCOPE(group)
+
+#endif
+
+#endif
@@ -0,0 +1,467 @@
+#ifndef RCULIST_H
+#define RCULIST_H
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+// Tracks which threads are inside RCU read-side sections and when retired memory may be freed.
+// A reader announces the epoch it started in on its own cache line; a writer frees a Node only
+// once every reader that could still hold it has left (an epoch-based grace period).
+//
+// On Linux the expedited membarrier system call lets writers pay for the memory barrier that
+// readers would otherwise need, so entering a read section is a plain store and leaving it is
+// another. Elsewhere readers fall back to a full fence.
+class RcuDomain {
+
+	public:
+
+	static const unsigned int maxReaders = 512;		// threads that can read at the same time
+
+	private:
+
+	struct alignas(64) Slot {
+		atomic<unsigned long long> epoch;	// epoch the reader entered in, 0 when not reading
+		atomic<bool> claimed;				// owned by a live thread
+	};
+
+	// returns its Slot to the domain when a thread exits
+	struct ThreadSlot {
+		Slot* slot = nullptr;
+		unsigned int depth = 0;			// nesting of read sections on this thread
+
+		~ThreadSlot() {
+			if (slot != nullptr) {
+				slot->epoch.store(0, memory_order_release);
+				slot->claimed.store(false, memory_order_release);
+			}
+		}
+	};
+
+	Slot slots[maxReaders];
+	atomic<unsigned long long> epoch;	// current global epoch, starts at 1
+	bool asymmetric;					// membarrier is available
+
+	RcuDomain() : epoch(1), asymmetric(false) {
+		for (unsigned int i = 0; i < maxReaders; i++) {
+			slots[i].epoch.store(0, memory_order_relaxed);
+			slots[i].claimed.store(false, memory_order_relaxed);
+		}
+#if defined(__linux__) && defined(MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+		asymmetric = syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#endif
+	}
+
+	// Claims a free Slot for the calling thread the first time it reads.
+	ThreadSlot& Current() {
+		static thread_local ThreadSlot current;
+		if (current.slot == nullptr) {
+			for (unsigned int i = 0; current.slot == nullptr; i = (i + 1) % maxReaders) {
+				bool expected = false;
+				if (!slots[i].claimed.load(memory_order_relaxed)
+					&& slots[i].claimed.compare_exchange_strong(expected, true, memory_order_acquire)) {
+					current.slot = &slots[i];
+				}
+				if (i == maxReaders - 1) {
+					this_thread::yield();
+				}
+			}
+		}
+		return current;
+	}
+
+	// Orders the writer's unlinking stores before its reads of the reader slots.
+	void WriterBarrier() {
+#if defined(__linux__) && defined(MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+		if (asymmetric) {
+			syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+			return;
+		}
+#endif
+		atomic_thread_fence(memory_order_seq_cst);
+	}
+
+
+	public:
+
+	// the domain shared by every RcuList in the process
+	static RcuDomain& Instance() {
+		static RcuDomain domain;
+		return domain;
+	}
+
+	// Enters a read section. Sections nest.
+	void ReadLock() {
+		ThreadSlot& current = Current();
+		if (current.depth++ == 0) {
+			current.slot->epoch.store(epoch.load(memory_order_acquire), memory_order_relaxed);
+			if (asymmetric) {
+				atomic_signal_fence(memory_order_seq_cst);
+			}
+			else {
+				atomic_thread_fence(memory_order_seq_cst);
+			}
+		}
+	}
+
+	// Leaves a read section.
+	void ReadUnlock() {
+		ThreadSlot& current = Current();
+		if (--current.depth == 0) {
+			current.slot->epoch.store(0, memory_order_release);
+		}
+	}
+
+	// Starts a new epoch and returns the one retired memory belongs to.
+	unsigned long long Advance() {
+		return epoch.fetch_add(1, memory_order_seq_cst);
+	}
+
+	// Returns the oldest epoch any reader is still in, or the current epoch if nobody is reading.
+	// Memory retired in an earlier epoch can no longer be reached by any reader.
+	unsigned long long OldestReader() {
+		WriterBarrier();
+		unsigned long long oldest = epoch.load(memory_order_acquire);
+		for (unsigned int i = 0; i < maxReaders; i++) {
+			unsigned long long reader = slots[i].epoch.load(memory_order_acquire);
+			if (reader != 0 && reader < oldest) {
+				oldest = reader;
+			}
+		}
+		return oldest;
+	}
+
+	// Waits until every reader that entered before this call has left.
+	void Synchronize() {
+		unsigned long long retiredIn = Advance();
+		while (OldestReader() <= retiredIn) {
+			this_thread::yield();
+		}
+	}
+};
+
+// A read-mostly list using read-copy-update.
+// Readers walk the list inside a read section with nothing more than pointer loads, so read
+// throughput scales with cores. Writers are serialized by a mutex, build each change off to the
+// side and publish it with a single pointer store. Unlinked Nodes are freed only after a grace period.
+// Data is never modified in place; Replace swaps in a new Node instead.
+template<typename T>
+class RcuList {
+
+	public:
+
+	// a class for the construction of Nodes
+	struct Node {
+
+		// data members of the Node class
+		Node* prev;					// pointer to the previous Node (writers only)
+		atomic<Node*> next;			// pointer to the next Node
+		T data;						// storage for the Node's data, immutable once published
+
+		Node(const T& value) : prev(nullptr), next(nullptr), data(value) {}
+	};
+
+	// Holds a read section open for its lifetime.
+	// Any Node reached while a ReadGuard exists stays valid until the guard is destroyed.
+	class ReadGuard {
+		public:
+		ReadGuard() { RcuDomain::Instance().ReadLock(); }
+		~ReadGuard() { RcuDomain::Instance().ReadUnlock(); }
+		ReadGuard(const ReadGuard&) = delete;
+		ReadGuard& operator=(const ReadGuard&) = delete;
+	};
+
+	private:
+
+	// data members of the RcuList class
+	atomic<Node*> head;				// pointer to the head of the list
+	Node* tail;						// pointer to the tail of the list (writers only)
+	atomic<unsigned int> size;		// number of Nodes currently in the list
+	mutex writeLock;				// serializes writers
+	vector<pair<unsigned long long, Node*>> retired;	// unlinked Nodes and the epoch they left in
+
+
+	public:
+
+	/* ---------- CONSTRUCTION / DESTRUCTION ---------- */
+
+	// Constructor
+	// Creates an empty list.
+	RcuList() : head(nullptr), tail(nullptr), size(0) {}
+
+	// the list is shared by address between threads, so it cannot be copied
+	RcuList(const RcuList&) = delete;
+	RcuList& operator=(const RcuList&) = delete;
+
+	// Destructor
+	// Deletes all Nodes. No thread may still be using the list.
+	~RcuList() {
+		Node* current = head.load(memory_order_relaxed);
+		while (current != nullptr) {
+			Node* queued = current->next.load(memory_order_relaxed);
+			delete current;
+			current = queued;
+		}
+		for (pair<unsigned long long, Node*>& entry : retired) {
+			delete entry.second;
+		}
+	}
+
+
+	private:
+
+	/* ---------- Helper Functions ---------- */
+
+	// Returns the Node at the specified index. The caller holds the write lock.
+	Node* NodeAt(unsigned int index) const {
+		Node* current = head.load(memory_order_relaxed);
+		for (unsigned int i = 0; i < index; i++) {
+			current = current->next.load(memory_order_relaxed);
+		}
+		return current;
+	}
+
+	// Publishes a new Node between before and after (either may be nullptr). The caller holds the write lock.
+	void Publish(Node* before, Node* newNode, Node* after) {
+		newNode->prev = before;
+		newNode->next.store(after, memory_order_relaxed);
+		if (after != nullptr) {
+			after->prev = newNode;
+		}
+		else {
+			tail = newNode;
+		}
+		if (before != nullptr) {
+			before->next.store(newNode, memory_order_release);
+		}
+		else {
+			head.store(newNode, memory_order_release);
+		}
+		size.fetch_add(1, memory_order_relaxed);
+	}
+
+	// Unlinks a Node and retires it. Readers already on it can still follow its next pointer.
+	void Unpublish(Node* node) {
+		Node* after = node->next.load(memory_order_relaxed);
+		if (node->prev != nullptr) {
+			node->prev->next.store(after, memory_order_release);
+		}
+		else {
+			head.store(after, memory_order_release);
+		}
+		if (after != nullptr) {
+			after->prev = node->prev;
+		}
+		else {
+			tail = node->prev;
+		}
+		size.fetch_sub(1, memory_order_relaxed);
+		retired.push_back(make_pair(RcuDomain::Instance().Advance(), node));
+	}
+
+	// Frees retired Nodes whose grace period has passed. The caller holds the write lock.
+	void Collect() {
+		if (retired.empty()) {
+			return;
+		}
+		unsigned long long oldest = RcuDomain::Instance().OldestReader();
+		size_t kept = 0;
+		for (size_t i = 0; i < retired.size(); i++) {
+			if (retired[i].first < oldest) {
+				delete retired[i].second;
+			}
+			else {
+				retired[kept++] = retired[i];
+			}
+		}
+		retired.resize(kept);
+	}
+
+
+	public:
+
+	/* ---------- READERS ---------- */
+
+	// Returns the number of Nodes in the list.
+	unsigned int NodeCount() const {
+		return size.load(memory_order_relaxed);
+	}
+
+	// Returns a pointer to the head of the list, or nullptr.
+	// The caller must hold a ReadGuard for as long as it uses the Node.
+	const Node* Head() const {
+		return head.load(memory_order_acquire);
+	}
+
+	// Returns a pointer to the first Node with the specified data, or nullptr.
+	// The caller must hold a ReadGuard for as long as it uses the Node.
+	const Node* Find(const T& data) const {
+		const Node* current = head.load(memory_order_acquire);
+		while (current != nullptr && !(current->data == data)) {
+			current = current->next.load(memory_order_acquire);
+		}
+		return current;
+	}
+
+	// Returns whether any Node holds the specified data.
+	bool Contains(const T& data) const {
+		ReadGuard guard;
+		return Find(data) != nullptr;
+	}
+
+	// Copies the data of the Node at the specified index into outData.
+	// Returns false if the list is shorter than that.
+	bool GetAt(unsigned int index, T& outData) const {
+		ReadGuard guard;
+		const Node* current = head.load(memory_order_acquire);
+		for (unsigned int i = 0; i < index && current != nullptr; i++) {
+			current = current->next.load(memory_order_acquire);
+		}
+		if (current == nullptr) {
+			return false;
+		}
+		outData = current->data;
+		return true;
+	}
+
+	// Calls visit with the data of every Node, head to tail, inside one read section.
+	template<typename Function>
+	void ForEach(Function visit) const {
+		ReadGuard guard;
+		const Node* current = head.load(memory_order_acquire);
+		while (current != nullptr) {
+			visit(current->data);
+			current = current->next.load(memory_order_acquire);
+		}
+	}
+
+
+	/* ---------- WRITERS ---------- */
+
+	// Publishes a new Node at the beginning of the list.
+	void AddHead(const T& data) {
+		lock_guard<mutex> guard(writeLock);
+		Publish(nullptr, new Node(data), head.load(memory_order_relaxed));
+	}
+
+	// Publishes a new Node at the end of the list.
+	void AddTail(const T& data) {
+		lock_guard<mutex> guard(writeLock);
+		Publish(tail, new Node(data), nullptr);
+	}
+
+	// Publishes a new Node containing the specified data at the specified index.
+	// Throws an out_of_range exception if passed-in index is not valid.
+	void InsertAt(const T& data, unsigned int index) {
+		lock_guard<mutex> guard(writeLock);
+		if (index > size.load(memory_order_relaxed)) {
+			throw out_of_range("");
+		}
+		Node* after = index == size.load(memory_order_relaxed) ? nullptr : NodeAt(index);
+		Node* before = after == nullptr ? tail : after->prev;
+		Publish(before, new Node(data), after);
+	}
+
+	// Replaces the data at the specified index by publishing a copy-updated Node in its place.
+	// Returns false if there is no Node at that index.
+	bool Replace(unsigned int index, const T& data) {
+		lock_guard<mutex> guard(writeLock);
+		if (index >= size.load(memory_order_relaxed)) {
+			return false;
+		}
+		Node* old = NodeAt(index);
+		Node* newNode = new Node(data);
+		newNode->prev = old->prev;
+		newNode->next.store(old->next.load(memory_order_relaxed), memory_order_relaxed);
+		if (newNode->next.load(memory_order_relaxed) != nullptr) {
+			newNode->next.load(memory_order_relaxed)->prev = newNode;
+		}
+		else {
+			tail = newNode;
+		}
+		if (old->prev != nullptr) {
+			old->prev->next.store(newNode, memory_order_release);
+		}
+		else {
+			head.store(newNode, memory_order_release);
+		}
+		retired.push_back(make_pair(RcuDomain::Instance().Advance(), old));
+		Collect();
+		return true;
+	}
+
+	// Removes the first Node in the list.
+	// Returns true if removal is successful and false if the list is empty.
+	bool RemoveHead() {
+		return RemoveAt(0);
+	}
+
+	// Removes the last Node in the list.
+	// Returns true if removal is successful and false if the list is empty.
+	bool RemoveTail() {
+		lock_guard<mutex> guard(writeLock);
+		if (tail == nullptr) {
+			return false;
+		}
+		Unpublish(tail);
+		Collect();
+		return true;
+	}
+
+	// Removes the Node at the specified index.
+	// Returns true if removal is successful and false if there is no such Node.
+	bool RemoveAt(unsigned int index) {
+		lock_guard<mutex> guard(writeLock);
+		if (index >= size.load(memory_order_relaxed)) {
+			return false;
+		}
+		Unpublish(NodeAt(index));
+		Collect();
+		return true;
+	}
+
+	// Removes all Nodes containing the specified data.
+	// Returns the number of Nodes removed.
+	unsigned int Remove(const T& data) {
+		lock_guard<mutex> guard(writeLock);
+		unsigned int numRemoved = 0;
+		Node* current = head.load(memory_order_relaxed);
+		while (current != nullptr) {
+			Node* queued = current->next.load(memory_order_relaxed);
+			if (current->data == data) {
+				Unpublish(current);
+				numRemoved++;
+			}
+			current = queued;
+		}
+		Collect();
+		return numRemoved;
+	}
+
+	// Removes all Nodes from the list.
+	void Clear() {
+		lock_guard<mutex> guard(writeLock);
+		while (tail != nullptr) {
+			Unpublish(tail);
+		}
+		Collect();
+	}
+
+	// Waits for a grace period and frees every retired Node.
+	void Reclaim() {
+		lock_guard<mutex> guard(writeLock);
+		RcuDomain::Instance().Synchronize();
+		Collect();
+	}
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef RECLAIMER_H
+#define RECLAIMER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+using namespace std;
+
+// A background thread that frees memory handed to it, so a thread that drops a large LinkedList
+// does not spend the time deleting it. Jobs run one at a time in the order they were submitted.
+// The thread starts with the first use and is joined, after running every job still queued, when
+// the program exits; lists with static storage duration should therefore not defer their Clear.
+class Reclaimer {
+
+	// data members of the Reclaimer class
+	mutex lock;							// guards everything below
+	condition_variable wake;			// signalled when a job is submitted or the thread must stop
+	condition_variable idle;			// signalled when the queue has run dry
+	deque<function<void()>> jobs;		// submitted jobs not yet started
+	unsigned int running;				// 1 while the thread is running a job
+	bool stopping;						// set when the program exits
+	thread worker;
+
+	// Constructor
+	// Starts the background thread.
+	Reclaimer() {
+		running = 0;
+		stopping = false;
+		worker = thread(&Reclaimer::Run, this);
+	}
+
+	// Runs jobs until told to stop and nothing is left.
+	void Run() {
+		unique_lock<mutex> guard(lock);
+		for (;;) {
+			wake.wait(guard, [this]() { return stopping || !jobs.empty(); });
+			if (jobs.empty()) {
+				return;
+			}
+			function<void()> job = std::move(jobs.front());
+			jobs.pop_front();
+			running = 1;
+			guard.unlock();
+			job();
+			job = nullptr;
+			guard.lock();
+			running = 0;
+			if (jobs.empty()) {
+				idle.notify_all();
+			}
+		}
+	}
+
+
+	public:
+
+	// Returns the process-wide Reclaimer.
+	static Reclaimer& Instance() {
+		static Reclaimer reclaimer;
+		return reclaimer;
+	}
+
+	Reclaimer(const Reclaimer&) = delete;
+	Reclaimer& operator=(const Reclaimer&) = delete;
+
+	// Destructor
+	// Runs the remaining jobs and joins the thread.
+	~Reclaimer() {
+		{
+			lock_guard<mutex> guard(lock);
+			stopping = true;
+		}
+		wake.notify_one();
+		worker.join();
+	}
+
+	// Queues a job for the background thread.
+	void Submit(function<void()> job) {
+		{
+			lock_guard<mutex> guard(lock);
+			jobs.push_back(std::move(job));
+		}
+		wake.notify_one();
+	}
+
+	// Waits until every job submitted so far has run.
+	void Drain() {
+		unique_lock<mutex> guard(lock);
+		idle.wait(guard, [this]() { return jobs.empty() && running == 0; });
+	}
+
+	// Returns the number of jobs queued or running.
+	// Only a snapshot: other threads may submit more before the caller looks at the result.
+	unsigned int Pending() {
+		lock_guard<mutex> guard(lock);
+		return (unsigned int)jobs.size() + running;
+	}
+};
+
+#endif
@@ -0,0 +1,324 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include "LinkedList.h"
+
+// A LinkedList stored in a growable ring buffer.
+// Only the head/tail subset of the LinkedList interface is available, so a queue or stack
+// built on LinkedList<T> switches storage by becoming LinkedList<T, Ring>.
+template<typename T>
+class LinkedList<T, Ring> {
+
+	public:
+
+	// elements live in contiguous slots, so a Node only carries the data
+	// Head()->data and Tail()->data work the same as they do for the Node-based LinkedList
+	struct Node {
+		T data;				// storage for the Node's data
+	};
+
+	private:
+
+	// the largest power of two an unsigned int holds, and so the most Nodes the buffer can hold
+	static const unsigned int maxCapacity = 0x80000000u;
+
+	// data members of the ring buffer
+	Node* slots;				// storage for capacity Nodes, capacity is a power of two
+	unsigned int capacity;		// number of slots allocated
+	unsigned int first;			// index of the slot holding the head
+	unsigned int size;			// number of Nodes currently in the LinkedList
+
+
+	public:
+
+	/* ---------- CONSTRUCTION / DESTRUCTION ---------- */
+
+	// Constructor
+	// Creates an empty LinkedList; no slots are allocated until the first insertion.
+	LinkedList() {
+		slots = nullptr;
+		capacity = 0;
+		first = 0;
+		size = 0;
+	}
+
+	// Copy Constructor
+	// Creates a new LinkedList holding a copy of each Node from the other LinkedList.
+	LinkedList(const LinkedList& otherList) {
+		slots = nullptr;
+		capacity = 0;
+		first = 0;
+		size = 0;
+		Clone(otherList);
+	}
+
+	// Destructor
+	// Releases all slots.
+	~LinkedList() {
+		delete[] slots;
+		slots = nullptr;
+		capacity = 0;
+		size = 0;
+	}
+
+
+	/* ---------- OPERATORS ---------- */
+
+	// Returns the data from the Node at the specified index (0 is the head).
+	// Throws an out_of_range error if no such Node exists.
+	T& operator[](unsigned int index) {
+		return GetNode(index)->data;
+	}
+
+	// Returns a constant version of the data from the Node at the specified index.
+	// Throws an out_of_range error if no such Node exists.
+	const T& operator[](unsigned int index) const {
+		return GetNode(index)->data;
+	}
+
+	// Determines whether two LinkedLists are exactly equal.
+	bool operator==(const LinkedList& rhs) const {
+		if (size != rhs.size) {
+			return false;
+		}
+		for (unsigned int i = 0; i < size; i++) {
+			if (Slot(i).data != rhs.Slot(i).data) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Replaces the contents of this LinkedList with a copy of another.
+	LinkedList& operator=(const LinkedList& rhs) {
+		if (this != &rhs) {
+			Clear();
+			Clone(rhs);
+		}
+		return *this;
+	}
+
+
+	private:
+
+	/* ---------- Helper Functions ---------- */
+
+	// Returns the slot holding the Node at the specified index (0 is the head).
+	Node& Slot(unsigned int index) {
+		return slots[(first + index) & (capacity - 1)];
+	}
+
+	const Node& Slot(unsigned int index) const {
+		return slots[(first + index) & (capacity - 1)];
+	}
+
+	// Copies every Node of another LinkedList onto the tail.
+	void Clone(const LinkedList& otherList) {
+		Reserve(otherList.size);
+		for (unsigned int i = 0; i < otherList.size; i++) {
+			AddTail(otherList.Slot(i).data);
+		}
+	}
+
+	// Doubles the capacity once all slots are in use.
+	// Throws length_error if the buffer already has maxCapacity slots.
+	void Grow() {
+		if (size == capacity) {
+			if (capacity == maxCapacity) {
+				throw length_error("");
+			}
+			Reserve(capacity == 0 ? 16 : capacity * 2);
+		}
+	}
+
+	// Returns the number of Nodes after adding count more.
+	// Throws length_error if that is more than the buffer can hold.
+	unsigned int SizeAfter(unsigned int count) const {
+		if (count > maxCapacity - size) {
+			throw length_error("");
+		}
+		return size + count;
+	}
+
+	// Resets a vacated slot so it no longer holds on to resources owned by its data.
+	void Release(Node& node) {
+		if (!is_trivially_destructible<T>::value) {
+			node.data = T();
+		}
+	}
+
+
+	public:
+
+	/* ---------- BEHAVIORS ---------- */
+
+	// Prints all Nodes in the LinkedList from beginning to end.
+	void PrintForward() const {
+		for (unsigned int i = 0; i < size; i++) {
+			cout << Slot(i).data << endl;
+		}
+	}
+
+	// Prints all Nodes in the LinkedList from end to beginning.
+	void PrintReverse() const {
+		for (unsigned int i = size; i > 0; i--) {
+			cout << Slot(i - 1).data << endl;
+		}
+	}
+
+
+	/* ---------- ACCESSORS ---------- */
+
+	// Returns the number of Nodes in the LinkedList.
+	unsigned int NodeCount() const {
+		return size;
+	}
+
+	// Returns the number of Nodes the LinkedList can hold before it has to grow.
+	unsigned int Capacity() const {
+		return capacity;
+	}
+
+	// Returns a pointer to the Node at the specified index.
+	// Throws an out_of_range error if no such Node exists.
+	Node* GetNode(unsigned int index) {
+		if (index >= size) {
+			throw out_of_range("");
+		}
+		return &Slot(index);
+	}
+
+	// Returns a constant pointer to the Node at the specified index.
+	// Throws an out_of_range error if no such Node exists.
+	const Node* GetNode(unsigned int index) const {
+		if (index >= size) {
+			throw out_of_range("");
+		}
+		return &Slot(index);
+	}
+
+	// Returns a pointer to the head of the LinkedList, or nullptr if it is empty.
+	Node* Head() {
+		return size > 0 ? &Slot(0) : nullptr;
+	}
+
+	// Returns a constant pointer to the head of the LinkedList, or nullptr if it is empty.
+	const Node* Head() const {
+		return size > 0 ? &Slot(0) : nullptr;
+	}
+
+	// Returns a pointer to the tail of the LinkedList, or nullptr if it is empty.
+	Node* Tail() {
+		return size > 0 ? &Slot(size - 1) : nullptr;
+	}
+
+	// Returns a constant pointer to the tail of the LinkedList, or nullptr if it is empty.
+	const Node* Tail() const {
+		return size > 0 ? &Slot(size - 1) : nullptr;
+	}
+
+
+	/* ---------- INSERTION ---------- */
+
+	// Makes room for at least count Nodes without further allocation.
+	// Capacity is rounded up to a power of two; it never shrinks.
+	// Throws length_error if count is more than the largest power of two an unsigned int holds.
+	void Reserve(unsigned int count) {
+		if (count <= capacity) {
+			return;
+		}
+		if (count > maxCapacity) {
+			throw length_error("");
+		}
+		unsigned int newCapacity = capacity == 0 ? 16 : capacity;
+		while (newCapacity < count) {
+			newCapacity *= 2;
+		}
+		// owned here until the Nodes are moved in, in case a move throws
+		unique_ptr<Node[]> newSlots(new Node[newCapacity]);
+		for (unsigned int i = 0; i < size; i++) {
+			newSlots[i].data = std::move(Slot(i).data);
+		}
+		delete[] slots;
+		slots = newSlots.release();
+		capacity = newCapacity;
+		first = 0;
+	}
+
+	// Adds data at the beginning of the LinkedList, growing the buffer if it is full.
+	// Throws length_error if it is full at the largest capacity.
+	void AddHead(const T& data) {
+		Grow();
+		first = (first - 1) & (capacity - 1);
+		slots[first].data = data;
+		size++;
+	}
+
+	// Adds data at the end of the LinkedList, growing the buffer if it is full.
+	// Throws length_error if it is full at the largest capacity.
+	void AddTail(const T& data) {
+		Grow();
+		Slot(size).data = data;
+		size++;
+	}
+
+	// Adds an array of data to the head of the LinkedList.
+	// Throws length_error, before adding anything, if the buffer cannot hold them all.
+	void AddNodesHead(const T* data, unsigned int count) {
+		Reserve(SizeAfter(count));
+		for (unsigned int i = count; i > 0; i--) {
+			AddHead(data[i-1]);
+		}
+	}
+
+	// Adds an array of data to the tail of the LinkedList.
+	// Throws length_error, before adding anything, if the buffer cannot hold them all.
+	void AddNodesTail(const T* data, unsigned int count) {
+		Reserve(SizeAfter(count));
+		for (unsigned int i = 0; i < count; i++) {
+			AddTail(data[i]);
+		}
+	}
+
+
+	/* ---------- REMOVAL ---------- */
+
+	// Removes the first Node in the LinkedList.
+	// Returns true if removal is successful and false if the LinkedList is empty.
+	bool RemoveHead() {
+		if (size == 0) {
+			return false;
+		}
+		Release(slots[first]);
+		first = (first + 1) & (capacity - 1);
+		size--;
+		return true;
+	}
+
+	// Removes the last Node in the LinkedList.
+	// Returns true if removal is successful and false if the LinkedList is empty.
+	bool RemoveTail() {
+		if (size == 0) {
+			return false;
+		}
+		Release(Slot(size - 1));
+		size--;
+		return true;
+	}
+
+	// Removes all Nodes from the LinkedList; the slots are kept for reuse.
+	void Clear() {
+		if (is_trivially_destructible<T>::value) {
+			size = 0;
+		}
+		while (size > 0) {
+			RemoveTail();
+		}
+		first = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,462 @@
+#ifndef SERIALIZE_H
+#define SERIALIZE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "LinkedList.h"
+using namespace std;
+
+// Binary saving and loading of LinkedLists, and a read-only view of a saved list mapped straight
+// from its file. Elements must be trivially copyable or std::string.
+//
+// Lists with Nodes, Arena or HugePages storage can be saved and loaded.
+//
+// File layout: a SerialHeader, padding up to dataOffset, then the elements from head to tail:
+//	trivially copyable T	count elements of sizeof(T) bytes
+//	string					count records, each a uint64_t length followed by that many bytes
+// Numbers are stored in the byte order of the machine that wrote them; other machines reject
+// the file rather than misread it. The mmap view needs a POSIX system.
+
+const char serialMagic[8] = { 'L', 'L', 'I', 'S', 'T', 'B', 'I', 'N' };
+const uint32_t serialVersion = 1;
+const uint32_t serialByteOrder = 0x01020304;
+const size_t serialBufferBytes = 1 << 20;	// bytes written or read at a time
+
+// How the elements after the header are stored.
+enum class SerialKind : uint32_t {
+	Fixed = 1,		// sizeof(T) bytes each
+	Strings = 2		// length-prefixed
+};
+
+struct SerialHeader {
+	char magic[8];			// serialMagic
+	uint32_t version;		// serialVersion
+	uint32_t byteOrder;		// serialByteOrder as written
+	uint32_t kind;			// SerialKind
+	uint32_t alignment;		// alignof(T), 1 for strings
+	uint64_t elementSize;	// sizeof(T), 0 for strings
+	uint64_t count;			// number of elements
+	uint64_t dataOffset;	// bytes from the start of the file to the first element
+};
+
+// Describes how T is stored; data starts on a 64-byte boundary or T's alignment if larger.
+template<typename T>
+SerialHeader MakeSerialHeader(uint64_t count) {
+	static_assert(is_trivially_copyable<T>::value || is_same<T, string>::value,
+		"LinkedList serialization needs trivially copyable elements or std::string");
+	SerialHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, serialMagic, sizeof(serialMagic));
+	header.version = serialVersion;
+	header.byteOrder = serialByteOrder;
+	header.count = count;
+	if (is_same<T, string>::value) {
+		header.kind = (uint32_t)SerialKind::Strings;
+		header.alignment = 1;
+		header.elementSize = 0;
+	}
+	else {
+		header.kind = (uint32_t)SerialKind::Fixed;
+		header.alignment = alignof(T);
+		header.elementSize = sizeof(T);
+	}
+	uint64_t boundary = header.alignment > 64 ? header.alignment : 64;
+	header.dataOffset = (sizeof(SerialHeader) + boundary - 1) / boundary * boundary;
+	return header;
+}
+
+// Returns true if header was written by this build for elements of type T.
+template<typename T>
+bool CheckSerialHeader(const SerialHeader& header) {
+	SerialHeader expected = MakeSerialHeader<T>(header.count);
+	return memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0
+		&& header.version == expected.version && header.byteOrder == expected.byteOrder
+		&& header.kind == expected.kind && header.alignment == expected.alignment
+		&& header.elementSize == expected.elementSize && header.dataOffset == expected.dataOffset;
+}
+
+// Appends the stored form of an element to a buffer.
+template<typename T>
+void SerialAppend(vector<char>& buffer, const T& value) {
+	const char* bytes = reinterpret_cast<const char*>(&value);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+inline void SerialAppend(vector<char>& buffer, const string& value) {
+	uint64_t length = value.size();
+	const char* bytes = reinterpret_cast<const char*>(&length);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(length));
+	buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+// Returns the number of bytes from the read position to the end of in, or the largest uint64_t if
+// the stream cannot seek.
+inline uint64_t SerialBytesLeft(istream& in) {
+	streampos here = in.tellg();
+	if (here == streampos(-1) || !in.seekg(0, ios::end)) {
+		in.clear();
+		return UINT64_MAX;
+	}
+	streampos end = in.tellg();
+	in.seekg(here);
+	return end >= here ? (uint64_t)(end - here) : 0;
+}
+
+
+/* ---------- SAVING / LOADING ---------- */
+
+// Writes every element of list to out, head first. Returns false if the stream fails.
+template<typename T, typename Storage, typename Stats>
+bool Serialize(const LinkedList<T, Storage, Stats>& list, ostream& out) {
+	SerialHeader header = MakeSerialHeader<T>(list.NodeCount());
+	vector<char> buffer(header.dataOffset, 0);
+	memcpy(buffer.data(), &header, sizeof(header));
+	buffer.reserve(serialBufferBytes + 4096);
+	for (const typename LinkedList<T, Storage, Stats>::Node* node = list.Head(); node != nullptr; node = node->next) {
+		SerialAppend(buffer, node->data);
+		if (buffer.size() >= serialBufferBytes) {
+			out.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	}
+	out.write(buffer.data(), buffer.size());
+	out.flush();
+	return (bool)out;
+}
+
+// Writes list to the file at path, replacing it. Returns false if the file cannot be written.
+template<typename T, typename Storage, typename Stats>
+bool Serialize(const LinkedList<T, Storage, Stats>& list, const string& path) {
+	ofstream out(path, ios::binary | ios::trunc);
+	return out && Serialize(list, out);
+}
+
+// Replaces the contents of list with the elements read from in.
+// Returns false, leaving list empty, if the data is not a list of T or is cut short.
+template<typename T, typename Storage, typename Stats>
+bool Deserialize(LinkedList<T, Storage, Stats>& list, istream& in) {
+	list.Clear();
+	SerialHeader header;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || !CheckSerialHeader<T>(header)
+		|| !in.ignore(header.dataOffset - sizeof(header))) {
+		return false;
+	}
+
+	// whole blocks of elements go into the list with one AddNodesTail each
+	const uint64_t block = serialBufferBytes / sizeof(T) > 0 ? serialBufferBytes / sizeof(T) : 1;
+	vector<T> values((size_t)(header.count < block ? header.count : block));
+	for (uint64_t done = 0; done < header.count; ) {
+		uint64_t count = header.count - done < block ? header.count - done : block;
+		if (!in.read(reinterpret_cast<char*>(values.data()), (streamsize)(count * sizeof(T)))) {
+			list.Clear();
+			return false;
+		}
+		list.AddNodesTail(values.data(), (unsigned int)count);
+		done += count;
+	}
+	return true;
+}
+
+// A record's length is only trusted as far as the data behind it: one longer than what is left of
+// a seekable stream fails at once, and otherwise the buffer grows by doubling as data arrives, so
+// a corrupt length cannot make it allocate more than twice what the stream holds.
+template<typename Storage, typename Stats>
+bool Deserialize(LinkedList<string, Storage, Stats>& list, istream& in) {
+	list.Clear();
+	SerialHeader header;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || !CheckSerialHeader<string>(header)
+		|| !in.ignore(header.dataOffset - sizeof(header))) {
+		return false;
+	}
+	uint64_t streamLeft = SerialBytesLeft(in);
+
+	// records are parsed out of large reads; one cut off at the end of a read is moved to the
+	// front of the buffer and completed by the next
+	vector<char> buffer(serialBufferBytes);
+	uint64_t consumed = 0;	// bytes of records read from the stream
+	size_t filled = 0;
+	size_t parsed = 0;
+	string value;
+	for (uint64_t i = 0; i < header.count; ) {
+		uint64_t length = 0;
+		if (filled - parsed >= sizeof(length)) {
+			memcpy(&length, buffer.data() + parsed, sizeof(length));
+			if (filled - parsed - sizeof(length) >= length) {
+				value.assign(buffer.data() + parsed + sizeof(length), (size_t)length);
+				list.AddTail(value);
+				parsed += sizeof(length) + (size_t)length;
+				i++;
+				continue;
+			}
+			// the rest of the record is still in the stream, so it cannot be longer than that
+			uint64_t recordStart = consumed - (filled - parsed);
+			if (length > streamLeft - recordStart - sizeof(length)) {
+				list.Clear();
+				return false;
+			}
+		}
+		memmove(buffer.data(), buffer.data() + parsed, filled - parsed);
+		filled -= parsed;
+		parsed = 0;
+		uint64_t needed = sizeof(length) + length;
+		if (buffer.size() < needed) {
+			buffer.resize(buffer.size() * 2 < needed ? buffer.size() * 2 : (size_t)needed);
+		}
+		in.read(buffer.data() + filled, (streamsize)(buffer.size() - filled));
+		if (in.gcount() == 0) {
+			list.Clear();
+			return false;
+		}
+		filled += (size_t)in.gcount();
+		consumed += (uint64_t)in.gcount();
+	}
+	return true;
+}
+
+// Replaces the contents of list with the list saved in the file at path.
+template<typename T, typename Storage, typename Stats>
+bool Deserialize(LinkedList<T, Storage, Stats>& list, const string& path) {
+	ifstream in(path, ios::binary);
+	if (!in) {
+		list.Clear();
+		return false;
+	}
+	return Deserialize(list, in);
+}
+
+
+/* ---------- MAPPED VIEW ---------- */
+
+// A saved list file mapped read-only into memory. Pages are only read from disk as the elements
+// on them are used, so opening takes the same time however large the file is.
+class MappedFile {
+
+	protected:
+
+	const char* base;		// start of the mapping, nullptr if not open
+	size_t length;			// bytes mapped
+	SerialHeader header;	// copy of the file's header
+
+	// Maps the file at path and checks that it holds a list of T.
+	template<typename T>
+	bool Map(const string& path) {
+		Close();
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+		struct stat info;
+		if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SerialHeader)) {
+			close(fd);
+			return false;
+		}
+		void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (mapped == MAP_FAILED) {
+			return false;
+		}
+		base = static_cast<const char*>(mapped);
+		length = (size_t)info.st_size;
+		memcpy(&header, base, sizeof(header));
+		if (!CheckSerialHeader<T>(header) || header.dataOffset > length
+			|| (header.kind == (uint32_t)SerialKind::Fixed
+				&& header.count > (length - header.dataOffset) / header.elementSize)) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	public:
+
+	MappedFile() {
+		base = nullptr;
+		length = 0;
+		memset(&header, 0, sizeof(header));
+	}
+
+	~MappedFile() {
+		Close();
+	}
+
+	// a mapping has a single owner
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Unmaps the file; elements obtained from it are no longer valid.
+	void Close() {
+		if (base != nullptr) {
+			munmap(const_cast<char*>(base), length);
+		}
+		base = nullptr;
+		length = 0;
+		memset(&header, 0, sizeof(header));
+	}
+
+	bool IsOpen() const {
+		return base != nullptr;
+	}
+
+	// Returns the number of elements in the saved list.
+	size_t NodeCount() const {
+		return (size_t)header.count;
+	}
+};
+
+// Read-only view of a saved list of trivially copyable T. Elements are read in place, so the view
+// also offers constant-time indexing, which a LinkedList cannot.
+template<typename T>
+class MappedList : public MappedFile {
+
+	public:
+
+	// Opens the list saved at path. Returns false if it cannot be mapped or does not hold T.
+	bool Open(const string& path) {
+		return Map<T>(path);
+	}
+
+	// Returns the element at the specified index.
+	// Throws an out_of_range error if no such element exists.
+	const T& operator[](size_t index) const {
+		if (index >= NodeCount()) {
+			throw out_of_range("");
+		}
+		return begin()[index];
+	}
+
+	// Elements in list order, for range-based for loops.
+	const T* begin() const {
+		return reinterpret_cast<const T*>(base + header.dataOffset);
+	}
+
+	const T* end() const {
+		return begin() + NodeCount();
+	}
+
+	// Calls function on every element, head first.
+	template<typename Function>
+	void ForEach(Function function) const {
+		for (const T& value : *this) {
+			function(value);
+		}
+	}
+
+	// Replaces the contents of list with copies of the elements.
+	template<typename Storage, typename Stats>
+	void CopyTo(LinkedList<T, Storage, Stats>& list) const {
+		list.Clear();
+		const size_t block = 1u << 30;
+		for (size_t done = 0; done < NodeCount(); done += block) {
+			size_t count = NodeCount() - done < block ? NodeCount() - done : block;
+			list.AddNodesTail(begin() + done, (unsigned int)count);
+		}
+	}
+};
+
+// Read-only view of a saved list of strings. Records vary in length, so the elements can only be
+// visited in order; each is a string_view into the mapping.
+template<>
+class MappedList<string> : public MappedFile {
+
+	public:
+
+	// Walks the records of the mapping, stopping early at a record that runs past its end.
+	class const_iterator {
+		const char* position;
+		const char* limit;
+		size_t left;			// records still to visit, including this one
+		string_view value;
+
+		// Reads the record at position, or ends the walk if it does not fit.
+		void Load() {
+			uint64_t size;
+			if (left == 0 || (size_t)(limit - position) < sizeof(size)) {
+				left = 0;
+				return;
+			}
+			memcpy(&size, position, sizeof(size));
+			if (size > (uint64_t)(limit - position) - sizeof(size)) {
+				left = 0;
+				return;
+			}
+			value = string_view(position + sizeof(size), (size_t)size);
+		}
+
+		public:
+
+		const_iterator(const char* start, const char* stop, size_t count) {
+			position = start;
+			limit = stop;
+			left = count;
+			Load();
+		}
+
+		const string_view& operator*() const {
+			return value;
+		}
+
+		const string_view* operator->() const {
+			return &value;
+		}
+
+		const_iterator& operator++() {
+			position += sizeof(uint64_t) + value.size();
+			left--;
+			Load();
+			return *this;
+		}
+
+		bool operator==(const const_iterator& rhs) const {
+			return left == rhs.left;
+		}
+
+		bool operator!=(const const_iterator& rhs) const {
+			return left != rhs.left;
+		}
+	};
+
+	// Opens the list saved at path. Returns false if it cannot be mapped or does not hold strings.
+	bool Open(const string& path) {
+		return Map<string>(path);
+	}
+
+	const_iterator begin() const {
+		return const_iterator(base + header.dataOffset, base + length, NodeCount());
+	}
+
+	const_iterator end() const {
+		return const_iterator(nullptr, nullptr, 0);
+	}
+
+	// Calls function on every element, head first, as a string_view into the mapping.
+	template<typename Function>
+	void ForEach(Function function) const {
+		for (const string_view& value : *this) {
+			function(value);
+		}
+	}
+
+	// Replaces the contents of list with copies of the elements.
+	template<typename Storage, typename Stats>
+	void CopyTo(LinkedList<string, Storage, Stats>& list) const {
+		list.Clear();
+		string value;
+		for (const string_view& view : *this) {
+			value.assign(view.data(), view.size());
+			list.AddTail(value);
+		}
+	}
+};
+
+#endif
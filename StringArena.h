@@ -0,0 +1,176 @@
+#ifndef STRINGARENA_H
+#define STRINGARENA_H
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <utility>
+using namespace std;
+
+// Owns the characters of many strings in a few large blocks, so a list can hold string_views
+// into it instead of one heap-allocated std::string per element. Storage is only ever added;
+// every view stays valid until the arena is cleared or destroyed. An arena can also take over
+// a read-only mapping of a file, so views can point straight into the file's pages; such a file
+// must not be truncated while the arena holds it.
+class StringArena {
+
+	vector<char*> blocks;	// every block allocated, oldest first
+	char* next;				// first unused byte of the newest block
+	size_t left;			// unused bytes in the newest block
+	size_t blockBytes;		// size of a block, unless a larger one is reserved
+	size_t used;			// bytes handed out in all blocks
+	vector<pair<void*, size_t>> mappings;	// files mapped with MapFile
+
+	public:
+
+	/* ---------- CONSTRUCTION / DESTRUCTION ---------- */
+
+	// Constructor
+	// Blocks are allocated blockSize bytes at a time, as needed.
+	explicit StringArena(size_t blockSize = 4 << 20) {
+		next = nullptr;
+		left = 0;
+		blockBytes = blockSize > 0 ? blockSize : 1;
+		used = 0;
+	}
+
+	// views into an arena must not outlive it, so it cannot be copied, only moved
+	StringArena(const StringArena&) = delete;
+	StringArena& operator=(const StringArena&) = delete;
+
+	StringArena(StringArena&& other) noexcept {
+		blocks.swap(other.blocks);
+		mappings.swap(other.mappings);
+		next = other.next;
+		left = other.left;
+		blockBytes = other.blockBytes;
+		used = other.used;
+		other.next = nullptr;
+		other.left = 0;
+		other.used = 0;
+	}
+
+	// Frees this arena's storage and takes over the other arena's.
+	StringArena& operator=(StringArena&& other) noexcept {
+		if (this != &other) {
+			Clear();
+			blocks.swap(other.blocks);
+			mappings.swap(other.mappings);
+			next = other.next;
+			left = other.left;
+			blockBytes = other.blockBytes;
+			used = other.used;
+			other.next = nullptr;
+			other.left = 0;
+			other.used = 0;
+		}
+		return *this;
+	}
+
+	// Destructor
+	// Frees every block and unmaps every file; views into the arena are no longer valid.
+	~StringArena() {
+		Clear();
+	}
+
+
+	/* ---------- BEHAVIORS ---------- */
+
+	// Copies text into the arena and returns a view of the copy.
+	string_view Store(string_view text) {
+		char* space = Reserve(text.size());
+		if (!text.empty()) {
+			memcpy(space, text.data(), text.size());
+		}
+		Commit(text.size());
+		return string_view(space, text.size());
+	}
+
+	// Returns space for at least bytes contiguous characters, for a caller that fills it directly
+	// (e.g. with read()) and then keeps part of it with Commit. Space not committed is handed out
+	// again by the next Reserve or Store.
+	char* Reserve(size_t bytes) {
+		if (bytes > left) {
+			size_t size = bytes > blockBytes ? bytes : blockBytes;
+			char* block = static_cast<char*>(malloc(size));
+			if (block == nullptr) {
+				throw bad_alloc();
+			}
+			blocks.push_back(block);
+			next = block;
+			left = size;
+		}
+		return next;
+	}
+
+	// Returns bytes of storage aligned to alignment (a power of two), for records that carry their
+	// characters inline (see StringList.h).
+	void* Allocate(size_t bytes, size_t alignment) {
+		char* space = Reserve(bytes + alignment - 1);
+		size_t padding = (alignment - (size_t)space % alignment) % alignment;
+		Commit(padding + bytes);
+		return space + padding;
+	}
+
+	// Keeps the first bytes of the space returned by the last Reserve.
+	void Commit(size_t bytes) {
+		next += bytes;
+		left -= bytes;
+		used += bytes;
+	}
+
+	// Maps the regular file open as fd read-only for as long as the arena lives, and sets text to
+	// its contents. Returns false if it is not a regular file or cannot be mapped.
+	bool MapFile(int fd, string_view& text) {
+		struct stat info;
+		if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+			return false;
+		}
+		if (info.st_size == 0) {
+			text = string_view();
+			return true;
+		}
+		void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped == MAP_FAILED) {
+			return false;
+		}
+		madvise(mapped, (size_t)info.st_size, MADV_SEQUENTIAL);
+		mappings.push_back(make_pair(mapped, (size_t)info.st_size));
+		text = string_view(static_cast<const char*>(mapped), (size_t)info.st_size);
+		return true;
+	}
+
+	// Frees every block and unmaps every file; views into the arena are no longer valid.
+	void Clear() {
+		for (char* block : blocks) {
+			free(block);
+		}
+		blocks.clear();
+		for (const pair<void*, size_t>& mapping : mappings) {
+			munmap(mapping.first, mapping.second);
+		}
+		mappings.clear();
+		next = nullptr;
+		left = 0;
+		used = 0;
+	}
+
+
+	/* ---------- ACCESSORS ---------- */
+
+	// Returns the number of bytes stored.
+	size_t Bytes() const {
+		return used;
+	}
+
+	// Returns the number of blocks allocated.
+	size_t Blocks() const {
+		return blocks.size();
+	}
+};
+
+#endif
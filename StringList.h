@@ -0,0 +1,436 @@
+#ifndef STRINGLIST_H
+#define STRINGLIST_H
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "LinkedList.h"
+#include "StringArena.h"
+
+// A LinkedList of strings whose Nodes carry their characters inline and are carved out of a
+// StringArena, so adding a string costs one bump of the arena instead of a Node allocation plus,
+// for strings too long for the small-string buffer, a second one for the characters.
+// A Node is its links, a length and the characters (rounded up to 8 bytes), e.g. 32 bytes for a
+// word of up to 8 characters where LinkedList<string> uses 56 plus malloc overhead.
+// Removing a Node only unlinks it; its bytes are reclaimed when the LinkedList becomes empty, by
+// Clear, which frees whole blocks, or by Compact. The characters of a Node cannot change size,
+// so elements are read as string_views and replaced by removing and inserting.
+template<>
+class LinkedList<string, Strings> {
+
+	public:
+
+	// a Node is followed in memory by its length characters
+	struct Node {
+
+		// data members of the Node class
+		Node* prev;				// pointer to the previous Node
+		Node* next;				// pointer to the next Node
+		unsigned int length;	// number of characters stored after the Node
+
+		// Returns the Node's data.
+		string_view Data() const {
+			return string_view(reinterpret_cast<const char*>(this + 1), length);
+		}
+	};
+
+	private:
+
+	// data members of the LinkedList class
+	Node* head;				// pointer to the head of the LinkedList
+	Node* tail;				// pointer to the tail of the LinkedList
+	unsigned int size;		// number of Nodes currently in the LinkedList
+	size_t removed;			// arena bytes held by Nodes that were removed
+	StringArena arena;		// storage for every Node, including removed ones
+
+	static const size_t blockBytes = 64 << 10;	// arena block size
+
+
+	public:
+
+	/* ---------- CONSTRUCTION / DESTRUCTION ---------- */
+
+	// Constructor
+	// Creates an empty LinkedList; no arena block is allocated until the first insertion.
+	LinkedList() : arena(blockBytes) {
+		head = nullptr;
+		tail = nullptr;
+		size = 0;
+		removed = 0;
+	}
+
+	// Copy Constructor
+	// Creates a new LinkedList holding a copy of each Node from the other LinkedList, packed into
+	// as few blocks as they fit in.
+	LinkedList(const LinkedList& otherList) : LinkedList() {
+		Clone(otherList);
+	}
+
+	// Destructor
+	// Frees the arena, and with it every Node, one block at a time.
+	~LinkedList() {
+		Clear();
+	}
+
+
+	/* ---------- OPERATORS ---------- */
+
+	// Returns the data from the Node at the specified index.
+	// Throws an out_of_range error if no such Node exists.
+	string_view operator[](unsigned int index) const {
+		return GetNode(index)->Data();
+	}
+
+	// Determines whether two LinkedLists are exactly equal.
+	bool operator==(const LinkedList& rhs) const {
+		if (size != rhs.size) {
+			return false;
+		}
+		const Node* right = rhs.head;
+		for (const Node* left = head; left != nullptr; left = left->next) {
+			if (!Matches(left, right->Data())) {
+				return false;
+			}
+			right = right->next;
+		}
+		return true;
+	}
+
+	// Replaces the contents of this LinkedList with a copy of another.
+	LinkedList& operator=(const LinkedList& rhs) {
+		if (this != &rhs) {
+			Clear();
+			Clone(rhs);
+		}
+		return *this;
+	}
+
+
+	private:
+
+	/* ---------- Helper Functions ---------- */
+
+	// Copies every Node of another LinkedList onto the tail.
+	void Clone(const LinkedList& otherList) {
+		for (const Node* node = otherList.head; node != nullptr; node = node->next) {
+			AddTail(node->Data());
+		}
+	}
+
+	// Returns the arena bytes a Node holding length characters takes.
+	static size_t NodeBytes(size_t length) {
+		return (sizeof(Node) + length + alignof(Node) - 1) & ~(alignof(Node) - 1);
+	}
+
+	// Creates an unlinked Node holding a copy of data at the end of the arena.
+	Node* NewNode(string_view data) {
+		if (data.size() > 0xFFFFFFFFu) {
+			throw length_error("");
+		}
+		Node* node = new (arena.Allocate(NodeBytes(data.size()), alignof(Node))) Node();
+		node->length = (unsigned int)data.size();
+		if (!data.empty()) {
+			memcpy(node + 1, data.data(), data.size());
+		}
+		return node;
+	}
+
+	// Compares a Node's data with value, checking the lengths before any characters.
+	static bool Matches(const Node* node, string_view value) {
+		return node->length == value.size() && memcmp(node + 1, value.data(), value.size()) == 0;
+	}
+
+	// Iterates from start and returns the first Node with the specified value.
+	Node* Search(Node* start, string_view value) const {
+		for (Node* node = start; node != nullptr; node = node->next) {
+			if (Matches(node, value)) {
+				return node;
+			}
+		}
+		return nullptr;
+	}
+
+	// Detaches a Node from its neighbors, updating head and tail if needed.
+	void Unlink(Node* node) {
+		if (node->prev != nullptr) {
+			node->prev->next = node->next;
+		}
+		else {
+			head = node->next;
+		}
+		if (node->next != nullptr) {
+			node->next->prev = node->prev;
+		}
+		else {
+			tail = node->prev;
+		}
+	}
+
+	// Links a detached Node into the LinkedList between prev and next, either of which may be null.
+	void Link(Node* node, Node* prev, Node* next) {
+		node->prev = prev;
+		node->next = next;
+		if (prev != nullptr) {
+			prev->next = node;
+		}
+		else {
+			head = node;
+		}
+		if (next != nullptr) {
+			next->prev = node;
+		}
+		else {
+			tail = node;
+		}
+		size++;
+	}
+
+	// Unlinks a Node and accounts for its bytes; an empty LinkedList starts its arena over.
+	void Release(Node* node) {
+		Unlink(node);
+		size--;
+		removed += NodeBytes(node->length);
+		if (size == 0) {
+			Clear();
+		}
+	}
+
+
+	public:
+
+	/* ---------- BEHAVIORS ---------- */
+
+	// Prints all Nodes in the LinkedList from beginning to end.
+	void PrintForward() const {
+		for (const Node* node = head; node != nullptr; node = node->next) {
+			cout << node->Data() << endl;
+		}
+	}
+
+	// Prints all Nodes in the LinkedList from end to beginning.
+	void PrintReverse() const {
+		for (const Node* node = tail; node != nullptr; node = node->prev) {
+			cout << node->Data() << endl;
+		}
+	}
+
+	// Uses recursion to visit all nodes from a specified index to the end of the LinkedList.
+	void PrintForwardRecursive(const Node* node) const {
+		cout << node->Data() << endl;
+		if (node != tail) {
+			PrintForwardRecursive(node->next);
+		}
+	}
+
+	// Uses recursion to visit all nodes from a specified index to the beginning of the LinkedList.
+	void PrintReverseRecursive(const Node* node) const {
+		cout << node->Data() << endl;
+		if (node != head) {
+			PrintReverseRecursive(node->prev);
+		}
+	}
+
+	// Copies the live Nodes into a fresh arena, in order, and frees the old one, giving back the
+	// bytes of removed Nodes. Node pointers obtained before are no longer valid.
+	void Compact() {
+		if (removed == 0) {
+			return;
+		}
+		LinkedList packed(*this);
+		Clear();
+		head = packed.head;
+		tail = packed.tail;
+		size = packed.size;
+		arena = std::move(packed.arena);
+		packed.head = nullptr;
+		packed.tail = nullptr;
+		packed.size = 0;
+	}
+
+
+	/* ---------- ACCESSORS ---------- */
+
+	// Returns the number of Nodes in the LinkedList.
+	unsigned int NodeCount() const {
+		return size;
+	}
+
+	// Returns the number of arena bytes in use, including those of removed Nodes.
+	size_t Bytes() const {
+		return arena.Bytes();
+	}
+
+	// Returns the number of arena bytes held by removed Nodes until Compact or Clear.
+	size_t RemovedBytes() const {
+		return removed;
+	}
+
+	// Returns a pointer to the first Node with the specified data.
+	Node* Find(string_view data) {
+		return Search(head, data);
+	}
+
+	// Returns a constant pointer to the first Node with the specified data.
+	const Node* Find(string_view data) const {
+		return Search(head, data);
+	}
+
+	// Fills a vector with pointers to every Node containing the specified value, head first.
+	void FindAll(vector<Node*>& outData, string_view value) const {
+		for (Node* node = Search(head, value); node != nullptr; node = Search(node->next, value)) {
+			outData.push_back(node);
+		}
+	}
+
+	// Returns a pointer to the Node at the specified index.
+	// Throws an out_of_range error if no such Node exists.
+	Node* GetNode(unsigned int index) {
+		if (index >= size) {
+			throw out_of_range("");
+		}
+		Node* node = head;
+		for (unsigned int i = 0; i < index; i++) {
+			node = node->next;
+		}
+		return node;
+	}
+
+	// Returns a constant pointer to the Node at the specified index.
+	// Throws an out_of_range error if no such Node exists.
+	const Node* GetNode(unsigned int index) const {
+		return const_cast<LinkedList*>(this)->GetNode(index);
+	}
+
+	// Returns a pointer to the head of the LinkedList.
+	Node* Head() {
+		return head;
+	}
+
+	// Returns a constant pointer to the head of the LinkedList.
+	const Node* Head() const {
+		return head;
+	}
+
+	// Returns a pointer to the tail of the LinkedList.
+	Node* Tail() {
+		return tail;
+	}
+
+	// Returns a constant pointer to the tail of the LinkedList.
+	const Node* Tail() const {
+		return tail;
+	}
+
+
+	/* ---------- INSERTION ---------- */
+
+	// Creates a new Node and adds it at the beginning of the LinkedList.
+	void AddHead(string_view data) {
+		Link(NewNode(data), nullptr, head);
+	}
+
+	// Creates a new Node and adds it at the end of the LinkedList.
+	void AddTail(string_view data) {
+		Link(NewNode(data), tail, nullptr);
+	}
+
+	// Adds an array of data to the head of the LinkedList, creating a new Node for each datum.
+	void AddNodesHead(const string* data, unsigned int count) {
+		for (unsigned int i = count; i > 0; i--) {
+			AddHead(data[i-1]);
+		}
+	}
+
+	// Adds an array of data to the tail of the LinkedList, creating a new Node for each datum.
+	void AddNodesTail(const string* data, unsigned int count) {
+		for (unsigned int i = 0; i < count; i++) {
+			AddTail(data[i]);
+		}
+	}
+
+	// Inserts a new Node containing the specified data before the passed-in Node.
+	void InsertBefore(Node* node, string_view data) {
+		Link(NewNode(data), node->prev, node);
+	}
+
+	// Inserts a new Node containing the specified data after the passed-in Node.
+	void InsertAfter(Node* node, string_view data) {
+		Link(NewNode(data), node, node->next);
+	}
+
+	// Inserts a new Node containing the specified data at the specified index.
+	// Throws an out_of_range exception if passed-in index is not valid.
+	void InsertAt(string_view data, unsigned int index) {
+		if (index > size) {
+			throw out_of_range("");
+		}
+		if (index == size) {
+			AddTail(data);
+		}
+		else {
+			InsertBefore(GetNode(index), data);
+		}
+	}
+
+
+	/* ---------- REMOVAL ---------- */
+
+	// Removes the first Node in the LinkedList.
+	// Returns true if removal is successful and false if removal is unsuccessful.
+	bool RemoveHead() {
+		if (head == nullptr) {
+			return false;
+		}
+		Release(head);
+		return true;
+	}
+
+	// Removes the last Node in the LinkedList.
+	// Returns true if removal is successful and false if removal is unsuccessful.
+	bool RemoveTail() {
+		if (tail == nullptr) {
+			return false;
+		}
+		Release(tail);
+		return true;
+	}
+
+	// Remove all Nodes containing the specified data.
+	// Returns the number of nodes removed.
+	unsigned int Remove(string_view data) {
+		unsigned int numRemoved = 0;
+		Node* node = head;
+		while (node != nullptr) {
+			Node* next = node->next;
+			if (Matches(node, data)) {
+				Release(node);
+				numRemoved++;
+			}
+			node = next;
+		}
+		return numRemoved;
+	}
+
+	// Remove the Node at the specified index.
+	// Return true if removal is successful and false if removal is unsuccessful.
+	bool RemoveAt(unsigned int index) {
+		if (index >= size) {
+			return false;
+		}
+		Release(GetNode(index));
+		return true;
+	}
+
+	// Removes all Nodes by freeing the arena's blocks; no Node is visited.
+	void Clear() {
+		arena.Clear();
+		head = nullptr;
+		tail = nullptr;
+		size = 0;
+		removed = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,839 @@
+#ifndef VIEWS_H
+#define VIEWS_H
+
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+#include "LinkedList.h"
+using namespace std;
+
+// Lazy views over a LinkedList, or any range with begin() and end(), composed with |:
+//
+//     for (int x : list | Filter(isEven) | Transform(square) | Take(10)) ...
+//
+// A view holds no elements. Its iterators walk the underlying Nodes as they are advanced, so a
+// chain of views is a single pass with no list or vector in between, and nothing is copied until
+// ToList or ToVector asks for it. Stages of the same kind fuse when chained: two Filters become
+// one with both tests, two Transforms one composed function, Take(a) | Take(b) is Take(min),
+// Drop(a) | Drop(b) is Drop(a + b) (at most UINT_MAX), and Reverse | Reverse is the view it
+// started from.
+// Views over an lvalue refer to it and must not outlive it; views over a temporary list are
+// refused at compile time. Changing the list while walking a view over it has the same effect
+// as changing it while walking its iterators.
+// LinkedLists with Nodes, Arena or HugePages storage have the iterators these need. Under C++20
+// every view is a std::ranges::view and such a list a bidirectional range, so both also compose
+// with std::views and the std::ranges algorithms.
+
+#if defined(__cpp_lib_ranges)
+struct ViewBase : ranges::view_base {};
+#else
+struct ViewBase {};
+#endif
+
+// Whether a type is a view, stored by value in a chain rather than by reference.
+template<typename Range>
+struct IsView {
+#if defined(__cpp_lib_ranges)
+	static const bool value = is_base_of<ViewBase, Range>::value || ranges::view<Range>;
+#else
+	static const bool value = is_base_of<ViewBase, Range>::value;
+#endif
+};
+
+// The iterator type of a range.
+template<typename Range>
+using RangeIterator = decltype(declval<const Range&>().begin());
+
+// The weaker of an iterator category and bidirectional, which is the most these views provide.
+template<typename Iter>
+using CappedCategory = typename conditional<is_base_of<bidirectional_iterator_tag,
+	typename iterator_traits<Iter>::iterator_category>::value, bidirectional_iterator_tag,
+	typename iterator_traits<Iter>::iterator_category>::type;
+
+
+/* ---------- Helper Classes ---------- */
+
+// Holds a predicate or function so that the view holding it can be assigned even when the
+// function (a lambda with captures, say) cannot.
+template<typename Function>
+class Stored {
+
+	// data members of the Stored class
+	optional<Function> function;
+
+
+	public:
+
+	Stored() {
+	}
+
+	explicit Stored(const Function& value) : function(value) {
+	}
+
+	Stored(const Stored& other) : function(other.function) {
+	}
+
+	Stored(Stored&& other) : function(std::move(other.function)) {
+	}
+
+	Stored& operator=(const Stored& other) {
+		if (this != &other) {
+			function.reset();
+			if (other.function) {
+				function.emplace(*other.function);
+			}
+		}
+		return *this;
+	}
+
+	Stored& operator=(Stored&& other) {
+		if (this != &other) {
+			function.reset();
+			if (other.function) {
+				function.emplace(std::move(*other.function));
+			}
+		}
+		return *this;
+	}
+
+	template<typename... Args>
+	decltype(auto) operator()(Args&&... args) const {
+		return (*function)(std::forward<Args>(args)...);
+	}
+
+	// Returns the function held.
+	const Function& Get() const {
+		return *function;
+	}
+};
+
+// Two predicates that must both hold, for fused Filters.
+template<typename First, typename Second>
+struct BothOf {
+	First first;
+	Second second;
+
+	template<typename Value>
+	bool operator()(const Value& value) const {
+		return first(value) && second(value);
+	}
+};
+
+// Two functions applied one after the other, for fused Transforms.
+template<typename First, typename Second>
+struct Composed {
+	First first;
+	Second second;
+
+	template<typename Value>
+	decltype(auto) operator()(Value&& value) const {
+		return second(first(std::forward<Value>(value)));
+	}
+};
+
+
+/* ---------- VIEWS ---------- */
+
+// Materialization shared by every view.
+template<typename Derived>
+class View : public ViewBase {
+
+	public:
+
+	// Appends every element of the view to a LinkedList (or anything with AddTail).
+	template<typename List>
+	void ToList(List& outList) const {
+		for (auto&& value : Self()) {
+			outList.AddTail(value);
+		}
+	}
+
+	// Appends every element of the view to a vector.
+	template<typename Value>
+	void ToVector(vector<Value>& outData) const {
+		for (auto&& value : Self()) {
+			outData.push_back(value);
+		}
+	}
+
+	// Returns the number of elements, walking the whole view.
+	unsigned int Count() const {
+		unsigned int count = 0;
+		for (auto it = Self().begin(), end = Self().end(); it != end; ++it) {
+			count++;
+		}
+		return count;
+	}
+
+	// Returns true if the view has no elements; only looks for the first.
+	bool Empty() const {
+		return !(Self().begin() != Self().end());
+	}
+
+
+	private:
+
+	const Derived& Self() const {
+		return static_cast<const Derived&>(*this);
+	}
+};
+
+// A view of a whole range that is not itself a view, such as a LinkedList; refers to it.
+template<typename Range>
+class RefView : public View<RefView<Range>> {
+
+	// data members of the RefView class
+	Range* range;		// the range viewed
+
+
+	public:
+
+	RefView() {
+		range = nullptr;
+	}
+
+	explicit RefView(Range& viewed) {
+		range = &viewed;
+	}
+
+	auto begin() const {
+		return range->begin();
+	}
+
+	auto end() const {
+		return range->end();
+	}
+};
+
+// The elements of a view for which a predicate holds.
+template<typename Source, typename Predicate>
+class FilterView : public View<FilterView<Source, Predicate>> {
+
+	typedef RangeIterator<Source> SourceIterator;
+
+	public:
+
+	class Iterator {
+
+		// data members of the Iterator class
+		SourceIterator it;				// the current element, which passes the test
+		SourceIterator last;			// the end of the source
+		const FilterView* view;			// for the predicate
+
+		public:
+
+		typedef CappedCategory<SourceIterator> iterator_category;
+		typedef typename iterator_traits<SourceIterator>::value_type value_type;
+		typedef typename iterator_traits<SourceIterator>::difference_type difference_type;
+		typedef typename iterator_traits<SourceIterator>::pointer pointer;
+		typedef typename iterator_traits<SourceIterator>::reference reference;
+
+		Iterator() : it(), last() {
+			view = nullptr;
+		}
+
+		// Starts at at, or at the first element after it that passes the test.
+		Iterator(SourceIterator at, SourceIterator end, const FilterView* owner) : it(at), last(end) {
+			view = owner;
+			Skip();
+		}
+
+		reference operator*() const {
+			return *it;
+		}
+
+		Iterator& operator++() {
+			++it;
+			Skip();
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator before = *this;
+			++*this;
+			return before;
+		}
+
+		// Steps back to the previous element that passes the test; there must be one.
+		Iterator& operator--() {
+			do {
+				--it;
+			} while (!view->predicate(*it));
+			return *this;
+		}
+
+		Iterator operator--(int) {
+			Iterator before = *this;
+			--*this;
+			return before;
+		}
+
+		bool operator==(const Iterator& other) const {
+			return it == other.it;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return !(it == other.it);
+		}
+
+		private:
+
+		void Skip() {
+			while (it != last && !view->predicate(*it)) {
+				++it;
+			}
+		}
+	};
+
+	private:
+
+	friend class Iterator;
+
+	// data members of the FilterView class
+	Source source;					// the view filtered
+	Stored<Predicate> predicate;	// the test elements must pass
+
+
+	public:
+
+	FilterView() {
+	}
+
+	FilterView(Source viewed, const Predicate& test) : source(std::move(viewed)), predicate(test) {
+	}
+
+	// Walks to the first element that passes the test, each time it is called.
+	Iterator begin() const {
+		return Iterator(source.begin(), source.end(), this);
+	}
+
+	Iterator end() const {
+		return Iterator(source.end(), source.end(), this);
+	}
+
+	// Returns the unfiltered view and the test, for fusing with another Filter.
+	const Source& Base() const {
+		return source;
+	}
+
+	const Predicate& Test() const {
+		return predicate.Get();
+	}
+};
+
+// Each element of a view passed through a function.
+template<typename Source, typename Function>
+class TransformView : public View<TransformView<Source, Function>> {
+
+	typedef RangeIterator<Source> SourceIterator;
+
+	public:
+
+	class Iterator {
+
+		// data members of the Iterator class
+		SourceIterator it;				// the current element before the function
+		const TransformView* view;		// for the function
+
+		public:
+
+		typedef decltype(declval<const Function&>()(*declval<SourceIterator>())) reference;
+		typedef typename remove_cv<typename remove_reference<reference>::type>::type value_type;
+		typedef typename iterator_traits<SourceIterator>::difference_type difference_type;
+		typedef void pointer;
+		// a function returning a value only makes an input iterator by the classic rules; the
+		// C++20 concepts go by iterator_concept
+		typedef typename conditional<is_reference<reference>::value, CappedCategory<SourceIterator>,
+			input_iterator_tag>::type iterator_category;
+		typedef CappedCategory<SourceIterator> iterator_concept;
+
+		Iterator() : it() {
+			view = nullptr;
+		}
+
+		Iterator(SourceIterator at, const TransformView* owner) : it(at) {
+			view = owner;
+		}
+
+		reference operator*() const {
+			return view->function(*it);
+		}
+
+		Iterator& operator++() {
+			++it;
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator before = *this;
+			++it;
+			return before;
+		}
+
+		Iterator& operator--() {
+			--it;
+			return *this;
+		}
+
+		Iterator operator--(int) {
+			Iterator before = *this;
+			--it;
+			return before;
+		}
+
+		bool operator==(const Iterator& other) const {
+			return it == other.it;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return !(it == other.it);
+		}
+	};
+
+	private:
+
+	friend class Iterator;
+
+	// data members of the TransformView class
+	Source source;					// the view transformed
+	Stored<Function> function;		// applied to each element as it is read
+
+
+	public:
+
+	TransformView() {
+	}
+
+	TransformView(Source viewed, const Function& apply) : source(std::move(viewed)), function(apply) {
+	}
+
+	Iterator begin() const {
+		return Iterator(source.begin(), this);
+	}
+
+	Iterator end() const {
+		return Iterator(source.end(), this);
+	}
+
+	// Returns the untransformed view and the function, for fusing with another Transform.
+	const Source& Base() const {
+		return source;
+	}
+
+	const Function& Apply() const {
+		return function.Get();
+	}
+};
+
+// The first count elements of a view.
+template<typename Source>
+class TakeView : public View<TakeView<Source>> {
+
+	typedef RangeIterator<Source> SourceIterator;
+
+	public:
+
+	class Iterator {
+
+		// data members of the Iterator class
+		SourceIterator it;		// the current element
+		unsigned int left;		// elements that may still be taken, 0 at the end
+
+		public:
+
+		typedef typename conditional<is_base_of<forward_iterator_tag,
+			typename iterator_traits<SourceIterator>::iterator_category>::value, forward_iterator_tag,
+			input_iterator_tag>::type iterator_category;
+		typedef typename iterator_traits<SourceIterator>::value_type value_type;
+		typedef typename iterator_traits<SourceIterator>::difference_type difference_type;
+		typedef typename iterator_traits<SourceIterator>::pointer pointer;
+		typedef typename iterator_traits<SourceIterator>::reference reference;
+
+		Iterator() : it() {
+			left = 0;
+		}
+
+		Iterator(SourceIterator at, unsigned int remaining) : it(at) {
+			left = remaining;
+		}
+
+		reference operator*() const {
+			return *it;
+		}
+
+		Iterator& operator++() {
+			++it;
+			left--;
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator before = *this;
+			++*this;
+			return before;
+		}
+
+		// the end is either count elements in or the end of the source, whichever comes first
+		bool operator==(const Iterator& other) const {
+			return left == other.left || it == other.it;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return !(*this == other);
+		}
+	};
+
+	private:
+
+	// data members of the TakeView class
+	Source source;			// the view taken from
+	unsigned int count;		// the most elements taken
+
+
+	public:
+
+	TakeView() {
+		count = 0;
+	}
+
+	TakeView(Source viewed, unsigned int most) : source(std::move(viewed)) {
+		count = most;
+	}
+
+	Iterator begin() const {
+		return Iterator(source.begin(), count);
+	}
+
+	Iterator end() const {
+		return Iterator(source.end(), 0);
+	}
+
+	// Returns the whole view and the count, for fusing with another Take.
+	const Source& Base() const {
+		return source;
+	}
+
+	unsigned int Most() const {
+		return count;
+	}
+};
+
+// A view without its first count elements. Its iterators are the source's own.
+template<typename Source>
+class DropView : public View<DropView<Source>> {
+
+	// data members of the DropView class
+	Source source;			// the view dropped from
+	unsigned int count;		// the elements skipped
+
+
+	public:
+
+	DropView() {
+		count = 0;
+	}
+
+	DropView(Source viewed, unsigned int skipped) : source(std::move(viewed)) {
+		count = skipped;
+	}
+
+	// Walks past the dropped elements, each time it is called.
+	RangeIterator<Source> begin() const {
+		RangeIterator<Source> it = source.begin();
+		RangeIterator<Source> last = source.end();
+		for (unsigned int i = 0; i < count && it != last; i++) {
+			++it;
+		}
+		return it;
+	}
+
+	RangeIterator<Source> end() const {
+		return source.end();
+	}
+
+	// Returns the whole view and the count, for fusing with another Drop.
+	const Source& Base() const {
+		return source;
+	}
+
+	unsigned int Skipped() const {
+		return count;
+	}
+};
+
+// A view from its last element to its first. The source must be bidirectional, with an end
+// that can be stepped back from: a LinkedList, or Filter, Transform, Drop or Reverse of one.
+template<typename Source>
+class ReverseView : public View<ReverseView<Source>> {
+
+	// data members of the ReverseView class
+	Source source;		// the view reversed
+
+
+	public:
+
+	ReverseView() {
+	}
+
+	explicit ReverseView(Source viewed) : source(std::move(viewed)) {
+	}
+
+	reverse_iterator<RangeIterator<Source>> begin() const {
+		return reverse_iterator<RangeIterator<Source>>(source.end());
+	}
+
+	reverse_iterator<RangeIterator<Source>> end() const {
+		return reverse_iterator<RangeIterator<Source>>(source.begin());
+	}
+
+	// Returns the view in its original order, which is what reversing again gives.
+	const Source& Base() const {
+		return source;
+	}
+};
+
+// Pairs of elements from two views in step, as long as the shorter one. Each pair holds the
+// two elements as the views give them, so over lists they are references to the data.
+template<typename First, typename Second>
+class ZipView : public View<ZipView<First, Second>> {
+
+	typedef RangeIterator<First> FirstIterator;
+	typedef RangeIterator<Second> SecondIterator;
+
+	public:
+
+	class Iterator {
+
+		// data members of the Iterator class
+		FirstIterator first;		// the current element of the first view
+		SecondIterator second;		// the current element of the second view
+
+		public:
+
+		typedef pair<typename iterator_traits<FirstIterator>::reference,
+			typename iterator_traits<SecondIterator>::reference> reference;
+		typedef reference value_type;
+		typedef ptrdiff_t difference_type;
+		typedef void pointer;
+		typedef input_iterator_tag iterator_category;
+		typedef forward_iterator_tag iterator_concept;
+
+		Iterator() : first(), second() {
+		}
+
+		Iterator(FirstIterator at, SecondIterator with) : first(at), second(with) {
+		}
+
+		reference operator*() const {
+			return reference(*first, *second);
+		}
+
+		Iterator& operator++() {
+			++first;
+			++second;
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator before = *this;
+			++*this;
+			return before;
+		}
+
+		// the end is reached when either view ends
+		bool operator==(const Iterator& other) const {
+			return first == other.first || second == other.second;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return !(*this == other);
+		}
+	};
+
+	private:
+
+	// data members of the ZipView class
+	First firstView;		// the view giving the first of each pair
+	Second secondView;		// the view giving the second of each pair
+
+
+	public:
+
+	ZipView() {
+	}
+
+	ZipView(First left, Second right) : firstView(std::move(left)), secondView(std::move(right)) {
+	}
+
+	Iterator begin() const {
+		return Iterator(firstView.begin(), secondView.begin());
+	}
+
+	Iterator end() const {
+		return Iterator(firstView.end(), secondView.end());
+	}
+};
+
+
+/* ---------- STAGES ---------- */
+// what Filter(...), Transform(...) etc. return; applying one to a view with | builds the next view
+
+struct StageBase {};
+
+// Wraps a range as a view: views are copied, lvalues referred to.
+template<typename Range, bool isView = IsView<typename remove_cv<typename remove_reference<Range>::type>::type>::value>
+struct ViewOf {
+	typedef typename remove_cv<typename remove_reference<Range>::type>::type type;
+
+	static type Make(Range&& range) {
+		return type(std::forward<Range>(range));
+	}
+};
+
+template<typename Range>
+struct ViewOf<Range, false> {
+	static_assert(is_lvalue_reference<Range>::value, "a view over a temporary list would outlive it");
+	typedef RefView<typename remove_reference<Range>::type> type;
+
+	static type Make(Range&& range) {
+		return type(range);
+	}
+};
+
+template<typename Range>
+typename ViewOf<Range>::type AsView(Range&& range) {
+	return ViewOf<Range>::Make(std::forward<Range>(range));
+}
+
+template<typename Predicate>
+struct FilterStage : StageBase {
+	Predicate predicate;
+
+	template<typename Source>
+	auto operator()(Source source) const {
+		return FilterView<Source, Predicate>(std::move(source), predicate);
+	}
+
+	template<typename Source, typename Earlier>
+	auto operator()(FilterView<Source, Earlier> source) const {
+		return FilterView<Source, BothOf<Earlier, Predicate>>(source.Base(),
+			BothOf<Earlier, Predicate>{ source.Test(), predicate });
+	}
+};
+
+template<typename Function>
+struct TransformStage : StageBase {
+	Function function;
+
+	template<typename Source>
+	auto operator()(Source source) const {
+		return TransformView<Source, Function>(std::move(source), function);
+	}
+
+	template<typename Source, typename Earlier>
+	auto operator()(TransformView<Source, Earlier> source) const {
+		return TransformView<Source, Composed<Earlier, Function>>(source.Base(),
+			Composed<Earlier, Function>{ source.Apply(), function });
+	}
+};
+
+struct TakeStage : StageBase {
+	unsigned int count;
+
+	template<typename Source>
+	auto operator()(Source source) const {
+		return TakeView<Source>(std::move(source), count);
+	}
+
+	template<typename Source>
+	auto operator()(TakeView<Source> source) const {
+		return TakeView<Source>(source.Base(), count < source.Most() ? count : source.Most());
+	}
+};
+
+struct DropStage : StageBase {
+	unsigned int count;
+
+	template<typename Source>
+	auto operator()(Source source) const {
+		return DropView<Source>(std::move(source), count);
+	}
+
+	template<typename Source>
+	auto operator()(DropView<Source> source) const {
+		// a sum past UINT_MAX drops everything either way
+		unsigned int skipped = source.Skipped() > UINT_MAX - count ? UINT_MAX : source.Skipped() + count;
+		return DropView<Source>(source.Base(), skipped);
+	}
+};
+
+struct ReverseStage : StageBase {
+	template<typename Source>
+	auto operator()(Source source) const {
+		return ReverseView<Source>(std::move(source));
+	}
+
+	template<typename Source>
+	Source operator()(ReverseView<Source> source) const {
+		return source.Base();
+	}
+};
+
+template<typename Other>
+struct ZipStage : StageBase {
+	Other other;
+
+	template<typename Source>
+	auto operator()(Source source) const {
+		return ZipView<Source, Other>(std::move(source), other);
+	}
+};
+
+// Applies a stage to a LinkedList, a view or another range: list | Filter(isEven).
+template<typename Range, typename Stage,
+	typename = typename enable_if<is_base_of<StageBase, Stage>::value>::type>
+auto operator|(Range&& range, const Stage& stage) {
+	return stage(AsView(std::forward<Range>(range)));
+}
+
+// Keeps the elements for which predicate(element) is true.
+template<typename Predicate>
+FilterStage<Predicate> Filter(Predicate predicate) {
+	return FilterStage<Predicate>{ {}, predicate };
+}
+
+// Gives function(element) in place of each element, computed when it is read.
+template<typename Function>
+TransformStage<Function> Transform(Function function) {
+	return TransformStage<Function>{ {}, function };
+}
+
+// Keeps at most the first count elements.
+inline TakeStage Take(unsigned int count) {
+	return TakeStage{ {}, count };
+}
+
+// Skips the first count elements.
+inline DropStage Drop(unsigned int count) {
+	return DropStage{ {}, count };
+}
+
+// Gives the elements from last to first.
+inline ReverseStage Reverse() {
+	return ReverseStage{};
+}
+
+// Pairs each element with the element at the same position of other.
+template<typename Range>
+ZipStage<typename ViewOf<Range>::type> Zip(Range&& other) {
+	return ZipStage<typename ViewOf<Range>::type>{ {}, AsView(std::forward<Range>(other)) };
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "LinkedList.h"
+using namespace std;
+
+// Measures K random InsertAt/RemoveAt/AddTail edits to a list of N Nodes, made one call at a time
+// (each walking from the head) and recorded in a Batch and applied together (one sort of the
+// edits and one walk).
+// Usage: bench_batch [nodes]
+
+double Seconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// one edit: 0 InsertAt, 1 RemoveAt, 2 AddTail
+struct Edit {
+	int kind;
+	unsigned int position;
+};
+
+vector<Edit> MakeEdits(unsigned int count, unsigned int nodes, unsigned int seed)
+{
+	mt19937 rng(seed);
+	vector<Edit> edits;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		int kind = rng() % 5 < 2 ? 0 : (rng() % 3 < 2 ? 1 : 2);
+		edits.push_back(Edit{ kind, (unsigned int)(rng() % nodes) });
+	}
+	return edits;
+}
+
+template<typename Storage>
+void Run(const string& name, unsigned int nodes, unsigned int count)
+{
+	vector<Edit> edits = MakeEdits(count, nodes, count);
+	LinkedList<long long, Storage> single;
+	LinkedList<long long, Storage> batched;
+	for (unsigned int i = 0; i < nodes; i++)
+	{
+		single.AddTail(i);
+		batched.AddTail(i);
+	}
+
+	auto start = chrono::steady_clock::now();
+	for (const Edit& edit : edits)
+	{
+		if (edit.kind == 0)
+			single.InsertAt(-1, edit.position % (single.NodeCount() + 1));
+		else if (edit.kind == 1)
+			single.RemoveAt(edit.position % single.NodeCount());
+		else
+			single.AddTail(-2);
+	}
+	double oneByOne = Seconds(start);
+
+	start = chrono::steady_clock::now();
+	typename LinkedList<long long, Storage>::Batch batch(batched);
+	for (const Edit& edit : edits)
+	{
+		if (edit.kind == 0)
+			batch.InsertAt(-1, edit.position);
+		else if (edit.kind == 1)
+			batch.RemoveAt(edit.position);
+		else
+			batch.AddTail(-2);
+	}
+	batch.Apply();
+	double together = Seconds(start);
+
+	cout << left << setw(10) << name << setw(10) << count << setw(14) << fixed << setprecision(3) << oneByOne * 1e3
+		<< setw(14) << together * 1e3 << setprecision(1) << oneByOne / together << "x" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int nodes = argc > 1 ? atoi(argv[1]) : 100000;
+
+	cout << "nodes: " << nodes << endl;
+	cout << left << setw(10) << "storage" << setw(10) << "edits" << setw(14) << "one by one ms" << setw(14)
+		<< "Batch ms" << "speedup" << endl;
+	for (unsigned int count : { 10, 100, 1000, 10000 })
+	{
+		Run<Nodes>("Nodes", nodes, count);
+		Run<Arena>("Arena", nodes, count);
+	}
+	return 0;
+}
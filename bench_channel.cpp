@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Channel.h"
+#include "LinkedList.h"
+using namespace std;
+
+// Measures what it costs to hand data to a waiting consumer: coroutines on a LocalExecutor waiting
+// in a Channel, against threads waiting on a condition variable for a mutex-guarded LinkedList,
+// which is how consumers poll a LinkedList for new tail items today.
+// ping-pong: two parties pass one element back and forth, so every handoff is a switch.
+// fan-out: one producer feeds 8 consumers, one element at a time or in batches of 64 with
+// AddNodesTail (batch wake) and PopNodesHead, or notify_all for the threads.
+// Needs C++20. Usage: bench_channel [handoffs]
+
+double Seconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void Report(const string& name, double seconds, unsigned int handoffs, unsigned long long wakeups, bool correct = true)
+{
+	cout << left << setw(32) << name << setw(12) << fixed << setprecision(1) << seconds * 1e9 / handoffs
+		<< setw(10) << wakeups << (correct ? "" : "error: elements lost") << endl;
+}
+
+// Returns the sum of every element a fan-out producer adds.
+long long Expected(unsigned int items)
+{
+	return (long long)items * (items - 1) / 2;
+}
+
+// the condition-variable version of a Channel: consumers sleep until the list has data
+class LockedList {
+	LinkedList<long long> list;
+	mutex lock;
+	condition_variable notEmpty;
+	bool closed = false;
+
+	public:
+
+	unsigned long long wakeups = 0;
+
+	void AddTail(long long data) {
+		lock_guard<mutex> guard(lock);
+		list.AddTail(data);
+		notEmpty.notify_one();
+	}
+
+	void AddNodesTail(const long long* data, unsigned int count) {
+		lock_guard<mutex> guard(lock);
+		list.AddNodesTail(data, count);
+		notEmpty.notify_all();
+	}
+
+	// Waits for data, then takes up to count elements. Returns 0 once closed and empty.
+	unsigned int RemoveNodesHead(long long* outData, unsigned int count) {
+		unique_lock<mutex> guard(lock);
+		while (list.NodeCount() == 0 && !closed) {
+			notEmpty.wait(guard);
+			wakeups++;
+		}
+		unsigned int removed = 0;
+		while (removed < count && list.NodeCount() > 0) {
+			outData[removed++] = list.Head()->data;
+			list.RemoveHead();
+		}
+		return removed;
+	}
+
+	void Close() {
+		lock_guard<mutex> guard(lock);
+		closed = true;
+		notEmpty.notify_all();
+	}
+};
+
+Task PingPong(Channel<long long>& in, Channel<long long>& out, unsigned int rounds, bool starts)
+{
+	if (starts)
+		out.AddTail(0);
+	for (unsigned int i = 0; i < rounds; i++)
+	{
+		optional<long long> value = co_await in.PopHead();
+		if (!starts || i + 1 < rounds)
+			out.AddTail(*value + 1);
+	}
+}
+
+void CoroutinePingPong(unsigned int handoffs)
+{
+	LocalExecutor executor;
+	Channel<long long> ping(executor);
+	Channel<long long> pong(executor);
+	auto start = chrono::steady_clock::now();
+	executor.Spawn(PingPong(ping, pong, handoffs / 2, true));
+	executor.Spawn(PingPong(pong, ping, handoffs / 2, false));
+	executor.Run();
+	Report("ping-pong coroutines", Seconds(start), handoffs, executor.Resumed());
+}
+
+void ThreadPingPong(unsigned int handoffs)
+{
+	LockedList ping;
+	LockedList pong;
+	auto start = chrono::steady_clock::now();
+	thread other([&]() {
+		long long value = 0;
+		for (unsigned int i = 0; i < handoffs / 2; i++)
+		{
+			ping.RemoveNodesHead(&value, 1);
+			pong.AddTail(value + 1);
+		}
+	});
+	long long value = 0;
+	for (unsigned int i = 0; i < handoffs / 2; i++)
+	{
+		ping.AddTail(value);
+		pong.RemoveNodesHead(&value, 1);
+	}
+	other.join();
+	Report("ping-pong condition variable", Seconds(start), handoffs, ping.wakeups + pong.wakeups);
+}
+
+Task FanOutConsumer(Channel<long long>& channel, unsigned int batch, long long& sum)
+{
+	vector<long long> received;
+	while (true)
+	{
+		received.clear();
+		if (co_await channel.PopNodesHead(received, batch) == 0)
+			break;
+		for (long long value : received)
+			sum += value;
+	}
+}
+
+Task FanOutProducer(LocalExecutor& executor, Channel<long long>& channel, unsigned int items, unsigned int batch)
+{
+	vector<long long> data(batch);
+	for (unsigned int i = 0; i < items; i += batch)
+	{
+		unsigned int count = min(batch, items - i);
+		for (unsigned int j = 0; j < count; j++)
+			data[j] = i + j;
+		if (batch == 1)
+			channel.AddTail(data[0]);
+		else
+			channel.AddNodesTail(data.data(), count);
+		co_await executor.Yield();
+	}
+	channel.Close();
+}
+
+void CoroutineFanOut(unsigned int items, unsigned int batch)
+{
+	LocalExecutor executor;
+	Channel<long long> channel(executor);
+	long long sum = 0;
+	auto start = chrono::steady_clock::now();
+	for (int c = 0; c < 8; c++)
+		executor.Spawn(FanOutConsumer(channel, batch, sum));
+	executor.Spawn(FanOutProducer(executor, channel, items, batch));
+	executor.Run();
+	Report("fan-out coroutines batch " + to_string(batch), Seconds(start), items, executor.Resumed(),
+		sum == Expected(items));
+}
+
+void ThreadFanOut(unsigned int items, unsigned int batch)
+{
+	LockedList channel;
+	vector<thread> consumers;
+	vector<long long> sums(8, 0);
+	auto start = chrono::steady_clock::now();
+	for (int c = 0; c < 8; c++)
+	{
+		consumers.emplace_back([&channel, &sums, c, batch]() {
+			vector<long long> received(batch);
+			long long& sum = sums[c];
+			unsigned int count;
+			while ((count = channel.RemoveNodesHead(received.data(), batch)) > 0)
+			{
+				for (unsigned int i = 0; i < count; i++)
+					sum += received[i];
+			}
+		});
+	}
+	vector<long long> data(batch);
+	for (unsigned int i = 0; i < items; i += batch)
+	{
+		unsigned int count = min(batch, items - i);
+		for (unsigned int j = 0; j < count; j++)
+			data[j] = i + j;
+		if (batch == 1)
+			channel.AddTail(data[0]);
+		else
+			channel.AddNodesTail(data.data(), count);
+	}
+	channel.Close();
+	for (thread& consumer : consumers)
+		consumer.join();
+	long long sum = 0;
+	for (long long consumerSum : sums)
+		sum += consumerSum;
+	Report("fan-out condition var batch " + to_string(batch), Seconds(start), items, channel.wakeups,
+		sum == Expected(items));
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int handoffs = argc > 1 ? atoi(argv[1]) : 1000000;
+
+	cout << "handoffs: " << handoffs << endl;
+	cout << left << setw(32) << "" << setw(12) << "ns/item" << "wakeups" << endl;
+	CoroutinePingPong(handoffs);
+	ThreadPingPong(handoffs / 10);
+	for (unsigned int batch : { 1, 64 })
+	{
+		CoroutineFanOut(handoffs, batch);
+		ThreadFanOut(handoffs, batch);
+	}
+	return 0;
+}
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "LinkedList.h"
+using namespace std;
+
+// Measures how long the thread that drops a long LinkedList is held up: building it with AddTail,
+// then Clear (as the destructor does) with Node storage, Arena storage, and each of them with
+// SetDeferredClear(true), where Clear only hands the Nodes to the Reclaimer thread. The time the
+// Reclaimer then spends is reported separately.
+// Usage: bench_clear [elements]
+
+double Seconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template<typename T, typename Storage>
+void Run(const string& name, unsigned int elements, bool deferred, T (*make)(unsigned int))
+{
+	auto start = chrono::steady_clock::now();
+	LinkedList<T, Storage>* list = new LinkedList<T, Storage>();
+	list->SetDeferredClear(deferred);
+	for (unsigned int i = 0; i < elements; i++)
+		list->AddTail(make(i));
+	double build = Seconds(start);
+
+	start = chrono::steady_clock::now();
+	delete list;
+	double clear = Seconds(start);
+
+	start = chrono::steady_clock::now();
+	Reclaimer::Instance().Drain();
+	double background = Seconds(start);
+
+	cout << left << setw(28) << name << setw(12) << fixed << setprecision(3) << build
+		<< setw(12) << setprecision(6) << clear << setprecision(3) << background << endl;
+}
+
+long long MakeNumber(unsigned int i)
+{
+	return (long long)i * 2654435761u;
+}
+
+string MakeString(unsigned int i)
+{
+	return "element-with-a-long-name-" + to_string(i);
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int elements = argc > 1 ? atoi(argv[1]) : 50000000;
+
+	cout << "elements: " << elements << endl;
+	cout << left << setw(28) << "list" << setw(12) << "build s" << setw(12) << "clear s" << "reclaimer s" << endl;
+	for (bool deferred : { false, true })
+	{
+		string mode = deferred ? " deferred" : "";
+		Run<long long, Nodes>("long long Nodes" + mode, elements, deferred, MakeNumber);
+		Run<long long, Arena>("long long Arena" + mode, elements, deferred, MakeNumber);
+	}
+	elements /= 4;
+	cout << "elements: " << elements << endl;
+	for (bool deferred : { false, true })
+	{
+		string mode = deferred ? " deferred" : "";
+		Run<string, Nodes>("string Nodes" + mode, elements, deferred, MakeString);
+		Run<string, Arena>("string Arena" + mode, elements, deferred, MakeString);
+	}
+	return 0;
+}
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LinkedList.h"
+#include "ConcurrentList.h"
+using namespace std;
+
+// Compares ConcurrentList with one global mutex as thread count grows.
+//   index:   random InsertAt/RemoveAt over a shared list (LinkedList + mutex vs ConcurrentList)
+//   regions: each thread edits its own region through Node pointers (ConcurrentList with and
+//            without an extra global mutex around every call)
+// Usage: bench_concurrent_list [operations per thread] [initial size]
+
+struct NoLock {
+	void lock() {}
+	void unlock() {}
+};
+
+template<typename Run>
+double Time(unsigned int threads, Run run)
+{
+	vector<thread> workers;
+	auto start = chrono::steady_clock::now();
+	for (unsigned int t = 0; t < threads; t++)
+		workers.emplace_back(run, t);
+	for (thread& worker : workers)
+		worker.join();
+	auto stop = chrono::steady_clock::now();
+	return chrono::duration<double, nano>(stop - start).count();
+}
+
+void Report(const string& name, unsigned int threads, unsigned int operations, double ns)
+{
+	double total = (double)threads * operations;
+	cout << left << setw(30) << name << setw(9) << threads << setw(12) << fixed << setprecision(1)
+		<< ns / total << setprecision(3) << total / ns * 1000.0 << endl;
+}
+
+double IndexLinkedList(unsigned int threads, unsigned int operations, unsigned int initial)
+{
+	LinkedList<int> list;
+	mutex lock;
+	for (unsigned int i = 0; i < initial; i++)
+		list.AddTail(i);
+	return Time(threads, [&](unsigned int t) {
+		mt19937 rng(t);
+		for (unsigned int i = 0; i < operations; i++)
+		{
+			lock_guard<mutex> guard(lock);
+			unsigned int index = rng() % list.NodeCount();
+			if (i % 2 == 0)
+				list.InsertAt(i, index);
+			else
+				list.RemoveAt(index);
+		}
+	});
+}
+
+double IndexConcurrentList(unsigned int threads, unsigned int operations, unsigned int initial)
+{
+	ConcurrentList<int> list;
+	for (unsigned int i = 0; i < initial; i++)
+		list.AddTail(i);
+	return Time(threads, [&](unsigned int t) {
+		mt19937 rng(t);
+		for (unsigned int i = 0; i < operations; i++)
+		{
+			unsigned int index = rng() % (list.NodeCount() + 1);
+			if (i % 2 == 0)
+				list.InsertAt(i, index);
+			else
+				list.RemoveAt(index);
+		}
+	});
+}
+
+template<typename Lock>
+double Regions(unsigned int threads, unsigned int operations, unsigned int initial)
+{
+	ConcurrentList<int> list;
+	Lock lock;
+	vector<ConcurrentList<int>::Node*> markers;
+	for (unsigned int t = 0; t < threads; t++)
+	{
+		markers.push_back(list.AddTail(-1));
+		for (unsigned int i = 0; i < initial / threads; i++)
+			list.AddTail(i);
+	}
+	return Time(threads, [&](unsigned int t) {
+		vector<ConcurrentList<int>::Node*> mine;
+		for (unsigned int i = 0; i < operations; i++)
+		{
+			lock.lock();
+			if (i % 2 == 0 || mine.empty())
+				mine.push_back(list.InsertAfter(markers[t], i));
+			else
+			{
+				list.Remove(mine.back());
+				mine.pop_back();
+			}
+			lock.unlock();
+		}
+	});
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int operations = argc > 1 ? atoi(argv[1]) : 20000;
+	unsigned int initial = argc > 2 ? atoi(argv[2]) : 1000;
+
+	cout << "operations per thread: " << operations << "  initial size: " << initial
+		<< "  hardware threads: " << thread::hardware_concurrency() << endl;
+	cout << left << setw(30) << "benchmark" << setw(9) << "threads" << setw(12) << "ns/op" << "Mops/s" << endl;
+
+	const unsigned int counts[] = { 1, 2, 4, 8 };
+	for (unsigned int threads : counts)
+	{
+		Report("index LinkedList+mutex", threads, operations, IndexLinkedList(threads, operations, initial));
+		Report("index ConcurrentList", threads, operations, IndexConcurrentList(threads, operations, initial));
+		Report("regions ConcurrentList+mutex", threads, operations, Regions<mutex>(threads, operations, initial));
+		Report("regions ConcurrentList", threads, operations, Regions<NoLock>(threads, operations, initial));
+	}
+	return 0;
+}
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "FixedLinkedList.h"
+#include "LinkedList.h"
+using namespace std;
+
+// Measures the small-list hot path FixedLinkedList is meant for, against LinkedList with Node and
+// Arena storage: a list that stays at 32 elements while each step adds a Node at the tail, removes
+// the head, inserts in the middle, removes it again and searches the whole list for the new tail.
+// A table of primes is also built at compile time to show the constexpr use.
+// Usage: bench_fixed [steps]
+
+constexpr FixedLinkedList<int, 64> Primes()
+{
+	FixedLinkedList<int, 64> primes;
+	for (int candidate = 2; primes.NodeCount() < 64; candidate++)
+	{
+		bool prime = true;
+		for (const auto* node = primes.Head(); node != nullptr && node->data * node->data <= candidate; node = primes.Next(node))
+			prime &= candidate % node->data != 0;
+		if (prime)
+			primes.AddTail(candidate);
+	}
+	return primes;
+}
+
+constexpr FixedLinkedList<int, 64> primes = Primes();
+static_assert(primes[63] == 311, "the 64th prime");
+
+double Seconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template<typename List>
+void Run(const string& name, unsigned int steps)
+{
+	List list;
+	for (int i = 0; i < 32; i++)
+		list.AddTail(i);
+	long long found = 0;
+	auto start = chrono::steady_clock::now();
+	for (unsigned int i = 0; i < steps; i++)
+	{
+		list.AddTail((int)i);
+		list.RemoveHead();
+		list.InsertAt(-1, 16);
+		list.RemoveAt(16);
+		found += list.Find((int)i) != nullptr;
+	}
+	double seconds = Seconds(start);
+	cout << left << setw(24) << name << setw(12) << fixed << setprecision(1) << seconds * 1e9 / steps
+		<< setw(10) << sizeof(List) << (found == steps ? "" : "error: wrong search results") << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int steps = argc > 1 ? atoi(argv[1]) : 10000000;
+
+	cout << "steps: " << steps << "  (64th prime, computed at compile time: " << primes[63] << ")" << endl;
+	cout << left << setw(24) << "list" << setw(12) << "ns/step" << "sizeof" << endl;
+	Run<LinkedList<int>>("LinkedList Nodes", steps);
+	Run<LinkedList<int, Arena>>("LinkedList Arena", steps);
+	Run<FixedLinkedList<int, 64>>("FixedLinkedList<64>", steps);
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "HugePages.h"
+#include "LinkedList.h"
+using namespace std;
+
+// Measures traversal of a LinkedList whose Nodes are linked in a random order relative to where
+// they sit in memory, so almost every hop lands on another page: Nodes from malloc, from Arena
+// blocks in 4 KB pages, and from HugePages blocks in 2 MB pages. On a machine with huge pages the
+// last needs far fewer dTLB misses per hop.
+// Usage: bench_hugepages [largest list] [default|interleave|<NUMA node>]
+
+double Seconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Returns the kilobytes of anonymous memory the process has in transparent huge pages.
+long AnonHugeKilobytes()
+{
+	FILE* file = fopen("/proc/self/smaps_rollup", "r");
+	if (file == nullptr)
+		return -1;
+	char line[256];
+	long kilobytes = -1;
+	while (fgets(line, sizeof(line), file) != nullptr)
+	{
+		if (strncmp(line, "AnonHugePages:", 14) == 0)
+			kilobytes = atol(line + 14);
+	}
+	fclose(file);
+	return kilobytes;
+}
+
+// Allocates count Nodes in order and links each new one before a random Node already in the list.
+template<typename List>
+void BuildShuffled(List& list, unsigned int count)
+{
+	mt19937 rng(7);
+	vector<typename List::Node*> nodes;
+	nodes.reserve(count);
+	list.AddTail(0);
+	nodes.push_back(list.Head());
+	list.AddTail(1);
+	nodes.push_back(list.Tail());
+	for (unsigned int i = 2; i < count; i++)
+	{
+		// never before the head, so every target has a Node before it
+		typename List::Node* target = nodes[1 + rng() % (nodes.size() - 1)];
+		list.InsertBefore(target, i);
+		nodes.push_back(target->prev);
+	}
+}
+
+// Walks the list until at least minSeconds have passed and returns nanoseconds per hop.
+template<typename List>
+double Traverse(const List& list, double minSeconds)
+{
+	unsigned long long hops = 0;
+	long long sum = 0;
+	auto start = chrono::steady_clock::now();
+	do
+	{
+		for (const typename List::Node* node = list.Head(); node != nullptr; node = node->next)
+			sum += node->data;
+		hops += list.NodeCount();
+	} while (Seconds(start) < minSeconds);
+	double seconds = Seconds(start);
+	if (sum == 42)
+		cout << "";
+	return seconds * 1e9 / hops;
+}
+
+template<typename List>
+void Run(const string& name, List& list, unsigned int count, long hugeBefore)
+{
+	BuildShuffled(list, count);
+	double nanoseconds = Traverse(list, 0.5);
+	long huge = AnonHugeKilobytes() - hugeBefore;
+	cout << left << setw(14) << name << setw(12) << count << setw(12) << fixed << setprecision(2) << nanoseconds
+		<< (huge >= 0 ? to_string(huge / 1024) : string("?")) << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int largest = argc > 1 ? atoi(argv[1]) : 16 << 20;
+	string placement = argc > 2 ? argv[2] : "default";
+
+	cout << left << setw(14) << "storage" << setw(12) << "nodes" << setw(12) << "ns/hop" << "THP MB" << endl;
+	for (unsigned int count = 1 << 16; count <= largest; count *= 4)
+	{
+		{
+			LinkedList<long long> list;
+			Run("malloc", list, count, AnonHugeKilobytes());
+		}
+		{
+			LinkedList<long long, Arena> list;
+			Run("Arena 4K", list, count, AnonHugeKilobytes());
+		}
+		{
+			LinkedList<long long, HugePages> list;
+			if (placement == "interleave")
+				list.NodeAllocator().SetPlacement(NumaPlacement::Interleaved());
+			else if (placement != "default")
+				list.NodeAllocator().SetPlacement(NumaPlacement::OnNode(atoi(placement.c_str())));
+			Run("HugePages", list, count, AnonHugeKilobytes());
+			if (count * 4 > largest)
+				cout << "huge page blocks: " << list.NodeAllocator().HugeBlocks() << " reserved, "
+					<< list.NodeAllocator().AdvisedBlocks() << " transparent, "
+					<< list.NodeAllocator().PlacedBlocks() << " NUMA placed" << endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include "LinkedList.h"
+#include "Ingest.h"
+using namespace std;
+
+// Measures loading a text file into a LinkedList, one Node per token: getline and AddTail as
+// main4.cpp does, the block loaders of Ingest.h into a LinkedList<string>, and into a
+// LinkedList<string_view> backed by a StringArena (mapping the file, or reading it as a pipe
+// would be read) or by a mapping the caller keeps.
+// The file is generated first and read back from the page cache.
+// Usage: bench_ingest [megabytes] [words|lines] [file]
+
+// Writes log-like lines of about 100 bytes until the file holds the requested size.
+void MakeInput(const string& path, size_t bytes)
+{
+	const char* levels[] = { "INFO", "WARN", "DEBUG", "ERROR" };
+	const char* words[] = { "request", "served", "cache", "miss", "user", "session", "timeout",
+		"retry", "connection", "closed", "queue", "depth", "latency", "ms", "bytes" };
+	mt19937 rng(1);
+	ofstream out(path, ios::binary);
+	string line;
+	size_t written = 0;
+	for (unsigned long long i = 0; written < bytes; i++)
+	{
+		line = "2026-10-19T12:00:" + to_string(i % 60) + "Z " + levels[rng() % 4] + " worker-" + to_string(rng() % 64);
+		while (line.size() < 90)
+			line += string(" ") + words[rng() % 15];
+		line += '\n';
+		out << line;
+		written += line.size();
+	}
+}
+
+double Seconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void Report(const string& name, double seconds, size_t bytes, unsigned int tokens)
+{
+	cout << left << setw(30) << name << setw(12) << fixed << setprecision(3) << seconds
+		<< setw(10) << setprecision(2) << bytes / seconds / 1e9 << setprecision(1) << seconds * 1e9 / tokens << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 256;
+	char delimiter = argc > 2 && string(argv[2]) == "words" ? ' ' : '\n';
+	string path = argc > 3 ? argv[3] : "bench_ingest.tmp";
+
+	MakeInput(path, megabytes << 20);
+	struct stat info;
+	stat(path.c_str(), &info);
+	size_t bytes = (size_t)info.st_size;
+	cout << "input: " << megabytes << " MB  tokens: " << (delimiter == ' ' ? "words" : "lines") << endl;
+	cout << left << setw(30) << "loader" << setw(12) << "seconds" << setw(10) << "GB/s" << "ns/token" << endl;
+
+	unsigned int tokens;
+	{
+		auto start = chrono::steady_clock::now();
+		LinkedList<string> list;
+		ifstream in(path, ios::binary);
+		string token;
+		while (getline(in, token, delimiter))
+			list.AddTail(token);
+		tokens = list.NodeCount();
+		Report("getline + AddTail", Seconds(start), bytes, tokens);
+	}
+	{
+		auto start = chrono::steady_clock::now();
+		LinkedList<string> list;
+		if (!IngestFile(path, list, delimiter) || list.NodeCount() != tokens)
+			cout << "error: IngestFile<string> read " << list.NodeCount() << " tokens" << endl;
+		Report("IngestFile string", Seconds(start), bytes, tokens);
+	}
+	{
+		auto start = chrono::steady_clock::now();
+		StringArena arena;
+		LinkedList<string_view> list;
+		if (!IngestFile(path, list, arena, delimiter) || list.NodeCount() != tokens)
+			cout << "error: IngestFile<string_view> read " << list.NodeCount() << " tokens" << endl;
+		Report("IngestFile string_view+arena", Seconds(start), bytes, tokens);
+	}
+	{
+		auto start = chrono::steady_clock::now();
+		StringArena arena;
+		LinkedList<string_view> list;
+		int fd = open(path.c_str(), O_RDONLY);
+		if (!IngestTokens(fd, list, arena, delimiter) || list.NodeCount() != tokens)
+			cout << "error: IngestTokens<string_view> read " << list.NodeCount() << " tokens" << endl;
+		close(fd);
+		Report("read() string_view+arena", Seconds(start), bytes, tokens);
+	}
+	{
+		auto start = chrono::steady_clock::now();
+		int fd = open(path.c_str(), O_RDONLY);
+		void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		LinkedList<string_view> list;
+		if (mapped != MAP_FAILED)
+			IngestTokens(static_cast<const char*>(mapped), bytes, list, delimiter);
+		if (list.NodeCount() != tokens)
+			cout << "error: mapped IngestTokens read " << list.NodeCount() << " tokens" << endl;
+		Report("mmap string_view", Seconds(start), bytes, tokens);
+		list.Clear();
+		if (mapped != MAP_FAILED)
+			munmap(mapped, bytes);
+	}
+
+	remove(path.c_str());
+	return 0;
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Measures the cost leaker adds to operator new/delete as the number of allocating threads grows,
+// tracking everything and in sampling mode, then the latency of single allocations while the live
+// set grows to millions of entries.
+// Usage: bench_leaker [pairs per thread] [live allocations per thread] [max threads] [latency live]
+//        [sample rate in bytes]
+
+// untracked baseline, defined before leaker.h replaces malloc and free
+static void* RawAllocate(size_t size) { return malloc(size); }
+static void RawRelease(void* ptr) { free(ptr); }
+
+#include "leaker.h"
+#include "leaker.cpp"
+
+const size_t nodeBytes = 24;	// a LinkedList<int>::Node
+
+// Each thread keeps live allocations outstanding and replaces the oldest one pairs times.
+template<typename Allocate, typename Release>
+double Run(unsigned int threads, unsigned int pairs, unsigned int live, Allocate allocate, Release release)
+{
+	vector<thread> workers;
+	auto start = chrono::steady_clock::now();
+	for (unsigned int t = 0; t < threads; t++)
+	{
+		workers.emplace_back([=]() {
+			vector<void*> ring(live);
+			for (unsigned int i = 0; i < live; i++)
+				ring[i] = allocate();
+			for (unsigned int i = 0; i < pairs; i++)
+			{
+				unsigned int slot = i % live;
+				release(ring[slot]);
+				ring[slot] = allocate();
+			}
+			for (unsigned int i = 0; i < live; i++)
+				release(ring[i]);
+		});
+	}
+	for (thread& worker : workers)
+		worker.join();
+	auto stop = chrono::steady_clock::now();
+	return chrono::duration<double, nano>(stop - start).count() / ((double)threads * (pairs + live));
+}
+
+// Allocates live blocks without releasing any, timing each call on its own.
+template<typename Allocate, typename Release>
+vector<double> Latencies(unsigned int live, Allocate allocate, Release release)
+{
+	vector<void*> blocks(live);
+	vector<double> ns(live);
+	for (unsigned int i = 0; i < live; i++)
+	{
+		auto start = chrono::steady_clock::now();
+		blocks[i] = allocate();
+		auto stop = chrono::steady_clock::now();
+		ns[i] = chrono::duration<double, nano>(stop - start).count();
+	}
+	for (unsigned int i = 0; i < live; i++)
+		release(blocks[i]);
+	return ns;
+}
+
+void ReportLatencies(const string& name, vector<double> ns)
+{
+	double total = 0;
+	size_t slow = 0;	// samples long enough to be a slab allocation or stall rather than scheduling noise
+	for (double sample : ns)
+	{
+		total += sample;
+		if (sample > 50000)
+			slow++;
+	}
+	sort(ns.begin(), ns.end());
+	cout << left << setw(11) << name << setw(10) << fixed << setprecision(1) << total / ns.size()
+		<< setw(10) << ns[ns.size() * 99 / 100] << setw(10) << ns[ns.size() * 999 / 1000]
+		<< setw(12) << ns.back() << slow << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int pairs = argc > 1 ? atoi(argv[1]) : 1000000;
+	unsigned int live = argc > 2 ? atoi(argv[2]) : 4096;
+	unsigned int maxThreads = argc > 3 ? atoi(argv[3]) : 16;
+	unsigned int latencyLive = argc > 4 ? atoi(argv[4]) : 2000000;
+	size_t sampleRate = argc > 5 ? strtoul(argv[5], nullptr, 10) : 512 * 1024;
+
+	cout << "pairs per thread: " << pairs << "  live per thread: " << live
+		<< "  sample rate: " << sampleRate << "  hardware threads: " << thread::hardware_concurrency() << endl;
+	cout << left << setw(9) << "threads" << setw(16) << "untracked ns" << setw(14) << "tracked ns" << setw(9) << "ratio"
+		<< setw(14) << "sampled ns" << "ratio" << endl;
+
+	for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		double untracked = Run(threads, pairs, live,
+			[]() { return RawAllocate(nodeBytes); },
+			[](void* ptr) { RawRelease(ptr); });
+		double tracked = Run(threads, pairs, live,
+			[]() { return (void*)new char[nodeBytes]; },
+			[](void* ptr) { delete[] (char*)ptr; });
+		_Leaker_Set_Sample_Rate(sampleRate);
+		double sampled = Run(threads, pairs, live,
+			[]() { return (void*)new char[nodeBytes]; },
+			[](void* ptr) { delete[] (char*)ptr; });
+		_Leaker_Set_Sample_Rate(0);
+		cout << left << setw(9) << threads << setw(16) << fixed << setprecision(1) << untracked
+			<< setw(14) << tracked << setprecision(2) << setw(9) << tracked / untracked
+			<< setw(14) << setprecision(1) << sampled << setprecision(2) << sampled / untracked << endl;
+	}
+
+	cout << endl << "per-allocation latency, growing to " << latencyLive << " live allocations" << endl;
+	cout << left << setw(11) << "" << setw(10) << "mean ns" << setw(10) << "p99 ns" << setw(10) << "p99.9 ns" << setw(12) << "max ns" << "> 50 us" << endl;
+	ReportLatencies("untracked", Latencies(latencyLive,
+		[]() { return RawAllocate(nodeBytes); },
+		[](void* ptr) { RawRelease(ptr); }));
+	ReportLatencies("tracked", Latencies(latencyLive,
+		[]() { return (void*)new char[nodeBytes]; },
+		[](void* ptr) { delete[] (char*)ptr; }));
+	return 0;
+}
@@ -0,0 +1,534 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LinkedList.h"
+using namespace std;
+
+// Google-benchmark style micro-benchmarks of every LinkedList operation, for int, double, a
+// 16-byte POD, string and a 64-byte POD at sizes from 100 up to a maximum. Each benchmark repeats its loop with more
+// iterations until one run takes the minimum time, then reports the median of the repetitions.
+// Results go to stdout as a table and, when a path is given, to a JSON file ("-" for stdout).
+// Built with -DLINKEDLIST_PERF it also prints hardware counters per operation group (PerfCounters.h).
+// Usage: bench_list [max size] [min ms per run] [repetitions] [json path] [name filter]
+
+
+/* ---------- HARNESS ---------- */
+
+// Timing and counters for one run of a benchmark, modelled on benchmark::State.
+class State {
+	unsigned int size;				// number of Nodes the benchmark works on
+	size_t iterations;				// times the benchmark must repeat its operation
+	size_t items;					// elements processed, for ns/op and throughput
+	double elapsed;					// timed nanoseconds so far
+	chrono::steady_clock::time_point start;
+	bool running;
+
+	public:
+
+	State(unsigned int listSize, size_t count) {
+		size = listSize;
+		iterations = count;
+		items = count;
+		elapsed = 0;
+		running = false;
+	}
+
+	unsigned int Size() const { return size; }
+	size_t Iterations() const { return iterations; }
+	size_t Items() const { return items; }
+	double Elapsed() const { return elapsed; }
+
+	// Sets how many elements the run processed, when an iteration handles more than one.
+	void SetItemsProcessed(size_t count) { items = count; }
+
+	// Starts or restarts the clock; the harness starts it before calling the benchmark.
+	void ResumeTiming()
+	{
+		start = chrono::steady_clock::now();
+		running = true;
+	}
+
+	// Stops the clock, e.g. while the benchmark rebuilds a list it has used up.
+	void PauseTiming()
+	{
+		if (running)
+			elapsed += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+		running = false;
+	}
+};
+
+// Keeps the compiler from discarding a result the benchmark does not otherwise use.
+template<typename V>
+inline void DoNotOptimize(const V& value)
+{
+#ifdef _MSC_VER
+	volatile const char* sink = reinterpret_cast<const volatile char*>(&value);
+	(void)sink;
+#else
+	asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
+
+struct Benchmark {
+	string operation;
+	string type;
+	unsigned int size;
+	size_t elementBytes;			// sizeof the element type, for bytes/s
+	function<void(State&)> run;
+};
+
+struct Result {
+	string name;
+	const Benchmark* benchmark;
+	size_t iterations;
+	double nsPerIteration;			// median over the repetitions
+	double nsPerItem;
+	double itemsPerSecond;
+	double bytesPerSecond;
+};
+
+// Returns the name a benchmark is reported and filtered by, e.g. "Find<int>/1000".
+string Name(const Benchmark& benchmark)
+{
+	return benchmark.operation + "<" + benchmark.type + ">/" + to_string(benchmark.size);
+}
+
+// Runs benchmark once with the given number of iterations and returns its State.
+State RunOnce(const Benchmark& benchmark, size_t iterations)
+{
+	State state(benchmark.size, iterations);
+	state.ResumeTiming();
+	benchmark.run(state);
+	state.PauseTiming();
+	return state;
+}
+
+// Grows the iteration count until a run lasts minNs, then times the requested repetitions.
+Result Measure(const Benchmark& benchmark, double minNs, unsigned int repetitions)
+{
+	size_t iterations = 1;
+	State state = RunOnce(benchmark, iterations);
+	while (state.Elapsed() < minNs && iterations < 1000000000)
+	{
+		double multiplier = state.Elapsed() <= minNs / 10 ? 10 : 1.4 * minNs / state.Elapsed();
+		iterations = max(iterations + 1, (size_t)(iterations * multiplier));
+		state = RunOnce(benchmark, iterations);
+	}
+
+	vector<double> perIteration(1, state.Elapsed() / iterations);
+	size_t items = state.Items();
+	for (unsigned int r = 1; r < repetitions; r++)
+		perIteration.push_back(RunOnce(benchmark, iterations).Elapsed() / iterations);
+	sort(perIteration.begin(), perIteration.end());
+
+	Result result;
+	result.name = Name(benchmark);
+	result.benchmark = &benchmark;
+	result.iterations = iterations;
+	result.nsPerIteration = perIteration[perIteration.size() / 2];
+	double itemsPerIteration = (double)items / iterations;
+	result.nsPerItem = result.nsPerIteration / itemsPerIteration;
+	result.itemsPerSecond = 1e9 / result.nsPerItem;
+	result.bytesPerSecond = result.itemsPerSecond * benchmark.elementBytes;
+	return result;
+}
+
+void WriteJson(ostream& out, const vector<Result>& results, unsigned int maxSize, double minMs,
+	unsigned int repetitions)
+{
+	time_t now = time(nullptr);
+	char date[32];
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+	out << "{\n  \"context\": {\n"
+		<< "    \"date\": \"" << date << "\",\n"
+		<< "    \"num_cpus\": " << thread::hardware_concurrency() << ",\n"
+		<< "    \"max_size\": " << maxSize << ",\n"
+		<< "    \"min_time_ms\": " << minMs << ",\n"
+		<< "    \"repetitions\": " << repetitions << "\n"
+		<< "  },\n  \"benchmarks\": [";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result& result = results[i];
+		out << (i == 0 ? "\n" : ",\n") << fixed << setprecision(3)
+			<< "    {\"name\": \"" << result.name << "\", \"operation\": \"" << result.benchmark->operation
+			<< "\", \"type\": \"" << result.benchmark->type << "\", \"size\": " << result.benchmark->size
+			<< ", \"iterations\": " << result.iterations << ", \"real_time\": " << result.nsPerIteration
+			<< ", \"time_unit\": \"ns\", \"ns_per_op\": " << result.nsPerItem
+			<< ", \"items_per_second\": " << setprecision(0) << result.itemsPerSecond
+			<< ", \"bytes_per_second\": " << result.bytesPerSecond << "}";
+	}
+	out << "\n  ]\n}\n";
+}
+
+
+/* ---------- ELEMENT TYPES ---------- */
+
+// A large POD element: compared by key, the payload only adds size.
+struct Record {
+	long long key;
+	char payload[56];
+
+	bool operator==(const Record& rhs) const { return key == rhs.key; }
+	bool operator!=(const Record& rhs) const { return key != rhs.key; }
+};
+
+// A small POD element of two 8-byte fields.
+struct Pair {
+	long long key;
+	long long value;
+
+	bool operator==(const Pair& rhs) const { return key == rhs.key && value == rhs.value; }
+	bool operator!=(const Pair& rhs) const { return !(*this == rhs); }
+};
+
+// Distinct values for each element type, so Find and Remove can target single Nodes.
+template<typename T> T MakeValue(unsigned int i);
+template<> int MakeValue<int>(unsigned int i) { return (int)i; }
+template<> double MakeValue<double>(unsigned int i) { return i * 0.5; }
+template<> Pair MakeValue<Pair>(unsigned int i) { return Pair{ (long long)i, -(long long)i }; }
+template<> string MakeValue<string>(unsigned int i) { return "value" + to_string(i); }
+template<> Record MakeValue<Record>(unsigned int i)
+{
+	Record record;
+	record.key = i;
+	fill(record.payload, record.payload + sizeof(record.payload), (char)i);
+	return record;
+}
+
+// Fills list with the values 0 to count - 1.
+template<typename T>
+void Fill(LinkedList<T>& list, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; i++)
+		list.AddTail(MakeValue<T>(i));
+}
+
+// Random positions, drawn once, that lookups cycle through.
+vector<unsigned int> Positions(unsigned int size)
+{
+	mt19937 rng(size);
+	vector<unsigned int> positions(1024);
+	for (unsigned int& position : positions)
+		position = rng() % size;
+	return positions;
+}
+
+
+/* ---------- BENCHMARKS ---------- */
+// Operations that change the size of the list run in batches that keep it within a tenth of
+// the benchmark size; the list is restored between batches with the clock paused.
+
+template<typename T>
+void AddHead(State& state)
+{
+	for (size_t i = 0; i < state.Iterations(); i++)
+	{
+		LinkedList<T>* list = new LinkedList<T>();
+		for (unsigned int n = 0; n < state.Size(); n++)
+			list->AddHead(MakeValue<T>(n));
+		state.PauseTiming();
+		delete list;
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.Iterations() * state.Size());
+}
+
+template<typename T>
+void AddTail(State& state)
+{
+	for (size_t i = 0; i < state.Iterations(); i++)
+	{
+		LinkedList<T>* list = new LinkedList<T>();
+		for (unsigned int n = 0; n < state.Size(); n++)
+			list->AddTail(MakeValue<T>(n));
+		state.PauseTiming();
+		delete list;
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.Iterations() * state.Size());
+}
+
+template<typename T>
+void AddNodesTail(State& state)
+{
+	state.PauseTiming();
+	vector<T> values;
+	for (unsigned int n = 0; n < state.Size(); n++)
+		values.push_back(MakeValue<T>(n));
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); i++)
+	{
+		LinkedList<T>* list = new LinkedList<T>();
+		list->AddNodesTail(values.data(), state.Size());
+		state.PauseTiming();
+		delete list;
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.Iterations() * state.Size());
+}
+
+// Inserts at the middle; the walk to the index is the same however long the list has grown.
+template<typename T>
+void InsertAt(State& state)
+{
+	state.PauseTiming();
+	LinkedList<T> list;
+	Fill(list, state.Size());
+	unsigned int index = state.Size() / 2;
+	unsigned int batch = max(state.Size() / 10, 1u);
+	T value = MakeValue<T>(state.Size());
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); i++)
+	{
+		list.InsertAt(value, index);
+		if ((i + 1) % batch == 0)
+		{
+			state.PauseTiming();
+			for (unsigned int n = 0; n < batch; n++)
+				list.RemoveTail();
+			state.ResumeTiming();
+		}
+	}
+}
+
+template<typename T>
+void GetNode(State& state)
+{
+	state.PauseTiming();
+	LinkedList<T> list;
+	Fill(list, state.Size());
+	vector<unsigned int> positions = Positions(state.Size());
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); i++)
+		DoNotOptimize(list.GetNode(positions[i % positions.size()]));
+}
+
+template<typename T>
+void Subscript(State& state)
+{
+	state.PauseTiming();
+	LinkedList<T> list;
+	Fill(list, state.Size());
+	vector<unsigned int> positions = Positions(state.Size());
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); i++)
+		DoNotOptimize(list[positions[i % positions.size()]]);
+}
+
+template<typename T>
+void Find(State& state)
+{
+	state.PauseTiming();
+	LinkedList<T> list;
+	Fill(list, state.Size());
+	vector<T> values;
+	for (unsigned int position : Positions(state.Size()))
+		values.push_back(MakeValue<T>(position));
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); i++)
+		DoNotOptimize(list.Find(values[i % values.size()]));
+}
+
+// Every tenth Node matches; FindAll always walks the whole list.
+template<typename T>
+void FindAll(State& state)
+{
+	state.PauseTiming();
+	LinkedList<T> list;
+	for (unsigned int n = 0; n < state.Size(); n++)
+		list.AddTail(MakeValue<T>(n % 10));
+	T value = MakeValue<T>(0);
+	vector<typename LinkedList<T>::Node*> found;
+	found.reserve(state.Size() / 10 + 1);
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); i++)
+	{
+		found.clear();
+		list.FindAll(found, value);
+		DoNotOptimize(found.data());
+	}
+}
+
+// Removes one distinct value per iteration; Remove always walks the whole list.
+template<typename T>
+void Remove(State& state)
+{
+	state.PauseTiming();
+	LinkedList<T> list;
+	Fill(list, state.Size());
+	vector<T> values;
+	for (unsigned int position : Positions(state.Size()))
+		values.push_back(MakeValue<T>(position));
+	unsigned int batch = max(state.Size() / 10, 1u);
+	vector<T> removed;
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); i++)
+	{
+		const T& value = values[i % values.size()];
+		if (list.Remove(value) > 0)
+			removed.push_back(value);
+		if ((i + 1) % batch == 0)
+		{
+			state.PauseTiming();
+			for (const T& back : removed)
+				list.AddTail(back);
+			removed.clear();
+			state.ResumeTiming();
+		}
+	}
+}
+
+// Removes from the middle of a list that starts a batch longer than the benchmark size.
+template<typename T>
+void RemoveAt(State& state)
+{
+	state.PauseTiming();
+	unsigned int batch = max(state.Size() / 10, 1u);
+	LinkedList<T> list;
+	Fill(list, state.Size() + batch);
+	unsigned int index = state.Size() / 2;
+	T value = MakeValue<T>(state.Size());
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); i++)
+	{
+		list.RemoveAt(index);
+		if ((i + 1) % batch == 0)
+		{
+			state.PauseTiming();
+			for (unsigned int n = 0; n < batch; n++)
+				list.AddTail(value);
+			state.ResumeTiming();
+		}
+	}
+}
+
+template<typename T>
+void Clear(State& state)
+{
+	for (size_t i = 0; i < state.Iterations(); i++)
+	{
+		state.PauseTiming();
+		LinkedList<T> list;
+		Fill(list, state.Size());
+		state.ResumeTiming();
+		list.Clear();
+	}
+	state.SetItemsProcessed(state.Iterations() * state.Size());
+}
+
+template<typename T>
+void CopyConstruct(State& state)
+{
+	state.PauseTiming();
+	LinkedList<T> source;
+	Fill(source, state.Size());
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); i++)
+	{
+		LinkedList<T>* copy = new LinkedList<T>(source);
+		state.PauseTiming();
+		delete copy;
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.Iterations() * state.Size());
+}
+
+// Assigns over a list of the same size, so each iteration clears and copies size Nodes.
+template<typename T>
+void Assign(State& state)
+{
+	state.PauseTiming();
+	LinkedList<T> source;
+	LinkedList<T> target;
+	Fill(source, state.Size());
+	Fill(target, state.Size());
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); i++)
+	{
+		target = source;
+		DoNotOptimize(target);
+	}
+	state.SetItemsProcessed(state.Iterations() * state.Size());
+}
+
+// Adds a benchmark of every operation on lists of T for each size.
+template<typename T>
+void Register(vector<Benchmark>& benchmarks, const string& type, const vector<unsigned int>& sizes)
+{
+	const pair<string, void (*)(State&)> operations[] = {
+		{ "AddHead", AddHead<T> }, { "AddTail", AddTail<T> }, { "AddNodesTail", AddNodesTail<T> },
+		{ "InsertAt", InsertAt<T> }, { "GetNode", GetNode<T> }, { "operator[]", Subscript<T> },
+		{ "Find", Find<T> }, { "FindAll", FindAll<T> }, { "Remove", Remove<T> },
+		{ "RemoveAt", RemoveAt<T> }, { "Clear", Clear<T> }, { "CopyConstruct", CopyConstruct<T> },
+		{ "operator=", Assign<T> }
+	};
+	for (const auto& operation : operations)
+		for (unsigned int size : sizes)
+			benchmarks.push_back(Benchmark{ operation.first, type, size, sizeof(T), operation.second });
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int maxSize = argc > 1 ? (unsigned int)atof(argv[1]) : 10000000;
+	double minMs = argc > 2 ? atof(argv[2]) : 200;
+	unsigned int repetitions = argc > 3 ? max(atoi(argv[3]), 1) : 3;
+	string jsonPath = argc > 4 ? argv[4] : "";
+	string filter = argc > 5 ? argv[5] : "";
+
+	vector<unsigned int> sizes;
+	for (unsigned int size = 100; size <= maxSize; size *= 10)
+	{
+		sizes.push_back(size);
+		if (size > maxSize / 10)
+			break;
+	}
+
+	vector<Benchmark> benchmarks;
+	Register<int>(benchmarks, "int", sizes);
+	Register<double>(benchmarks, "double", sizes);
+	Register<Pair>(benchmarks, "Pair16", sizes);
+	Register<string>(benchmarks, "string", sizes);
+	Register<Record>(benchmarks, "Record64", sizes);
+
+	// the table goes to stderr when the JSON is written to stdout
+	ostream& table = jsonPath == "-" ? cerr : cout;
+	table << "max size: " << maxSize << "  min ms per run: " << minMs << "  repetitions: " << repetitions << endl;
+	table << left << setw(34) << "benchmark" << setw(12) << "iterations" << setw(18) << "ns/iteration"
+		<< setw(18) << "ns/op" << "items/s" << endl;
+
+	vector<Result> results;
+	for (const Benchmark& benchmark : benchmarks)
+	{
+		if (!filter.empty() && Name(benchmark).find(filter) == string::npos)
+			continue;
+		PerfCounters::Instance().Reset();
+		Result result = Measure(benchmark, minMs * 1e6, repetitions);
+		results.push_back(result);
+		table << left << setw(34) << result.name << setw(12) << result.iterations
+			<< setw(18) << fixed << setprecision(1) << result.nsPerIteration
+			<< setw(18) << setprecision(2) << result.nsPerItem << setprecision(0) << result.itemsPerSecond << endl;
+		// hardware counters for the benchmark's operations and its setup, when built with LINKEDLIST_PERF
+		PerfCounters::Instance().Report(table, "    ");
+	}
+
+	if (jsonPath == "-")
+		WriteJson(cout, results, maxSize, minMs, repetitions);
+	else if (!jsonPath.empty())
+	{
+		ofstream json(jsonPath);
+		WriteJson(json, results, maxSize, minMs, repetitions);
+		if (!json)
+			cerr << "could not write " << jsonPath << endl;
+	}
+	return 0;
+}
@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "LinkedList.h"
+using namespace std;
+
+// Measures the time per hop of full traversals with SetPrefetch at several distances, on lists
+// whose Nodes are linked in a random order relative to where they sit in memory, so every hop is
+// a cache miss the hardware prefetchers cannot predict: Find for a missing value (Search), GetNode
+// of the tail, operator== of two equal lists, and Clear. Distance 0 is the plain pointer chase.
+// The first traversal after SetPrefetch records the path and is not timed.
+// Usage: bench_prefetch [nodes] [repetitions]
+
+double Seconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Allocates count Nodes in order and links each new one before a random Node already in the list.
+void BuildShuffled(LinkedList<long long>& list, unsigned int count, unsigned int seed)
+{
+	mt19937 rng(seed);
+	vector<LinkedList<long long>::Node*> nodes;
+	nodes.reserve(count);
+	list.AddTail(0);
+	nodes.push_back(list.Head());
+	list.AddTail(0);
+	nodes.push_back(list.Tail());
+	for (unsigned int i = 2; i < count; i++)
+	{
+		// never before the head, so every target has a Node before it
+		LinkedList<long long>::Node* target = nodes[1 + rng() % (nodes.size() - 1)];
+		list.InsertBefore(target, 0);
+		nodes.push_back(target->prev);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int count = argc > 1 ? atoi(argv[1]) : 4 << 20;
+	unsigned int repetitions = argc > 2 ? atoi(argv[2]) : 3;
+	unsigned int distances[] = { 0, 1, 2, 4, 8, 16, 32 };
+
+	cout << "nodes: " << count << "  (ns per hop)" << endl;
+	cout << left << setw(10) << "distance" << setw(10) << "Search" << setw(10) << "GetNode" << setw(12) << "operator=="
+		<< "Clear" << endl;
+	for (unsigned int distance : distances)
+	{
+		LinkedList<long long> list;
+		LinkedList<long long> other;
+		BuildShuffled(list, count, 1);
+		BuildShuffled(other, count, 2);
+		list.SetPrefetch(distance);
+		other.SetPrefetch(distance);
+		bool equal = list == other;
+
+		auto start = chrono::steady_clock::now();
+		for (unsigned int i = 0; i < repetitions; i++)
+			equal &= list.Find(1) == nullptr;
+		double search = Seconds(start) * 1e9 / repetitions / count;
+
+		start = chrono::steady_clock::now();
+		for (unsigned int i = 0; i < repetitions; i++)
+			equal &= list.GetNode(count - 1) == list.Tail();
+		double getNode = Seconds(start) * 1e9 / repetitions / count;
+
+		start = chrono::steady_clock::now();
+		for (unsigned int i = 0; i < repetitions; i++)
+			equal &= list == other;
+		double compare = Seconds(start) * 1e9 / repetitions / count;
+
+		start = chrono::steady_clock::now();
+		list.Clear();
+		double clear = Seconds(start) * 1e9 / count;
+
+		if (!equal)
+			cout << "error: traversal results differ" << endl;
+		cout << left << setw(10) << distance << setw(10) << fixed << setprecision(1) << search << setw(10) << getNode
+			<< setw(12) << compare << clear << endl;
+	}
+	return 0;
+}
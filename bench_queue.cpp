@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LinkedList.h"
+#include "ConcurrentQueue.h"
+using namespace std;
+
+// Measures throughput and enqueue-to-dequeue latency of ConcurrentQueue against a LinkedList
+// guarded by one mutex, for a range of producer and consumer counts.
+// Usage: bench_queue [items per producer] [capacity] [batch]
+
+// the coarse-lock work queue ConcurrentQueue replaces
+class LockedQueue {
+	LinkedList<long long> list;
+	mutex lock;
+	condition_variable notEmpty;
+	bool closed = false;
+
+	public:
+
+	explicit LockedQueue(unsigned int) {}
+
+	bool AddTail(const long long& data) {
+		lock_guard<mutex> guard(lock);
+		list.AddTail(data);
+		notEmpty.notify_one();
+		return true;
+	}
+
+	unsigned int AddNodesTail(const long long* data, unsigned int count) {
+		lock_guard<mutex> guard(lock);
+		list.AddNodesTail(data, count);
+		notEmpty.notify_all();
+		return count;
+	}
+
+	bool RemoveHead(long long& outData) {
+		unique_lock<mutex> guard(lock);
+		while (list.NodeCount() == 0 && !closed)
+			notEmpty.wait(guard);
+		if (list.NodeCount() == 0)
+			return false;
+		outData = list.Head()->data;
+		list.RemoveHead();
+		return true;
+	}
+
+	unsigned int RemoveNodesHead(long long* outData, unsigned int count) {
+		unique_lock<mutex> guard(lock);
+		while (list.NodeCount() == 0 && !closed)
+			notEmpty.wait(guard);
+		unsigned int removed = 0;
+		while (removed < count && list.NodeCount() > 0)
+		{
+			outData[removed++] = list.Head()->data;
+			list.RemoveHead();
+		}
+		return removed;
+	}
+
+	void Close() {
+		lock_guard<mutex> guard(lock);
+		closed = true;
+		notEmpty.notify_all();
+	}
+};
+
+long long Now()
+{
+	return chrono::duration_cast<chrono::nanoseconds>(
+		chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename Queue>
+void Run(const string& name, unsigned int producers, unsigned int consumers,
+	unsigned int items, unsigned int capacity, unsigned int batch)
+{
+	Queue queue(capacity);
+	vector<vector<long long>> latencies(consumers);
+	vector<thread> threads;
+
+	long long start = Now();
+	for (unsigned int c = 0; c < consumers; c++)
+	{
+		threads.emplace_back([&queue, &latencies, c, batch]() {
+			vector<long long> buffer(batch);
+			unsigned int seen = 0;
+			unsigned int removed;
+			while ((removed = queue.RemoveNodesHead(buffer.data(), batch)) > 0)
+			{
+				long long now = Now();
+				for (unsigned int i = 0; i < removed; i++)
+				{
+					if ((seen++ & 63) == 0)
+						latencies[c].push_back(now - buffer[i]);
+				}
+			}
+		});
+	}
+
+	vector<thread> producerThreads;
+	for (unsigned int p = 0; p < producers; p++)
+	{
+		producerThreads.emplace_back([&queue, items, batch]() {
+			vector<long long> buffer(batch);
+			for (unsigned int sent = 0; sent < items; sent += batch)
+			{
+				unsigned int count = min(batch, items - sent);
+				long long now = Now();
+				for (unsigned int i = 0; i < count; i++)
+					buffer[i] = now;
+				queue.AddNodesTail(buffer.data(), count);
+			}
+		});
+	}
+	for (thread& producer : producerThreads)
+		producer.join();
+	queue.Close();
+	for (thread& consumer : threads)
+		consumer.join();
+	long long elapsed = Now() - start;
+
+	vector<long long> all;
+	for (vector<long long>& samples : latencies)
+		all.insert(all.end(), samples.begin(), samples.end());
+	sort(all.begin(), all.end());
+	long long p50 = all.empty() ? 0 : all[all.size() / 2];
+	long long p99 = all.empty() ? 0 : all[all.size() * 99 / 100];
+
+	double total = (double)producers * items;
+	cout << left << setw(18) << name << setw(6) << producers << setw(6) << consumers
+		<< setw(12) << fixed << setprecision(2) << total / elapsed * 1000.0
+		<< setw(12) << p50 << p99 << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int items = argc > 1 ? atoi(argv[1]) : 1000000;
+	unsigned int capacity = argc > 2 ? atoi(argv[2]) : 4096;
+	unsigned int batch = argc > 3 ? atoi(argv[3]) : 1;
+	if (batch == 0)
+		batch = 1;
+
+	cout << "items per producer: " << items << "  capacity: " << capacity
+		<< "  batch: " << batch << "  hardware threads: " << thread::hardware_concurrency() << endl;
+	cout << left << setw(18) << "queue" << setw(6) << "prod" << setw(6) << "cons"
+		<< setw(12) << "Mitems/s" << setw(12) << "p50 ns" << "p99 ns" << endl;
+
+	const unsigned int counts[] = { 1, 2, 4, 8 };
+	for (unsigned int producers : counts)
+	{
+		for (unsigned int consumers : counts)
+		{
+			Run<LockedQueue>("LinkedList+mutex", producers, consumers, items, capacity, batch);
+			Run<ConcurrentQueue<long long>>("ConcurrentQueue", producers, consumers, items, capacity, batch);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,133 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LinkedList.h"
+#include "RcuList.h"
+using namespace std;
+
+// Measures lookup throughput of RcuList against a LinkedList behind a reader-writer lock while
+// one writer keeps replacing, inserting and removing Nodes.
+// Usage: bench_rcu [keys] [milliseconds per run] [writer pause in microseconds]
+
+struct Result {
+	double reads;		// lookups per second, all readers together
+	double writes;		// updates per second
+};
+
+template<typename Lookup, typename Update>
+Result Run(unsigned int readers, unsigned int keys, unsigned int milliseconds,
+	unsigned int pause, Lookup lookup, Update update)
+{
+	atomic<bool> done(false);
+	vector<unsigned long long> counts(readers * 8, 0);		// one cache line per reader
+	vector<thread> threads;
+	for (unsigned int r = 0; r < readers; r++)
+	{
+		threads.emplace_back([&, r]() {
+			mt19937 rng(r);
+			unsigned long long local = 0;
+			while (!done.load(memory_order_relaxed))
+			{
+				for (int i = 0; i < 64; i++)
+					local += lookup(rng() % keys);
+				counts[r * 8] += 64;
+			}
+			if (local == 0)
+				cout << "";
+		});
+	}
+
+	unsigned long long writes = 0;
+	auto start = chrono::steady_clock::now();
+	auto stop = start + chrono::milliseconds(milliseconds);
+	while (chrono::steady_clock::now() < stop)
+	{
+		update(writes++);
+		if (pause > 0)
+			this_thread::sleep_for(chrono::microseconds(pause));
+	}
+	done.store(true);
+	for (thread& reader : threads)
+		reader.join();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	unsigned long long reads = 0;
+	for (unsigned int r = 0; r < readers; r++)
+		reads += counts[r * 8];
+	return Result{ reads / seconds, writes / seconds };
+}
+
+void Report(const string& name, unsigned int readers, const Result& result)
+{
+	cout << left << setw(22) << name << setw(9) << readers << setw(14) << fixed << setprecision(2)
+		<< result.reads / 1e6 << setw(16) << result.reads / 1e6 / readers
+		<< setprecision(0) << result.writes << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int keys = argc > 1 ? atoi(argv[1]) : 64;
+	unsigned int milliseconds = argc > 2 ? atoi(argv[2]) : 500;
+	unsigned int pause = argc > 3 ? atoi(argv[3]) : 20;
+	unsigned int cores = thread::hardware_concurrency();
+
+	cout << "keys: " << keys << "  ms per run: " << milliseconds << "  writer pause us: " << pause
+		<< "  hardware threads: " << cores << endl;
+	cout << left << setw(22) << "list" << setw(9) << "readers" << setw(14) << "Mreads/s"
+		<< setw(16) << "Mreads/s/reader" << "writes/s" << endl;
+
+	vector<unsigned int> readerCounts;
+	for (unsigned int readers = 1; readers <= max(cores, 1u); readers *= 2)
+		readerCounts.push_back(readers);
+	if (readerCounts.back() != max(cores, 1u))
+		readerCounts.push_back(cores);
+
+	for (unsigned int readers : readerCounts)
+	{
+		RcuList<unsigned int> rcu;
+		for (unsigned int i = 0; i < keys; i++)
+			rcu.AddTail(i);
+		Result rcuResult = Run(readers, keys, milliseconds, pause,
+			[&rcu](unsigned int key) { return rcu.Contains(key) ? 1 : 0; },
+			[&rcu, keys](unsigned long long i) {
+				unsigned int index = i % keys;
+				unsigned int value;
+				if (rcu.GetAt(index, value))
+					rcu.Replace(index, value);
+				rcu.AddTail(keys + (unsigned int)i);
+				rcu.RemoveTail();
+			});
+		Report("RcuList", readers, rcuResult);
+
+		LinkedList<unsigned int> list;
+		shared_mutex lock;
+		for (unsigned int i = 0; i < keys; i++)
+			list.AddTail(i);
+		const LinkedList<unsigned int>& constList = list;
+		Result lockedResult = Run(readers, keys, milliseconds, pause,
+			[&constList, &lock](unsigned int key) {
+				// walks the Nodes directly: Find keeps its cursor in the list, so concurrent
+				// readers of one LinkedList cannot share it
+				shared_lock<shared_mutex> guard(lock);
+				const LinkedList<unsigned int>::Node* node = constList.Head();
+				while (node != nullptr && node->data != key)
+					node = node->next;
+				return node != nullptr ? 1 : 0;
+			},
+			[&list, &lock, keys](unsigned long long i) {
+				unique_lock<shared_mutex> guard(lock);
+				list[i % keys] = list[i % keys];
+				list.AddTail(keys + (unsigned int)i);
+				list.RemoveTail();
+			});
+		Report("LinkedList+rwlock", readers, lockedResult);
+	}
+	return 0;
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "LinkedList.h"
+#include "RingBuffer.h"
+using namespace std;
+
+// Compares the Node and Ring storage of LinkedList used as a queue and as a stack.
+// Usage: bench_ring [operations] [depth]
+
+template<typename List, typename T>
+double QueueRun(unsigned int operations, unsigned int depth, const T& value);
+template<typename List, typename T>
+double StackRun(unsigned int operations, unsigned int depth, const T& value);
+void Report(const string& name, unsigned int operations, double ns);
+
+int main(int argc, char* argv[])
+{
+	unsigned int operations = argc > 1 ? atoi(argv[1]) : 10000000;
+	unsigned int depth = argc > 2 ? atoi(argv[2]) : 1000;
+	string word = "a string too long for the small string buffer";
+
+	cout << "operations: " << operations << "  depth: " << depth << endl;
+	cout << left << setw(28) << "benchmark" << setw(12) << "ns/op" << "Mops/s" << endl;
+
+	Report("queue<int> Nodes", operations, QueueRun<LinkedList<int>>(operations, depth, 7));
+	Report("queue<int> Ring", operations, QueueRun<LinkedList<int, Ring>>(operations, depth, 7));
+	Report("stack<int> Nodes", operations, StackRun<LinkedList<int>>(operations, depth, 7));
+	Report("stack<int> Ring", operations, StackRun<LinkedList<int, Ring>>(operations, depth, 7));
+	Report("queue<string> Nodes", operations, QueueRun<LinkedList<string>>(operations, depth, word));
+	Report("queue<string> Ring", operations, QueueRun<LinkedList<string, Ring>>(operations, depth, word));
+
+	return 0;
+}
+
+// Keeps depth elements queued; every operation is one AddTail and one RemoveHead.
+template<typename List, typename T>
+double QueueRun(unsigned int operations, unsigned int depth, const T& value)
+{
+	List list;
+	for (unsigned int i = 0; i < depth; i++)
+		list.AddTail(value);
+
+	auto start = chrono::steady_clock::now();
+	for (unsigned int i = 0; i < operations; i++)
+	{
+		list.AddTail(value);
+		list.RemoveHead();
+	}
+	auto stop = chrono::steady_clock::now();
+	return chrono::duration<double, nano>(stop - start).count();
+}
+
+// Pushes depth elements and pops them again until operations pushes have been made.
+template<typename List, typename T>
+double StackRun(unsigned int operations, unsigned int depth, const T& value)
+{
+	List list;
+	auto start = chrono::steady_clock::now();
+	for (unsigned int done = 0; done < operations; done += depth)
+	{
+		for (unsigned int i = 0; i < depth; i++)
+			list.AddTail(value);
+		while (list.RemoveTail()) {}
+	}
+	auto stop = chrono::steady_clock::now();
+	return chrono::duration<double, nano>(stop - start).count();
+}
+
+void Report(const string& name, unsigned int operations, double ns)
+{
+	cout << left << setw(28) << name << setw(12) << fixed << setprecision(2)
+		<< ns / operations << setprecision(1) << operations / ns * 1000.0 << endl;
+}
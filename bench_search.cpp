@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "LinkedList.h"
+using namespace std;
+
+// Compares Find under each SearchOrder for uniform and Zipfian query streams.
+// Usage: bench_search [keys] [queries] [zipf exponent]
+
+void MakeUniform(vector<int>& queries, unsigned int keys, unsigned int count);
+void MakeZipf(vector<int>& queries, unsigned int keys, unsigned int count, double exponent);
+void RunQueries(const string& workload, SearchOrder order, const vector<int>& queries, unsigned int keys);
+
+int main(int argc, char* argv[])
+{
+	unsigned int keys = argc > 1 ? atoi(argv[1]) : 1000;
+	unsigned int count = argc > 2 ? atoi(argv[2]) : 1000000;
+	double exponent = argc > 3 ? atof(argv[3]) : 1.0;
+
+	vector<int> uniform;
+	vector<int> zipf;
+	MakeUniform(uniform, keys, count);
+	MakeZipf(zipf, keys, count, exponent);
+
+	cout << "keys: " << keys << "  queries: " << count << "  zipf exponent: " << exponent << endl;
+	cout << left << setw(10) << "workload" << setw(14) << "order"
+		<< setw(14) << "avg probes" << "ns/query" << endl;
+
+	const SearchOrder orders[] = { SearchOrder::None, SearchOrder::MoveToFront,
+		SearchOrder::Transpose, SearchOrder::Count };
+	for (SearchOrder order : orders)
+		RunQueries("uniform", order, uniform, keys);
+	for (SearchOrder order : orders)
+		RunQueries("zipf", order, zipf, keys);
+
+	return 0;
+}
+
+void MakeUniform(vector<int>& queries, unsigned int keys, unsigned int count)
+{
+	mt19937 rng(1);
+	uniform_int_distribution<int> pick(0, keys - 1);
+	for (unsigned int i = 0; i < count; i++)
+		queries.push_back(pick(rng));
+}
+
+// Ranks are shuffled over the keys so the hottest keys do not start at the head.
+void MakeZipf(vector<int>& queries, unsigned int keys, unsigned int count, double exponent)
+{
+	mt19937 rng(2);
+	vector<double> weights;
+	for (unsigned int rank = 1; rank <= keys; rank++)
+		weights.push_back(1.0 / pow(rank, exponent));
+	vector<int> keyOfRank;
+	for (unsigned int i = 0; i < keys; i++)
+		keyOfRank.push_back(i);
+	shuffle(keyOfRank.begin(), keyOfRank.end(), rng);
+
+	discrete_distribution<int> pick(weights.begin(), weights.end());
+	for (unsigned int i = 0; i < count; i++)
+		queries.push_back(keyOfRank[pick(rng)]);
+}
+
+const char* OrderName(SearchOrder order)
+{
+	switch (order)
+	{
+	case SearchOrder::MoveToFront: return "MoveToFront";
+	case SearchOrder::Transpose: return "Transpose";
+	case SearchOrder::Count: return "Count";
+	default: return "None";
+	}
+}
+
+void RunQueries(const string& workload, SearchOrder order, const vector<int>& queries, unsigned int keys)
+{
+	// timed pass
+	LinkedList<int> timed;
+	for (unsigned int i = 0; i < keys; i++)
+		timed.AddTail(i);
+	timed.SetSearchOrder(order);
+
+	long long found = 0;
+	auto start = chrono::steady_clock::now();
+	for (int query : queries)
+		found += timed.Find(query) != nullptr;
+	auto stop = chrono::steady_clock::now();
+	double ns = chrono::duration<double, nano>(stop - start).count();
+
+	// identical pass that measures the position of every hit before Find reorders the list
+	LinkedList<int> probed;
+	for (unsigned int i = 0; i < keys; i++)
+		probed.AddTail(i);
+	probed.SetSearchOrder(order);
+
+	unsigned long long probes = 0;
+	for (int query : queries)
+	{
+		const LinkedList<int>::Node* node = probed.Head();
+		probes++;
+		while (node->data != query)
+		{
+			node = node->next;
+			probes++;
+		}
+		probed.Find(query);
+	}
+
+	if (found != (long long)queries.size())
+		cout << "error: " << queries.size() - found << " queries missed" << endl;
+	cout << left << setw(10) << workload << setw(14) << OrderName(order)
+		<< setw(14) << fixed << setprecision(2) << (double)probes / queries.size()
+		<< setprecision(1) << ns / queries.size() << endl;
+}
@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "LinkedList.h"
+#include "Serialize.h"
+using namespace std;
+
+// Compares ways of saving a LinkedList and getting it back after a restart: text written one
+// element per line and parsed back with AddTail, the binary format of Serialize.h, and opening
+// the binary file as a MappedList and reading every element in place.
+// Usage: bench_serialize [elements] [file]
+
+double Seconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void Report(const string& name, double save, double load, unsigned int elements)
+{
+	cout << left << setw(22) << name << setw(12) << fixed << setprecision(3) << save
+		<< setw(12) << load << setprecision(1) << load * 1e9 / elements << endl;
+}
+
+// Sums or measures what was loaded so the work cannot be skipped, and checks it matches.
+unsigned long long Checksum(const LinkedList<long long>& list)
+{
+	unsigned long long sum = 0;
+	for (const LinkedList<long long>::Node* node = list.Head(); node != nullptr; node = node->next)
+		sum += node->data;
+	return sum;
+}
+
+unsigned long long Checksum(const LinkedList<string>& list)
+{
+	unsigned long long sum = 0;
+	for (const LinkedList<string>::Node* node = list.Head(); node != nullptr; node = node->next)
+		sum += node->data.size() + (unsigned char)node->data[0];
+	return sum;
+}
+
+template<typename T>
+void Run(const string& type, const LinkedList<T>& original, const string& path)
+{
+	unsigned int elements = original.NodeCount();
+	unsigned long long expected = Checksum(original);
+
+	auto start = chrono::steady_clock::now();
+	{
+		ofstream out(path);
+		for (const typename LinkedList<T>::Node* node = original.Head(); node != nullptr; node = node->next)
+			out << node->data << '\n';
+	}
+	double save = Seconds(start);
+	start = chrono::steady_clock::now();
+	{
+		LinkedList<T> loaded;
+		ifstream in(path);
+		T value;
+		while (in >> value)
+			loaded.AddTail(value);
+		if (Checksum(loaded) != expected)
+			cout << "error: text load does not match" << endl;
+	}
+	Report("text " + type, save, Seconds(start), elements);
+
+	start = chrono::steady_clock::now();
+	if (!Serialize(original, path))
+		cout << "error: could not write " << path << endl;
+	save = Seconds(start);
+	start = chrono::steady_clock::now();
+	{
+		LinkedList<T> loaded;
+		if (!Deserialize(loaded, path) || Checksum(loaded) != expected)
+			cout << "error: binary load does not match" << endl;
+	}
+	Report("binary " + type, save, Seconds(start), elements);
+
+	// the file was just written, so it is in the page cache as it would be for a warm restart
+	start = chrono::steady_clock::now();
+	{
+		MappedList<T> mapped;
+		unsigned long long sum = 0;
+		if (!mapped.Open(path))
+			cout << "error: could not map " << path << endl;
+		mapped.ForEach([&sum](const auto& value) {
+			if constexpr (is_same<T, string>::value)
+				sum += value.size() + (unsigned char)value[0];
+			else
+				sum += value;
+		});
+		if (sum != expected)
+			cout << "error: mapped view does not match" << endl;
+	}
+	Report("mapped " + type, 0, Seconds(start), elements);
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int elements = argc > 1 ? atoi(argv[1]) : 10000000;
+	string path = argc > 2 ? argv[2] : "bench_serialize.tmp";
+
+	cout << "elements: " << elements << "  file: " << path << endl;
+	cout << left << setw(22) << "format" << setw(12) << "save s" << setw(12) << "load s" << "load ns/element" << endl;
+
+	{
+		LinkedList<long long> numbers;
+		for (unsigned int i = 0; i < elements; i++)
+			numbers.AddTail((long long)i * 2654435761u);
+		Run("long long", numbers, path);
+	}
+	{
+		LinkedList<string> words;
+		for (unsigned int i = 0; i < elements; i++)
+			words.AddTail("element" + to_string(i * 2654435761u));
+		Run("string", words, path);
+	}
+
+	remove(path.c_str());
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include "LinkedList.h"
+#include "StringList.h"
+using namespace std;
+
+// Compares LinkedList<string> with LinkedList<string, Strings> on the workload of main4.cpp's
+// TestRemove scaled up: words split from text with getline and added with AddTail, a Remove of
+// every copy of one word, full scans with Find for a word that is not there, and Clear.
+// Heap bytes are measured with mallinfo2, so they include malloc's own overhead.
+// Usage: bench_strings [words] [scans]
+
+double Seconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+size_t HeapBytes()
+{
+	return mallinfo2().uordblks;
+}
+
+// Builds text of count words separated by spaces; every eighth word is "RemoveMe".
+// Short words fit std::string's inline buffer, long ones need a heap allocation of their own.
+string MakeText(unsigned int count, bool longWords)
+{
+	const char* words[] = { "request", "served", "cache", "miss", "user", "session", "timeout",
+		"retry", "connection", "closed", "queue", "depth", "latency", "ms", "bytes" };
+	mt19937 rng(1);
+	string text;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (i % 8 == 7)
+			text += "RemoveMe";
+		else if (longWords)
+			text += string("worker-") + words[rng() % 15] + "-" + words[rng() % 15] + "-" + to_string(rng() % 100000);
+		else
+			text += words[rng() % 15];
+		text += ' ';
+	}
+	return text;
+}
+
+template<typename List>
+void Run(const string& name, const string& text, unsigned int scans)
+{
+	size_t heap = HeapBytes();
+	auto start = chrono::steady_clock::now();
+	List* data = new List();
+	{
+		stringstream x(text);
+		string tmp;
+		while (getline(x, tmp, ' '))
+			data->AddTail(tmp);
+	}
+	double build = Seconds(start);
+	unsigned int count = data->NodeCount();
+	double bytesPerWord = (double)(HeapBytes() - heap) / count;
+
+	start = chrono::steady_clock::now();
+	unsigned int misses = 0;
+	for (unsigned int i = 0; i < scans; i++)
+		misses += data->Find("NotInTheList") == nullptr;
+	double scan = Seconds(start) / scans;
+
+	start = chrono::steady_clock::now();
+	unsigned int removed = data->Remove("RemoveMe");
+	double remove = Seconds(start);
+
+	start = chrono::steady_clock::now();
+	delete data;
+	double clear = Seconds(start);
+
+	if (misses != scans || removed != count / 8)
+		cout << "error: " << name << " found " << misses << " misses and removed " << removed << endl;
+	cout << left << setw(26) << name << setw(12) << fixed << setprecision(1) << bytesPerWord
+		<< setprecision(3) << setw(10) << build << setw(10) << scan << setw(10) << remove << clear << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int count = argc > 1 ? atoi(argv[1]) : 10000000;
+	unsigned int scans = argc > 2 ? atoi(argv[2]) : 5;
+
+	cout << "words: " << count << endl;
+	cout << left << setw(26) << "list" << setw(12) << "bytes/word" << setw(10) << "build s" << setw(10) << "scan s"
+		<< setw(10) << "remove s" << "clear s" << endl;
+	for (bool longWords : { false, true })
+	{
+		string text = MakeText(count, longWords);
+		string kind = longWords ? " long" : " short";
+		Run<LinkedList<string>>("string" + kind, text, scans);
+		Run<LinkedList<string, Strings>>("Strings" + kind, text, scans);
+	}
+	return 0;
+}
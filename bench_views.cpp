@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "LinkedList.h"
+#include "Views.h"
+using namespace std;
+
+// Measures filter, map and take over a list of N Nodes three ways: eagerly, building a LinkedList
+// for each stage as code without views does; with a view pipeline that reads the Nodes once and
+// stops at the limit; and with the view pipeline materialized into a list by ToList.
+// Usage: bench_views [nodes] [limit]
+
+double Seconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void Report(const string& name, double seconds, long long sum)
+{
+	cout << left << setw(24) << name << setw(12) << fixed << setprecision(3) << seconds * 1e3 << sum << endl;
+}
+
+bool IsMultipleOf3(long long value)
+{
+	return value % 3 == 0;
+}
+
+long long Square(long long value)
+{
+	return value * value;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int nodes = argc > 1 ? atoi(argv[1]) : 1000000;
+	unsigned int limit = argc > 2 ? atoi(argv[2]) : nodes;
+
+	LinkedList<long long> list;
+	for (unsigned int i = 0; i < nodes; i++)
+		list.AddTail(i);
+
+	cout << "nodes: " << nodes << "  limit: " << limit << endl;
+	cout << left << setw(24) << "" << setw(12) << "ms" << "sum" << endl;
+
+	auto start = chrono::steady_clock::now();
+	LinkedList<long long> filtered;
+	for (long long value : list)
+	{
+		if (IsMultipleOf3(value))
+			filtered.AddTail(value);
+	}
+	LinkedList<long long> mapped;
+	for (long long value : filtered)
+		mapped.AddTail(Square(value));
+	LinkedList<long long> taken;
+	for (auto it = mapped.begin(); it != mapped.end() && taken.NodeCount() < limit; ++it)
+		taken.AddTail(*it);
+	long long sum = 0;
+	for (long long value : taken)
+		sum += value;
+	Report("list per stage", Seconds(start), sum);
+
+	start = chrono::steady_clock::now();
+	sum = 0;
+	for (long long value : list | Filter(IsMultipleOf3) | Transform(Square) | Take(limit))
+		sum += value;
+	Report("view pipeline", Seconds(start), sum);
+
+	start = chrono::steady_clock::now();
+	LinkedList<long long> result;
+	(list | Filter(IsMultipleOf3) | Transform(Square) | Take(limit)).ToList(result);
+	sum = 0;
+	for (long long value : result)
+		sum += value;
+	Report("view pipeline + ToList", Seconds(start), sum);
+	return 0;
+}
@@ -25,12 +25,110 @@
  /* 0.1 2011-10-15
  Modified by Joshua Fox 2019-5-30 to ignore delete called on nullptr
  Modified by Joshua Fox 2020-6-3 to use stdout instead of stderr
+ Modified 2026-10 for thread safety: sharded table, thread-local call sites
+ Modified 2026-10 to add sampling mode (LEAKER_SAMPLE_RATE)
+ Modified 2026-10 to add call site profiles (LEAKER_PROFILE)
+ Modified 2026-10 to add size, lifetime and latency histograms
+ Modified 2026-10 to report leaks per call site (LEAKER_REPORT_TOP)
+ Modified 2026-10 to record allocations per thread, found from a block header
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* for dladdr */
+#endif
+
 #include "leaker.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#define _LEAKER_DLADDR
+#endif
+#ifndef __cplusplus
+#include <time.h>
+#endif
 
- /* global table containing allocation information */
-_HTABLE_T _leaker = { NULL, 0, 0, 0, 0, 0, 0, 0 };
+/* address the current function will return to, used to tell apart unknown sites */
+#if defined(__GNUC__)
+#define _LEAKER_CALLER() __builtin_return_address(0)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define _LEAKER_CALLER() _ReturnAddress()
+#else
+#define _LEAKER_CALLER() NULL
+#endif
+
+/* every thread's record, newest first; added to and walked under the lock */
+static _THREAD_T *_leaker_threads = NULL;
+static _LEAKER_LOCK_T _leaker_threads_lock;
+static _LEAKER_TLS _THREAD_T *_leaker_thread = NULL;	/* record of the calling thread */
+static _LEAKER_TLS int _leaker_exit_hooked = 0;		/* 1 once its exit is caught */
+
+/* nonzero while a report has every other thread stopped */
+static _LEAKER_COUNTER_T _leaker_stopped;
+static _LEAKER_TLS int _leaker_reporting = 0;		/* 1 in the reporting thread */
+
+/* 1 if membarrier() is registered, so a report can make every thread's busy flag
+ * visible and threads need no fence of their own when setting it */
+static _LEAKER_COUNTER_T _leaker_expedited;
+
+/* next unreserved sequence number; threads reserve SERIAL_BLOCK at a time so that
+ * numbering stays in order within a thread without every allocation touching a shared counter */
+static _LEAKER_COUNTER_T _leaker_serial;
+static _LEAKER_TLS size_t _leaker_serial_next = 0;
+static _LEAKER_TLS size_t _leaker_serial_end = 0;
+
+/* set by the first thread to record anything, so the report is registered only once */
+static _LEAKER_LOCK_T _leaker_registered;
+
+/* sampling mode: mean number of bytes between tracked allocations, 0 to track all.
+ * The generation is 0 until LEAKER_SAMPLE_RATE has been read, and changes with the
+ * rate so that each thread redraws its countdown. Once sampling has been used, an
+ * unknown pointer is taken to be an allocation that was not sampled. */
+static _LEAKER_COUNTER_T _leaker_sample_rate;
+static _LEAKER_COUNTER_T _leaker_sample_generation;
+static _LEAKER_COUNTER_T _leaker_sampling_used;
+static _LEAKER_LOCK_T _leaker_config_lock;
+static _LEAKER_TLS size_t _leaker_sample_seen = 0;		/* generation of the countdown */
+static _LEAKER_TLS double _leaker_sample_left = 0;		/* bytes until the next sample */
+static _LEAKER_TLS unsigned long long _leaker_random = 0;	/* xorshift state */
+
+/* 1 if lifetimes and latencies are timed, read from LEAKER_TIMING along with the
+ * sampling rate; off by default, as it reads the clock around every allocation */
+static _LEAKER_COUNTER_T _leaker_timing;
+
+/* call sites, chained by hash; new sites are added under the lock and published
+ * with a release store, so lookups need no lock */
+static _LEAKER_SITE_LINK_T _leaker_sites[SITE_ROWS];
+static _LEAKER_LOCK_T _leaker_site_lock;
+static _LEAKER_TLS _SITE_T *_leaker_last_site = NULL;	/* most recent site of the thread */
+
+/* number of call sites the exit report lists, plus one; 0 until set, in which
+ * case LEAKER_REPORT_TOP is used */
+static _LEAKER_COUNTER_T _leaker_report_top;
+
+/* text of the exit report, written out in one go */
+typedef struct
+{
+	char *data;
+	size_t length;
+	size_t capacity;
+} _LEAKER_BUFFER_T;
+
+/* call site recorded when the new macro was not used */
+static const char _leaker_unknown[] = "unknown";
+
+/* names of the allocation and deallocation functions; entries point at these, so
+ * matching them up needs no string comparison */
+static const char _leaker_malloc[] = "malloc";
+static const char _leaker_calloc[] = "calloc";
+static const char _leaker_realloc[] = "realloc";
+static const char _leaker_free[] = "free";
+static const char _leaker_new[] = "new";
+static const char _leaker_new_array[] = "new[]";
+static const char _leaker_delete[] = "delete";
+static const char _leaker_delete_array[] = "delete[]";
 
 
 /* disable macros for internal use */
@@ -40,79 +138,254 @@ _HTABLE_T _leaker = { NULL, 0, 0, 0, 0, 0, 0, 0 };
 #undef free
 
 #ifdef __cplusplus
-const char *_leaker_file = "unknown";
-const char *_leaker_func = "unknown";
-unsigned long _leaker_line = 0;
+_LEAKER_TLS const char *_leaker_file = _leaker_unknown;
+_LEAKER_TLS const char *_leaker_func = _leaker_unknown;
+_LEAKER_TLS unsigned long _leaker_line = 0;
 
 #undef new
 #undef delete
+
+/* C++ headers only after the macros are gone: a program may include leaker.h
+ * before this file, and "delete" in "= delete" must not be replaced */
+#include <chrono>
+#if defined(__GNUC__)
+#include <cxxabi.h>
 #endif
 
-/* internal function prototypes */
-static void _Leaker_Init(void);
-static void _Leaker_Grow(void);
+using std::atomic_flag_test_and_set_explicit;
+using std::atomic_flag_clear_explicit;
+using std::atomic_fetch_add_explicit;
+using std::atomic_fetch_sub_explicit;
+using std::atomic_load_explicit;
+using std::atomic_store_explicit;
+using std::atomic_exchange_explicit;
+using std::atomic_compare_exchange_weak_explicit;
+using std::atomic_thread_fence;
+using std::atomic_signal_fence;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::memory_order_relaxed;
+using std::memory_order_seq_cst;
+#else
+#include <sched.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define _LEAKER_PTHREAD_KEY
+#endif
+#endif
 
-static void _Leaker_Add(void *addr, size_t size, const char *alloc,
-	const char *file, const char *func, size_t line);
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/* _HEADER_T magic of a tracked block; a chunk size malloc keeps in the same place
+ * before an untracked block never has the top bit set */
+#define _LEAKER_MAGIC ((size_t)0xA5A5A5A5A5A5A5A5ULL)
+
+/* totals over all threads */
+typedef struct
+{
+	size_t count;
+	size_t bytes;
+	size_t overflows;
+	size_t mismatches;
+	size_t bad_frees;
+} _LEAKER_SUM_T;
+
+/* the histograms each thread keeps, by offset in _THREAD_T */
+#define _LEAKER_SIZES offsetof(_THREAD_T, sizes)
+#define _LEAKER_LIFETIMES offsetof(_THREAD_T, lifetimes)
+#define _LEAKER_ALLOC_TIMES offsetof(_THREAD_T, alloc_times)
+#define _LEAKER_FREE_TIMES offsetof(_THREAD_T, free_times)
+
+/* internal function prototypes */
+static _THREAD_T *_Leaker_Thread(void);
+static _THREAD_T *_Leaker_Join(void);
+static void _Leaker_Retire(void);
+static void _Leaker_Enter(_THREAD_T *thread);
+static void _Leaker_Leave(_THREAD_T *thread);
+static void _Leaker_Lock(_LEAKER_LOCK_T *lock);
+static void _Leaker_Unlock(_LEAKER_LOCK_T *lock);
+static void _Leaker_Stop_All(void);
+static void _Leaker_Start_All(void);
+static void _Leaker_Sum(_LEAKER_SUM_T *sum);
+static size_t _Leaker_Next_Serial(void);
+static size_t _Leaker_Configure(void);
+static int _Leaker_Sample(size_t size, double *weight);
+static int _Leaker_Sample_Bytes(size_t size, size_t rate, size_t generation,
+	double *weight);
+static double _Leaker_Next_Sample(size_t rate);
+static double _Leaker_Uniform(void);
+static size_t _Leaker_Draw_Count(double weight);
+static int _Leaker_Sampling(void);
+static void _Leaker_Free(void *ptr, const char *dealloc, const char *file,
+	const char *func, unsigned long line);
+static unsigned long long _Leaker_Now(void);
+static int _Leaker_Timing(void);
+static unsigned long long _Leaker_Start_Timing(void);
+static unsigned long long _Leaker_Stop_Timing(unsigned long long start, size_t hist, double weight);
+static unsigned int _Leaker_Bucket(size_t value);
+static size_t _Leaker_Bucket_Floor(unsigned int bucket);
+static void _Leaker_Record(size_t hist, size_t value, double weight);
+static void _Leaker_Add_Value(_HIST_T *hist, size_t value, size_t count);
+static void _Leaker_Gather(_HIST_T *total, size_t hist);
+static void _Leaker_Print_Histogram(_HIST_T *hist, const char *name, const char *unit);
+static void _Leaker_Print_Histograms(void);
+static _LEAK_T *_Leaker_New_Entry(_THREAD_T *thread);
+static void _Leaker_Free_Entry(_THREAD_T *thread, _LEAK_T *entry);
+
+static void *_Leaker_Add(void *block, size_t size, double weight, unsigned long long time,
+	const char *alloc, const char *file, const char *func, size_t line, void *caller);
+static _SITE_T *_Leaker_Site(const char *file, const char *func, size_t line, void *caller);
+static void _Leaker_Count_Site(_THREAD_T *thread, _LEAK_T *entry, int allocated);
+static void _Leaker_Flush_Tally(_TALLY_T *tally);
+static void _Leaker_Flush_Tallies(_THREAD_T *thread);
+static void _Leaker_Site_Name(const _SITE_T *site, char *name, size_t size);
+static int _Leaker_Metric(const char *metric);
+static size_t _Leaker_Site_Value(_SITE_T *site, int metric);
+static _SITE_T **_Leaker_Build_Sites(size_t *count);
+static int _Leaker_Compare_Sites_By_Bytes(const void *first, const void *second);
+static void _Leaker_Print_Sites(void);
 static size_t _Leaker_Remove(void *addr, const char *dealloc, const char *file,
-	const char *func, size_t line);
-static _LEAK_T **_Leaker_Find(void *addr);
+	const char *func, size_t line, double *weight, unsigned long long *time);
+static void _Leaker_Bad_Free(const char *dealloc, const char *file, const char *func,
+	size_t line);
 
-static unsigned long _Leaker_Hash(void *addr);
+static size_t _Leaker_Hash(void *addr);
 
 static int _Leaker_Check_Dealloc(const char *alloc, const char *dealloc);
 static void _Leaker_Init_Guard(void *addr, size_t size);
 static int _Leaker_Check_Guard(void *addr, size_t size);
 static void _Leaker_Scribble(void *ptr, size_t size);
 
-static void _Leaker_Print_Entry(_LEAK_T *entry);
+static _SITE_T **_Leaker_Collect_Leaks(size_t *count);
+static int _Leaker_Compare_Leaks(const void *first, const void *second);
+static size_t _Leaker_Report_Top(void);
+static void _Leaker_Append(_LEAKER_BUFFER_T *buffer, const char *format, ...);
 static void _Leaker_Report(void);
 
-static void _Leaker_Dump_Entry(_LEAK_T *entry);
-static _LEAK_T **_Leaker_Build_List(void);
+static int _Leaker_Dump_Entry(_LEAK_T *entry);
+static _LEAK_T **_Leaker_Build_List(size_t count);
 
 static int _Leaker_Compare_Entries(const void *first, const void *second);
+static int _Leaker_Compare_Sites(const void *first, const void *second);
+static void _Leaker_Print_Estimates(_LEAK_T **table, size_t count);
 
 /* dump current allocation information and statistics */
 void _Leaker_Dump(void)
 {
-	size_t overflows = _leaker.overflows;
+	_LEAKER_SUM_T sum;
+
+	_Leaker_Stop_All();
+	_Leaker_Sum(&sum);
 
 	fprintf(stdout, "\nLeaker report:\n");
 
-	if (_leaker.count == 0)
+	if (sum.count == 0)
 	{
 		fprintf(stdout, "No allocations.\n\n");
+		_Leaker_Print_Sites();
+		_Leaker_Print_Histograms();
+		_Leaker_Start_All();
 		return;
 	}
 	else
 	{
-		_LEAK_T **table = _Leaker_Build_List();
+		_LEAK_T **table = _Leaker_Build_List(sum.count);
 		unsigned int i;
-		fprintf(stdout, "%lu allocations (%lu bytes) in table of %lu rows.\n",
-			_leaker.count, _leaker.bytes - _leaker.count * GUARD_SIZE,
-			_leaker.rows);
+		fprintf(stdout, "%lu allocations (%lu bytes).\n",
+			sum.count, sum.bytes - sum.count * GUARD_SIZE);
 
-		for (i = 0; i < _leaker.count; i++)
+		/* overflows found here are reported again at exit, so only counted now */
+		for (i = 0; i < sum.count; i++)
 		{
-			_Leaker_Dump_Entry(table[i]);
+			sum.overflows += _Leaker_Dump_Entry(table[i]);
 		}
 		fprintf(stdout, "\n");
+		if (_Leaker_Sampling()) _Leaker_Print_Estimates(table, sum.count);
 
 		free(table);
 	}
+	_Leaker_Print_Sites();
+	_Leaker_Print_Histograms();
 
-	if (_leaker.mismatches)
+	if (sum.mismatches)
 		fprintf(stdout, "Mismatches: %lu allocation/deallocations don't match!\n",
-			_leaker.mismatches);
-	if (_leaker.overflows)
+			sum.mismatches);
+	if (sum.overflows)
 		fprintf(stdout, "Overflows: %lu allocations overflowed (wrote off end)!\n",
-			_leaker.overflows);
-	if (_leaker.bad_frees)
+			sum.overflows);
+	if (sum.bad_frees)
 		fprintf(stdout, "Bad deallocs: %lu attempts made to deallocate unallocated pointers!\n",
-			_leaker.bad_frees);
+			sum.bad_frees);
+
+	_Leaker_Start_All();
+}
+
+/* set the sampling rate: on average one allocation is tracked per rate bytes
+ * allocated, 0 tracks every allocation */
+void _Leaker_Set_Sample_Rate(size_t rate)
+{
+	_Leaker_Configure();
+	atomic_store_explicit(&_leaker_sample_rate, rate, memory_order_relaxed);
+	if (rate) atomic_store_explicit(&_leaker_sampling_used, (size_t)1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&_leaker_sample_generation, (size_t)1, memory_order_release);
+}
 
-	_leaker.overflows = overflows; /* restore current overflow count */
+/* return the sampling rate, 0 if every allocation is tracked */
+size_t _Leaker_Get_Sample_Rate(void)
+{
+	_Leaker_Configure();
+	return atomic_load_explicit(&_leaker_sample_rate, memory_order_relaxed);
+}
+
+/* turn timing of allocation lifetimes and allocator latency on (nonzero) or off */
+void _Leaker_Set_Timing(int on)
+{
+	_Leaker_Configure();
+	atomic_store_explicit(&_leaker_timing, (size_t)(on != 0), memory_order_relaxed);
+}
+
+/* return 1 if lifetimes and latencies are timed */
+int _Leaker_Get_Timing(void)
+{
+	return _Leaker_Timing();
+}
+
+/* write the call site profile for one metric in folded-stack format */
+int _Leaker_Write_Profile(const char *path, const char *metric)
+{
+	FILE *out;
+	_SITE_T **sites;
+	size_t count, i;
+	int index = _Leaker_Metric(metric ? metric : "bytes");
+	char name[512];
+
+	if (index < 0 || !(out = fopen(path, "w"))) return 0;
+
+	/* stopping the threads adds in the totals they hold */
+	_Leaker_Stop_All();
+	sites = _Leaker_Build_Sites(&count);
+	for (i = 0; i < count; i++)
+	{
+		size_t value = _Leaker_Site_Value(sites[i], index);
+		if (!value) continue;
+
+		_Leaker_Site_Name(sites[i], name, sizeof(name));
+		fprintf(out, "%s %lu\n", name, (unsigned long)value);
+	}
+	_Leaker_Start_All();
+	free(sites);
+
+	return fclose(out) == 0;
+}
+
+/* limit the exit report to the call sites leaking the most bytes; 0 lists all */
+void _Leaker_Set_Report_Top(size_t sites)
+{
+	atomic_store_explicit(&_leaker_report_top, sites + 1, memory_order_relaxed);
 }
 
 /* replacement for malloc */
@@ -120,17 +393,29 @@ void *_malloc(size_t size, const char *file, const char *func,
 	unsigned long line)
 {
 	void *ptr;
-	size += GUARD_SIZE;
+	double weight;
+	unsigned long long start = 0, time;
+	int tracked = _Leaker_Sample(size, &weight);
+
+	if (tracked)
+	{
+		size += GUARD_SIZE;
+		start = _Leaker_Start_Timing();
+	}
 
-	if (!(ptr = malloc(size)))
+	if (!(ptr = malloc(tracked ? HEADER_SIZE + size : size)) && size)
 	{
 		fprintf(stdout, "%s:%s():%i aborting: malloc() failed!\n", __FILE__,
 			__func__, __LINE__);
 		exit(2);
 	}
 
-	_Leaker_Init_Guard(ptr, size);
-	_Leaker_Add(ptr, size, "malloc", file, func, line);
+	if (tracked)
+	{
+		time = _Leaker_Stop_Timing(start, _LEAKER_ALLOC_TIMES, weight);
+		ptr = _Leaker_Add(ptr, size, weight, time, _leaker_malloc, file, func, line, NULL);
+		_Leaker_Init_Guard(ptr, size);
+	}
 	return ptr;
 }
 
@@ -139,17 +424,31 @@ void *_calloc(unsigned long count, size_t size, const char *file,
 	const char *func, unsigned long line)
 {
 	void *ptr;
-	size = size * count + GUARD_SIZE;
+	double weight;
+	unsigned long long start = 0, time;
+	int tracked;
 
-	if (!(ptr = calloc(1, size)))
+	size = size * count;
+	tracked = _Leaker_Sample(size, &weight);
+	if (tracked)
+	{
+		size += GUARD_SIZE;
+		start = _Leaker_Start_Timing();
+	}
+
+	if (!(ptr = calloc(1, tracked ? HEADER_SIZE + size : size)) && size)
 	{
 		fprintf(stdout, "%s:%s():%i aborting: calloc() failed!\n", __FILE__,
 			__func__, __LINE__);
 		exit(2);
 	}
 
-	_Leaker_Init_Guard(ptr, size);
-	_Leaker_Add(ptr, size, "calloc", file, func, line);
+	if (tracked)
+	{
+		time = _Leaker_Stop_Timing(start, _LEAKER_ALLOC_TIMES, weight);
+		ptr = _Leaker_Add(ptr, size, weight, time, _leaker_calloc, file, func, line, NULL);
+		_Leaker_Init_Guard(ptr, size);
+	}
 	return ptr;
 }
 
@@ -157,39 +456,83 @@ void *_calloc(unsigned long count, size_t size, const char *file,
 void *_realloc(void *ptr, size_t size, const char *file,
 	const char *func, unsigned long line)
 {
-	void *ptr_new;
+	void *block, *ptr_new;
 	size_t old_size = 0, len;
+	double weight, old_weight;
+	unsigned long long start, time, old_time;
+	int tracked = _Leaker_Sample(size, &weight);
 
-	size += GUARD_SIZE;
+	if (tracked) size += GUARD_SIZE;
 
 	/* check if pointer given to realloc is valid */
-	if (ptr && !(old_size = _Leaker_Remove(ptr, "realloc", file, func, line)))
+	if (ptr && !(old_size = _Leaker_Remove(ptr, _leaker_realloc, file, func, line,
+		&old_weight, &old_time)))
 	{
-		ptr = NULL;
+		if (!_Leaker_Sampling())
+			ptr = NULL;
+		else
+		{
+			/* an allocation that was not sampled; only the C library knows its
+			 * size, so let it do the copy */
+			start = tracked ? _Leaker_Start_Timing() : 0;
+			if (!(ptr_new = realloc(ptr, size)) && size)
+			{
+				fprintf(stdout, "%s:%s():%i aborting: realloc() failed!\n",
+					__FILE__, __func__, __LINE__);
+				exit(2);
+			}
+			if (tracked)
+			{
+				/* a tracked block needs room for its header in front */
+				if (!(block = malloc(HEADER_SIZE + size)))
+				{
+					fprintf(stdout, "%s:%s():%i aborting: realloc() failed!\n",
+						__FILE__, __func__, __LINE__);
+					exit(2);
+				}
+				memcpy((char *)block + HEADER_SIZE, ptr_new, size - GUARD_SIZE);
+				free(ptr_new);
+				time = _Leaker_Stop_Timing(start, _LEAKER_ALLOC_TIMES, weight);
+				ptr_new = _Leaker_Add(block, size, weight, time, _leaker_realloc, file, func, line, NULL);
+				_Leaker_Init_Guard(ptr_new, size);
+			}
+			return ptr_new;
+		}
 	}
 
 	/* to help catch realloc errors, ensure each realloc is at a new address */
-	if (!(ptr_new = malloc(size)))
+	start = _Leaker_Start_Timing();
+	if (!(block = malloc(tracked ? HEADER_SIZE + size : size)) && size)
 	{
 		fprintf(stdout, "%s:%s():%i aborting: realloc() failed!\n",
 			__FILE__, __func__, __LINE__);
 		exit(2);
 	}
+	time = start ? _Leaker_Now() : 0;
+	ptr_new = tracked ? (char *)block + HEADER_SIZE : block;
 
 	/* if realloc was given a valid pointer, copy over the old data */
 	if (ptr)
 	{
-		if (old_size > size) len = size - GUARD_SIZE;
-		else len = old_size - GUARD_SIZE;
+		len = old_size - GUARD_SIZE;
+		if (len > size - (tracked ? GUARD_SIZE : 0))
+			len = size - (tracked ? GUARD_SIZE : 0);
 
 		memcpy(ptr_new, ptr, len);
 
 		_Leaker_Scribble(ptr, old_size);
-		free(ptr);
+		free((char *)ptr - HEADER_SIZE);
+		if (time && old_time)
+			_Leaker_Record(_LEAKER_LIFETIMES, time - old_time, old_weight);
 	}
 
-	_Leaker_Init_Guard(ptr_new, size);
-	_Leaker_Add(ptr_new, size, "realloc", file, func, line);
+	if (tracked)
+	{
+		if (time)
+			_Leaker_Record(_LEAKER_ALLOC_TIMES, time - start, weight);
+		_Leaker_Add(block, size, weight, time, _leaker_realloc, file, func, line, NULL);
+		_Leaker_Init_Guard(ptr_new, size);
+	}
 	return ptr_new;
 }
 
@@ -197,12 +540,7 @@ void *_realloc(void *ptr, size_t size, const char *file,
 void _free(void *ptr, const char *file, const char *func,
 	unsigned long line)
 {
-	size_t size;
-	if ((size = _Leaker_Remove(ptr, "free", file, func, line)))
-	{
-		_Leaker_Scribble(ptr, size);
-		free(ptr);
-	}
+	_Leaker_Free(ptr, _leaker_free, file, func, line);
 }
 
 #ifdef __cplusplus
@@ -211,22 +549,35 @@ void _free(void *ptr, const char *file, const char *func,
 void* operator new (size_t size)
 {
 	void *ptr = NULL;
-	size += GUARD_SIZE;
+	double weight;
+	unsigned long long start = 0, time;
+	int tracked = _Leaker_Sample(size, &weight);
+
+	if (tracked)
+	{
+		size += GUARD_SIZE;
+		start = _Leaker_Start_Timing();
+	}
 
-	if (!(ptr = malloc(size)))
+	if (!(ptr = malloc(tracked ? HEADER_SIZE + size : size ? size : 1)))
 	{
 		fprintf(stdout, "%s:%s():%i aborting: calloc() failed!\n",
 			__FILE__, __func__, __LINE__);
 		exit(2);
 	}
 
-	_Leaker_Init_Guard(ptr, size);
-	_Leaker_Add(ptr, size, "new", _leaker_file, _leaker_func, _leaker_line);
+	if (tracked)
+	{
+		time = _Leaker_Stop_Timing(start, _LEAKER_ALLOC_TIMES, weight);
+		ptr = _Leaker_Add(ptr, size, weight, time, _leaker_new, _leaker_file, _leaker_func, _leaker_line,
+			_leaker_file == _leaker_unknown ? _LEAKER_CALLER() : NULL);
+		_Leaker_Init_Guard(ptr, size);
+	}
 
 	/* in case new is called from library code where macro has not overriden
 	 * new and updated _leaker_file, _leaker_func, etc */
-	_leaker_file = "unknown";
-	_leaker_func = "unknown";
+	_leaker_file = _leaker_unknown;
+	_leaker_func = _leaker_unknown;
 	_leaker_line = 0;
 
 	return ptr;
@@ -236,20 +587,33 @@ void* operator new (size_t size)
 void* operator new [](size_t size)
 {
 	void *ptr;
-	size += GUARD_SIZE;
+	double weight;
+	unsigned long long start = 0, time;
+	int tracked = _Leaker_Sample(size, &weight);
 
-	if (!(ptr = malloc(size)))
+	if (tracked)
+	{
+		size += GUARD_SIZE;
+		start = _Leaker_Start_Timing();
+	}
+
+	if (!(ptr = malloc(tracked ? HEADER_SIZE + size : size ? size : 1)))
 	{
 		fprintf(stdout, "%s:%s():%i aborting: calloc failed!\n",
 			__FILE__, __func__, __LINE__);
 		exit(2);
 	}
 
-	_Leaker_Init_Guard(ptr, size);
-	_Leaker_Add(ptr, size, "new[]", _leaker_file, _leaker_func, _leaker_line);
+	if (tracked)
+	{
+		time = _Leaker_Stop_Timing(start, _LEAKER_ALLOC_TIMES, weight);
+		ptr = _Leaker_Add(ptr, size, weight, time, _leaker_new_array, _leaker_file, _leaker_func, _leaker_line,
+			_leaker_file == _leaker_unknown ? _LEAKER_CALLER() : NULL);
+		_Leaker_Init_Guard(ptr, size);
+	}
 
-	_leaker_file = "unknown";
-	_leaker_func = "unknown";
+	_leaker_file = _leaker_unknown;
+	_leaker_func = _leaker_unknown;
 	_leaker_line = 0;
 
 	return ptr;
@@ -260,13 +624,7 @@ void operator delete(void* ptr) throw ()
 {
 	if (ptr == nullptr)
 		return;
-	size_t size;
-	if ((size = _Leaker_Remove(ptr, "delete", _leaker_file, _leaker_func,
-		_leaker_line)))
-	{
-		_Leaker_Scribble(ptr, size);
-		free(ptr);
-	}
+	_Leaker_Free(ptr, _leaker_delete, _leaker_file, _leaker_func, _leaker_line);
 }
 
 /* replacement for operator delete */
@@ -275,13 +633,7 @@ void operator delete(void* ptr, size_t sz) throw ()
 	if (ptr == nullptr)
 		return;
 	sz = sz;
-	size_t size;
-	if ((size = _Leaker_Remove(ptr, "delete", _leaker_file, _leaker_func,
-		_leaker_line)))
-	{
-		_Leaker_Scribble(ptr, size);
-		free(ptr);
-	}
+	_Leaker_Free(ptr, _leaker_delete, _leaker_file, _leaker_func, _leaker_line);
 }
 
 /* replacement for operator vector delete */
@@ -289,13 +641,7 @@ void operator delete [](void* ptr) throw ()
 {
 	if (ptr == nullptr)
 		return;
-	size_t size;
-	if ((size = _Leaker_Remove(ptr, "delete[]", _leaker_file, _leaker_func,
-		_leaker_line)))
-	{
-		_Leaker_Scribble(ptr, size);
-		free(ptr);
-	}
+	_Leaker_Free(ptr, _leaker_delete_array, _leaker_file, _leaker_func, _leaker_line);
 }
 
 /* replacement for operator vector delete */
@@ -304,176 +650,384 @@ void operator delete [](void* ptr, size_t sz) throw ()
 	if (ptr == nullptr)
 		return;
 	sz = sz;
-	size_t size;
-	if ((size = _Leaker_Remove(ptr, "delete[]", _leaker_file, _leaker_func,
-		_leaker_line)))
-	{
-		_Leaker_Scribble(ptr, size);
-		free(ptr);
-	}
+	_Leaker_Free(ptr, _leaker_delete_array, _leaker_file, _leaker_func, _leaker_line);
 }
 
 #endif
 
 /* end of user-visible functions */
 
-/* initialize table */
-static void _Leaker_Init(void)
+#ifdef __cplusplus
+/* hands the thread's record back when the thread ends */
+struct _LEAKER_EXIT_T
+{
+	~_LEAKER_EXIT_T() { _Leaker_Retire(); }
+};
+static thread_local _LEAKER_EXIT_T _leaker_exit;
+#elif defined(_LEAKER_PTHREAD_KEY)
+static pthread_key_t _leaker_exit_key;
+static int _leaker_exit_key_made = 0;
+
+/* pthread key destructor, run when a thread that recorded anything ends */
+static void _Leaker_Exit_Key(void *thread)
+{
+	(void)thread;
+	_Leaker_Retire();
+}
+#endif
+
+/* return the calling thread's record */
+static _THREAD_T *_Leaker_Thread(void)
 {
-	_leaker.table = (_LEAK_T **)calloc(START_SIZE, sizeof(_LEAK_T *));
+	return _leaker_thread ? _leaker_thread : _Leaker_Join();
+}
 
-	if (!_leaker.table)
+/* give the calling thread a record: one a thread that has ended left behind,
+ * or a new one */
+static _THREAD_T *_Leaker_Join(void)
+{
+	_THREAD_T *thread;
+
+	_Leaker_Lock(&_leaker_threads_lock);
+	for (thread = _leaker_threads; thread && !thread->exited; thread = thread->next)
+		;
+	if (thread)
+		thread->exited = 0;
+	else
 	{
-		fprintf(stdout, "%s:%s():%i aborting: calloc() for table failed!\n",
-			__FILE__, __func__, __LINE__);
-		exit(2);
+		if (!(thread = (_THREAD_T *)calloc(1, sizeof(_THREAD_T))))
+		{
+			fprintf(stdout, "%s:%s():%i aborting: calloc() for thread failed!\n",
+				__FILE__, __func__, __LINE__);
+			exit(2);
+		}
+		thread->next = _leaker_threads;
+		_leaker_threads = thread;
 	}
 
-	_leaker.rows = START_SIZE;
-
 	/* register so that leak information always displayed upon termination */
-	atexit(_Leaker_Report);
+	if (!atomic_flag_test_and_set_explicit(&_leaker_registered, memory_order_acquire))
+	{
+		atexit(_Leaker_Report);
+#if defined(__linux__)
+		if (syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0)
+			atomic_store_explicit(&_leaker_expedited, (size_t)1, memory_order_relaxed);
+#endif
+#if !defined(__cplusplus) && defined(_LEAKER_PTHREAD_KEY)
+		_leaker_exit_key_made = pthread_key_create(&_leaker_exit_key, _Leaker_Exit_Key) == 0;
+#endif
+	}
+	_Leaker_Unlock(&_leaker_threads_lock);
+
+	_leaker_thread = thread;
+	if (!_leaker_exit_hooked) /* a thread that joins again while ending is not hooked twice */
+	{
+		_leaker_exit_hooked = 1;
+#ifdef __cplusplus
+		(void)&_leaker_exit;
+#elif defined(_LEAKER_PTHREAD_KEY)
+		if (_leaker_exit_key_made) pthread_setspecific(_leaker_exit_key, thread);
+#endif
+	}
+	return thread;
 }
 
-/* grow table to accommodate more entries (by factor of 4) */
-static void _Leaker_Grow(void)
+/* hand the calling thread's record over to a later thread, with the totals it
+ * holds added to the sites */
+static void _Leaker_Retire(void)
 {
-	unsigned int i;
+	_THREAD_T *thread = _leaker_thread;
 
-	_HTABLE_T old = _leaker;
-	_leaker.rows *= 4;
-	_leaker.count = 0;
-	_leaker.bytes = 0;
+	if (!thread) return;
+	_Leaker_Enter(thread);
+	_Leaker_Flush_Tallies(thread);
+	_Leaker_Leave(thread);
 
-	_leaker.table = (_LEAK_T **)calloc(_leaker.rows, sizeof(_LEAK_T *));
+	_leaker_thread = NULL;
+	_Leaker_Lock(&_leaker_threads_lock);
+	thread->exited = 1;
+	_Leaker_Unlock(&_leaker_threads_lock);
+}
 
-	if (!_leaker.table)
+/* mark the thread as changing its record; while a report has the threads
+ * stopped, wait for it first */
+static void _Leaker_Enter(_THREAD_T *thread)
+{
+	for (;;)
 	{
-		fprintf(stdout, "%s:%s():%i aborting: calloc() for table failed!\n",
-			__FILE__, __func__, __LINE__);
-		exit(2);
+		atomic_store_explicit(&thread->busy, (size_t)1, memory_order_relaxed);
+
+		/* the busy flag must be visible before _leaker_stopped is read; a
+		 * report's membarrier() orders the two on this thread's behalf */
+		if (atomic_load_explicit(&_leaker_expedited, memory_order_relaxed))
+			atomic_signal_fence(memory_order_seq_cst);
+		else
+			atomic_thread_fence(memory_order_seq_cst);
+
+		if (!atomic_load_explicit(&_leaker_stopped, memory_order_acquire) || _leaker_reporting)
+			return;
+
+		atomic_store_explicit(&thread->busy, (size_t)0, memory_order_release);
+		while (atomic_load_explicit(&_leaker_stopped, memory_order_acquire))
+		{
+#ifdef __cplusplus
+			std::this_thread::yield();
+#else
+			sched_yield();
+#endif
+		}
 	}
+}
 
-	/* remove every entry from the old table and add it to the new */
-	for (i = 0; i < old.rows; i++)
+/* mark the thread as done changing its record */
+static void _Leaker_Leave(_THREAD_T *thread)
+{
+	atomic_store_explicit(&thread->busy, (size_t)0, memory_order_release);
+}
+
+/* acquire a lock, spinning briefly before yielding the processor */
+static void _Leaker_Lock(_LEAKER_LOCK_T *lock)
+{
+	unsigned int spins = 0;
+	while (atomic_flag_test_and_set_explicit(lock, memory_order_acquire))
 	{
-		_LEAK_T *mover = old.table[i];
-		while (mover)
+		if (++spins % 64 == 0)
 		{
-			_LEAK_T *temp = mover;
-			mover = mover->next;
-			_leaker.serial = temp->sequence;
-			_Leaker_Add(temp->addr, temp->size, temp->alloc,
-				temp->file, temp->func, temp->line);
-			free(temp);
+#ifdef __cplusplus
+			std::this_thread::yield();
+#else
+			sched_yield();
+#endif
 		}
 	}
-	_leaker.serial = old.serial;
+}
 
-	free(old.table);
+/* release a lock */
+static void _Leaker_Unlock(_LEAKER_LOCK_T *lock)
+{
+	atomic_flag_clear_explicit(lock, memory_order_release);
 }
 
-/* add a new allocation to the table */
-void _Leaker_Add(void *addr, size_t size, const char *alloc,
-	const char *file, const char *func, size_t line)
+/* wait until no other thread is changing its record, and keep them from
+ * starting until _Leaker_Start_All, so a report can read every record; the
+ * totals threads hold are added to the sites. No thread joins meanwhile. */
+static void _Leaker_Stop_All(void)
 {
-	_LEAK_T **mover, *temp;
+	_THREAD_T *thread;
+
+	_Leaker_Lock(&_leaker_threads_lock);
+	_leaker_reporting = 1;
+	atomic_store_explicit(&_leaker_stopped, (size_t)1, memory_order_seq_cst);
+#if defined(__linux__)
+	if (atomic_load_explicit(&_leaker_expedited, memory_order_relaxed))
+		syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+#endif
+	atomic_thread_fence(memory_order_seq_cst);
 
-	if (!_leaker.table) _Leaker_Init();
-	if (_leaker.count > _leaker.rows / 2) _Leaker_Grow();
+	for (thread = _leaker_threads; thread; thread = thread->next)
+	{
+		while (atomic_load_explicit(&thread->busy, memory_order_acquire))
+		{
+#ifdef __cplusplus
+			std::this_thread::yield();
+#else
+			sched_yield();
+#endif
+		}
+		_Leaker_Flush_Tallies(thread);
+	}
+}
 
-	mover = &(_leaker.table[_Leaker_Hash(addr)]);
-	while (*mover)
+/* let the threads stopped by _Leaker_Stop_All carry on */
+static void _Leaker_Start_All(void)
+{
+	_leaker_reporting = 0;
+	atomic_store_explicit(&_leaker_stopped, (size_t)0, memory_order_release);
+	_Leaker_Unlock(&_leaker_threads_lock);
+}
+
+/* add up the counters of every thread; called with the threads stopped */
+static void _Leaker_Sum(_LEAKER_SUM_T *sum)
+{
+	_THREAD_T *thread;
+	memset(sum, 0, sizeof(*sum));
+	for (thread = _leaker_threads; thread; thread = thread->next)
 	{
-		if ((*mover)->addr == addr) break;
+		sum->count += thread->count;
+		sum->bytes += thread->bytes;
+		sum->overflows += thread->overflows;
+		sum->mismatches += thread->mismatches;
+		sum->bad_frees += thread->bad_frees;
+	}
+}
+
+/* take an entry from a thread's pool, taking back the ones other threads
+ * freed once the spare ones run out; fresh slabs are handed out an entry at a
+ * time so their pages are first touched one by one, not all at once */
+static _LEAK_T *_Leaker_New_Entry(_THREAD_T *thread)
+{
+	_LEAK_T *entry;
+
+	if (!thread->spare && atomic_load_explicit(&thread->returned, memory_order_relaxed))
+		thread->spare = atomic_exchange_explicit(&thread->returned, (_LEAK_T *)NULL,
+			memory_order_acquire);
 
-		mover = &((*mover)->next);
+	if (thread->spare)
+	{
+		entry = thread->spare;
+		thread->spare = entry->next;
+		return entry;
 	}
 
-	if (*mover) /* if an address is allocated twice, we are in trouble! */
+	if (!thread->slabs || thread->carved == SLAB_ENTRIES)
 	{
-		fprintf(stdout, "%s:%s():%lu fatal error: address %p already in use!\n",
-			file, func, line, addr);
-		exit(2);
+		_SLAB_T *slab = (_SLAB_T *)malloc(sizeof(_SLAB_T));
+
+		if (!slab)
+		{
+			fprintf(stdout, "%s:%s():%i aborting: malloc() for entries failed!\n",
+				__FILE__, __func__, __LINE__);
+			exit(2);
+		}
+
+		slab->next = thread->slabs;
+		thread->slabs = slab;
+		thread->carved = 0;
 	}
 
-	if (!(temp = (_LEAK_T *)malloc(sizeof(_LEAK_T))))
+	entry = &thread->slabs->entries[thread->carved++];
+	entry->owner = thread;
+	return entry;
+}
+
+/* return an entry to its pool; another thread's entry goes on its returned list */
+static void _Leaker_Free_Entry(_THREAD_T *thread, _LEAK_T *entry)
+{
+	_THREAD_T *owner = entry->owner;
+
+	entry->addr = NULL; /* marks the entry unused for _Leaker_Collect_Leaks */
+	if (owner == thread)
 	{
-		fprintf(stdout, "%s:%s():%i aborting: malloc() for entry failed!\n",
-			__FILE__, __func__, __LINE__);
-		exit(2);
+		entry->next = thread->spare;
+		thread->spare = entry;
+		return;
 	}
 
-	temp->addr = addr;
+	entry->next = atomic_load_explicit(&owner->returned, memory_order_relaxed);
+	while (!atomic_compare_exchange_weak_explicit(&owner->returned, &entry->next, entry,
+		memory_order_release, memory_order_relaxed))
+		;
+}
+
+/* record a new allocation of size bytes, guard included, made at block;
+ * returns the address after the block's header, handed to the program */
+static void *_Leaker_Add(void *block, size_t size, double weight, unsigned long long time,
+	const char *alloc, const char *file, const char *func, size_t line, void *caller)
+{
+	_LEAK_T *temp;
+	_HEADER_T *header = (_HEADER_T *)block;
+	_SITE_T *site = _Leaker_Site(file, func, line, caller);
+	_THREAD_T *thread = _Leaker_Thread();
+
+	_Leaker_Enter(thread);
+
+	temp = _Leaker_New_Entry(thread);
+	temp->addr = (char *)block + HEADER_SIZE;
 	temp->size = size;
-	temp->sequence = _leaker.serial++;
+	temp->weight = weight;
+	if (weight == 1.0)
+	{
+		temp->count = 1;
+		temp->bytes = size - GUARD_SIZE;
+	}
+	else
+	{
+		temp->count = _Leaker_Draw_Count(weight);
+		temp->bytes = temp->count * (size - GUARD_SIZE);
+	}
+	temp->site = site;
+	temp->time = time;
+	temp->sequence = _Leaker_Next_Serial();
 	temp->alloc = alloc;
 	temp->file = file;
 	temp->func = func;
 	temp->line = line;
-	temp->next = NULL;
 
-	*mover = temp;
+	thread->count++;
+	thread->bytes += size;
+	_Leaker_Count_Site(thread, temp, 1);
+	_Leaker_Add_Value(&thread->sizes, size - GUARD_SIZE, temp->count);
 
-	_leaker.count++;
-	_leaker.bytes += size;
+	_Leaker_Leave(thread);
+
+	header->entry = temp;
+	header->magic = _LEAKER_MAGIC;
+	return temp->addr;
 }
 
-/* remove an allocation from the table, and report any inconsistencies */
+/* take an allocation off the record, and report any inconsistencies; returns
+ * its size, guard included, or 0 if it was not tracked */
 size_t _Leaker_Remove(void *addr, const char *dealloc, const char *file,
-	const char *func, size_t line)
+	const char *func, size_t line, double *weight, unsigned long long *time)
 {
-	_LEAK_T **mover, *temp;
+	_HEADER_T *header;
+	_LEAK_T *temp;
+	_THREAD_T *thread;
 	size_t size;
 
-	if (!_leaker.table) _Leaker_Init();
-
-	mover = _Leaker_Find(addr);
-
-	if (!*mover) /* given a bad pointer */
+	/* given a bad pointer, or one that was not sampled */
+	if (!addr || (header = (_HEADER_T *)((char *)addr - HEADER_SIZE))->magic != _LEAKER_MAGIC)
 	{
-		fprintf(stdout, "\nLEAKER: %s:%s():%lu %s error: pointer was not allocated!\n\n",
-			file, func, line, dealloc);
-		_leaker.bad_frees++;
+		if (!_Leaker_Sampling())
+			_Leaker_Bad_Free(dealloc, file, func, line);
 		return 0;
 	}
 
-	temp = *mover;
-	*mover = temp->next;
-	_leaker.count--;
-	_leaker.bytes -= temp->size;
+	temp = header->entry;
+	header->magic = 0; /* so deallocating it again is caught */
+	thread = _Leaker_Thread();
+
+	_Leaker_Enter(thread);
+
+	thread->count--;
+	thread->bytes -= temp->size;
 
 	size = temp->size;
+	*weight = temp->weight;
+	*time = temp->time;
 
 	if (!_Leaker_Check_Guard(addr, temp->size)) /* guard overwritten */
 	{
 		fprintf(stdout, "\nLEAKER: %s:%s():%lu checking error: wrote off end of memory allocated at %s:%s():%lu.\n\n",
 			file, func, line, temp->file, temp->func, temp->line);
-		_leaker.overflows++;
+		thread->overflows++;
 	}
 	if (!_Leaker_Check_Dealloc(temp->alloc, dealloc)) /* wrong dealloc function */
 	{
 		fprintf(stdout, "\nLEAKER: %s:%s():%lu mismatch error: memory allocated at %s:%s():%lu with %s, deallocated with %s.\n\n",
 			file, func, line, temp->file, temp->func, temp->line,
 			temp->alloc, dealloc);
-		_leaker.mismatches++;
+		thread->mismatches++;
 	}
 
-	free(temp);
+	_Leaker_Count_Site(thread, temp, 0);
+	_Leaker_Free_Entry(thread, temp);
+	_Leaker_Leave(thread);
+
 	return size;
 }
 
-/* find a pointer in the table, return a pointer to a pointer to it */
-static _LEAK_T **_Leaker_Find(void *addr)
+/* report an attempt to deallocate a pointer that is not allocated */
+static void _Leaker_Bad_Free(const char *dealloc, const char *file, const char *func,
+	size_t line)
 {
-	_LEAK_T **mover = &(_leaker.table[_Leaker_Hash(addr)]);
-	while (*mover)
-	{
-		if ((*mover)->addr == addr) break;
+	_THREAD_T *thread = _Leaker_Thread();
 
-		mover = &((*mover)->next);
-	}
-	return mover;
+	fprintf(stdout, "\nLEAKER: %s:%s():%lu %s error: pointer was not allocated!\n\n",
+		file, func, line, dealloc);
+	_Leaker_Enter(thread);
+	thread->bad_frees++;
+	_Leaker_Leave(thread);
 }
 
 /* Thomas Wang's 64-bit hash function - works well for integers, and is
@@ -481,9 +1035,9 @@ static _LEAK_T **_Leaker_Find(void *addr)
  * better in distributing keys.
  * http://www.concentric.net/~Ttwang/tech/inthash.htm
  */
-static unsigned long _Leaker_Hash(void *addr)
+static size_t _Leaker_Hash(void *addr)
 {
-	unsigned long address = (unsigned long)addr;
+	size_t address = (size_t)addr;
 	address = (~address) + (address << 21); /* (a << 21) - a - 1; */
 	address = address ^ (address >> 24);
 	address = (address + (address << 3)) + (address << 8); /* a * 265 */
@@ -491,22 +1045,600 @@ static unsigned long _Leaker_Hash(void *addr)
 	address = (address + (address << 2)) + (address << 4); /* a * 21 */
 	address = address ^ (address >> 28);
 	address = address + (address << 31);
-	return address % _leaker.rows;
+	return address;
 }
 
-/* return 1 if the allocator and deallocator are compatible, 0 otherwise */
-static int _Leaker_Check_Dealloc(const char *alloc, const char *dealloc)
+/* return the next sequence number for the calling thread */
+static size_t _Leaker_Next_Serial(void)
 {
-	if ((strcmp(dealloc, "free") == 0) || (strcmp(dealloc, "realloc") == 0))
+	if (_leaker_serial_next == _leaker_serial_end)
 	{
-		if (strcmp(alloc, "malloc") == 0) return 1;
-		else if (strcmp(alloc, "calloc") == 0) return 1;
-		else if (strcmp(alloc, "realloc") == 0) return 1;
-		else return 0;
+		_leaker_serial_next = atomic_fetch_add_explicit(&_leaker_serial,
+			(size_t)SERIAL_BLOCK, memory_order_relaxed);
+		_leaker_serial_end = _leaker_serial_next + SERIAL_BLOCK;
 	}
-	if ((strcmp(alloc, "new") == 0) && (strcmp(dealloc, "delete") == 0))
+	return _leaker_serial_next++;
+}
+
+/* read LEAKER_SAMPLE_RATE and LEAKER_TIMING the first time sampling is
+ * consulted; returns the current generation */
+static size_t _Leaker_Configure(void)
+{
+	size_t generation = atomic_load_explicit(&_leaker_sample_generation, memory_order_acquire);
+
+	if (generation) return generation;
+
+	while (atomic_flag_test_and_set_explicit(&_leaker_config_lock, memory_order_acquire))
+		;
+	generation = atomic_load_explicit(&_leaker_sample_generation, memory_order_acquire);
+	if (!generation)
+	{
+		const char *env = getenv("LEAKER_SAMPLE_RATE");
+		size_t rate = env ? (size_t)strtoul(env, NULL, 10) : 0;
+
+		atomic_store_explicit(&_leaker_sample_rate, rate, memory_order_relaxed);
+		if (rate) atomic_store_explicit(&_leaker_sampling_used, (size_t)1, memory_order_relaxed);
+		env = getenv("LEAKER_TIMING");
+		atomic_store_explicit(&_leaker_timing, (size_t)(env && strtoul(env, NULL, 10) != 0),
+			memory_order_relaxed);
+		generation = 1;
+		atomic_store_explicit(&_leaker_sample_generation, generation, memory_order_release);
+	}
+	atomic_flag_clear_explicit(&_leaker_config_lock, memory_order_release);
+	return generation;
+}
+
+/* decide whether to track an allocation of size bytes (Poisson byte sampling:
+ * each byte is picked with probability 1/rate, an allocation is tracked if any
+ * of its bytes is); sets weight to the number of allocations of this size that
+ * a tracked one stands for */
+static int _Leaker_Sample(size_t size, double *weight)
+{
+	size_t generation = _Leaker_Configure();
+	size_t rate = atomic_load_explicit(&_leaker_sample_rate, memory_order_relaxed);
+
+	*weight = 1.0;
+	return !rate || _Leaker_Sample_Bytes(size, rate, generation, weight);
+}
+
+/* the sampling decision, kept apart so tracking everything stays cheap to inline */
+static int _Leaker_Sample_Bytes(size_t size, size_t rate, size_t generation, double *weight)
+{
+	if (_leaker_sample_seen != generation)
+	{
+		_leaker_sample_seen = generation;
+		_leaker_sample_left = _Leaker_Next_Sample(rate);
+	}
+
+	/* zero-byte allocations still get an address, so count them as one byte */
+	if (!size) size = 1;
+
+	_leaker_sample_left -= (double)size;
+	if (_leaker_sample_left > 0) return 0;
+
+	/* gaps between picked bytes are memoryless, so a fresh one can be drawn */
+	_leaker_sample_left = _Leaker_Next_Sample(rate);
+	*weight = 1.0 / -expm1(-(double)size / (double)rate);
+	return 1;
+}
+
+/* draw the number of bytes until the next sample, exponential with mean rate */
+static double _Leaker_Next_Sample(size_t rate)
+{
+	return -log(_Leaker_Uniform()) * (double)rate;
+}
+
+/* return a number uniform in (0, 1] from the calling thread's xorshift generator */
+static double _Leaker_Uniform(void)
+{
+	unsigned long long x = _leaker_random;
+
+	if (!x) x = (unsigned long long)_Leaker_Hash((void *)&_leaker_random) | 1;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	_leaker_random = x;
+
+	/* the top 53 bits */
+	return (double)(((x * 2685821657736338717ULL) >> 11) + 1) / 9007199254740992.0;
+}
+
+/* return the whole number of allocations a sampled one counts as: the weight
+ * rounded down, or up with probability equal to its fraction, so that the
+ * counts add up to the weights on average instead of drifting with rounding */
+static size_t _Leaker_Draw_Count(double weight)
+{
+	size_t count = (size_t)weight;
+
+	return count + (_Leaker_Uniform() <= weight - (double)count);
+}
+
+/* return 1 if sampling has ever been on, so unknown pointers may be unsampled */
+static int _Leaker_Sampling(void)
+{
+	return atomic_load_explicit(&_leaker_sampling_used, memory_order_relaxed) != 0;
+}
+
+/* common part of free and the delete operators */
+static void _Leaker_Free(void *ptr, const char *dealloc, const char *file,
+	const char *func, unsigned long line)
+{
+	size_t size;
+	double weight;
+	unsigned long long time, start;
+
+	if ((size = _Leaker_Remove(ptr, dealloc, file, func, line, &weight, &time)))
+	{
+		_Leaker_Scribble(ptr, size);
+		/* allocations made while timing was off have no time to measure from */
+		start = time ? _Leaker_Start_Timing() : 0;
+		free((char *)ptr - HEADER_SIZE);
+		if (start)
+		{
+			_Leaker_Record(_LEAKER_LIFETIMES, start - time, weight);
+			_Leaker_Stop_Timing(start, _LEAKER_FREE_TIMES, weight);
+		}
+	}
+	else if (_Leaker_Sampling()) /* an allocation that was not sampled */
+		free(ptr);
+}
+
+/* find or add the site for a call site; called without any lock held */
+static _SITE_T *_Leaker_Site(const char *file, const char *func, size_t line, void *caller)
+{
+	_SITE_T *site = _leaker_last_site;
+	size_t row;
+
+	if (site && site->file == file && site->line == line && site->func == func
+		&& site->caller == caller)
+		return site;
+
+	row = _Leaker_Hash((void *)((size_t)file ^ (size_t)caller ^ (line << 4))) % SITE_ROWS;
+	for (site = atomic_load_explicit(&_leaker_sites[row], memory_order_acquire); site;
+		site = atomic_load_explicit(&site->next, memory_order_acquire))
+	{
+		if (site->file == file && site->line == line && site->func == func
+			&& site->caller == caller)
+			break;
+	}
+
+	if (!site)
+	{
+		while (atomic_flag_test_and_set_explicit(&_leaker_site_lock, memory_order_acquire))
+			;
+
+		/* another thread may have added it in the meantime */
+		for (site = atomic_load_explicit(&_leaker_sites[row], memory_order_acquire); site;
+			site = atomic_load_explicit(&site->next, memory_order_acquire))
+		{
+			if (site->file == file && site->line == line && site->func == func
+				&& site->caller == caller)
+				break;
+		}
+
+		if (!site)
+		{
+			if (!(site = (_SITE_T *)calloc(1, sizeof(_SITE_T))))
+			{
+				fprintf(stdout, "%s:%s():%i aborting: calloc() for site failed!\n",
+					__FILE__, __func__, __LINE__);
+				exit(2);
+			}
+			site->file = file;
+			site->func = func;
+			site->line = line;
+			site->caller = caller;
+			atomic_store_explicit(&site->next,
+				atomic_load_explicit(&_leaker_sites[row], memory_order_relaxed),
+				memory_order_relaxed);
+			atomic_store_explicit(&_leaker_sites[row], site, memory_order_release);
+		}
+
+		atomic_flag_clear_explicit(&_leaker_site_lock, memory_order_release);
+	}
+
+	_leaker_last_site = site;
+	return site;
+}
+
+/* add an allocation to its site's totals, or take a deallocation off them;
+ * sampled allocations count for the allocations and bytes they stand for.
+ * The change goes into the thread's tally for the site, which is added to
+ * the site every TALLY_OPS changes, when another site needs the row, or when
+ * the threads are stopped. Called with the thread busy. */
+static void _Leaker_Count_Site(_THREAD_T *thread, _LEAK_T *entry, int allocated)
+{
+	_SITE_T *site = entry->site;
+	_TALLY_T *tally = &thread->tallies[((size_t)site / sizeof(_SITE_T)) & (TALLY_ROWS - 1)];
+	size_t count = entry->count, bytes = entry->bytes;
+
+	if (tally->site != site)
+	{
+		if (tally->ops) _Leaker_Flush_Tally(tally);
+		tally->site = site;
+	}
+
+	if (allocated)
+	{
+		tally->count += count;
+		tally->bytes += bytes;
+		tally->live += bytes;
+		if ((ptrdiff_t)tally->live > (ptrdiff_t)tally->high) tally->high = tally->live;
+	}
+	else
+	{
+		tally->live -= bytes;
+		tally->frees += count;
+	}
+
+	if (++tally->ops == TALLY_OPS) _Leaker_Flush_Tally(tally);
+}
+
+/* add a tally's changes to its site's totals and empty it */
+static void _Leaker_Flush_Tally(_TALLY_T *tally)
+{
+	_SITE_T *site = tally->site;
+	size_t live = atomic_fetch_add_explicit(&site->live, tally->live, memory_order_relaxed);
+	size_t peak = atomic_load_explicit(&site->peak, memory_order_relaxed);
+
+	atomic_fetch_add_explicit(&site->count, tally->count, memory_order_relaxed);
+	atomic_fetch_add_explicit(&site->bytes, tally->bytes, memory_order_relaxed);
+	atomic_fetch_add_explicit(&site->frees, tally->frees, memory_order_relaxed);
+
+	/* the highest live got while the tally was held; live is below zero when
+	 * one thread's frees were added in before another's allocations */
+	live = (live > (~(size_t)0 >> 1) ? 0 : live) + tally->high;
+	while (live > peak && !atomic_compare_exchange_weak_explicit(&site->peak, &peak, live,
+		memory_order_relaxed, memory_order_relaxed))
+		;
+
+	tally->count = 0;
+	tally->bytes = 0;
+	tally->live = 0;
+	tally->high = 0;
+	tally->frees = 0;
+	tally->ops = 0;
+}
+
+/* add every tally of a thread to its site; called with the thread busy or stopped */
+static void _Leaker_Flush_Tallies(_THREAD_T *thread)
+{
+	unsigned int i;
+
+	for (i = 0; i < TALLY_ROWS; i++)
+	{
+		if (thread->tallies[i].ops) _Leaker_Flush_Tally(&thread->tallies[i]);
+	}
+}
+
+/* write a readable name for a call site: "func (file:line)", or for sites the
+ * new macro did not see, the function new was called from and the offset of the
+ * call in it ("func+0x1c"). Calls inlined into one function are separate sites,
+ * told apart by the offset, which addr2line can turn into a line. */
+static void _Leaker_Site_Name(const _SITE_T *site, char *name, size_t size)
+{
+	if (!site->caller)
+	{
+		snprintf(name, size, "%s (%s:%lu)", site->func, site->file, (unsigned long)site->line);
+		return;
+	}
+
+#ifdef _LEAKER_DLADDR
+	{
+		Dl_info info;
+		if (dladdr(site->caller, &info))
+		{
+			if (info.dli_sname)
+			{
+				unsigned long offset = (unsigned long)((char *)site->caller
+					- (char *)info.dli_saddr);
+#if defined(__cplusplus) && defined(__GNUC__)
+				int status;
+				char *demangled = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+				if (demangled)
+				{
+					snprintf(name, size, "%s+%#lx", demangled, offset);
+					free(demangled);
+					return;
+				}
+#endif
+				snprintf(name, size, "%s+%#lx", info.dli_sname, offset);
+				return;
+			}
+			if (info.dli_fname)
+			{
+				const char *base = strrchr(info.dli_fname, '/');
+				snprintf(name, size, "%s+%#lx", base ? base + 1 : info.dli_fname,
+					(unsigned long)((char *)site->caller - (char *)info.dli_fbase));
+				return;
+			}
+		}
+	}
+#endif
+
+	snprintf(name, size, "%p", site->caller);
+}
+
+/* return the index of a metric name, or -1 if it is unknown */
+static int _Leaker_Metric(const char *metric)
+{
+	static const char *metrics[] = { "count", "bytes", "live", "peak", "frees" };
+	int i;
+
+	for (i = 0; i < 5; i++)
+	{
+		if (strcmp(metric, metrics[i]) == 0) return i;
+	}
+	return -1;
+}
+
+/* return one of a site's totals, by metric index */
+static size_t _Leaker_Site_Value(_SITE_T *site, int metric)
+{
+	switch (metric)
+	{
+	case 0: return atomic_load_explicit(&site->count, memory_order_relaxed);
+	case 1: return atomic_load_explicit(&site->bytes, memory_order_relaxed);
+	case 2: return atomic_load_explicit(&site->live, memory_order_relaxed);
+	case 3: return atomic_load_explicit(&site->peak, memory_order_relaxed);
+	default: return atomic_load_explicit(&site->frees, memory_order_relaxed);
+	}
+}
+
+/* return every site, most bytes allocated first; the caller frees the list */
+static _SITE_T **_Leaker_Build_Sites(size_t *count)
+{
+	_SITE_T **sites, *site;
+	size_t i, n = 0;
+
+	for (i = 0; i < SITE_ROWS; i++)
+	{
+		for (site = atomic_load_explicit(&_leaker_sites[i], memory_order_acquire); site;
+			site = atomic_load_explicit(&site->next, memory_order_acquire))
+			n++;
+	}
+
+	/* sites added while counting are left for the next call */
+	if (!(sites = (_SITE_T **)malloc(sizeof(_SITE_T *) * (n ? n : 1))))
+	{
+		fprintf(stdout, "%s:%s():%i aborting: malloc failed!\n",
+			__FILE__, __func__, __LINE__);
+		exit(2);
+	}
+
+	*count = 0;
+	for (i = 0; i < SITE_ROWS && *count < n; i++)
+	{
+		for (site = atomic_load_explicit(&_leaker_sites[i], memory_order_acquire);
+			site && *count < n; site = atomic_load_explicit(&site->next, memory_order_acquire))
+			sites[(*count)++] = site;
+	}
+
+	qsort((void *)sites, *count, sizeof(_SITE_T *), _Leaker_Compare_Sites_By_Bytes);
+	return sites;
+}
+
+/* order sites by bytes allocated, largest first */
+static int _Leaker_Compare_Sites_By_Bytes(const void *first, const void *second)
+{
+	size_t f = _Leaker_Site_Value(*(_SITE_T **)first, 1);
+	size_t s = _Leaker_Site_Value(*(_SITE_T **)second, 1);
+
+	return (f < s) - (f > s);
+}
+
+/* print every site's totals */
+static void _Leaker_Print_Sites(void)
+{
+	size_t count, i;
+	_SITE_T **sites = _Leaker_Build_Sites(&count);
+	char name[512];
+
+	if (count)
+		fprintf(stdout, "Call sites (allocations, bytes, live bytes, peak live bytes, frees):\n");
+	for (i = 0; i < count; i++)
+	{
+		_Leaker_Site_Name(sites[i], name, sizeof(name));
+		fprintf(stdout, "%s: %lu %lu %lu %lu %lu\n", name,
+			(unsigned long)_Leaker_Site_Value(sites[i], 0),
+			(unsigned long)_Leaker_Site_Value(sites[i], 1),
+			(unsigned long)_Leaker_Site_Value(sites[i], 2),
+			(unsigned long)_Leaker_Site_Value(sites[i], 3),
+			(unsigned long)_Leaker_Site_Value(sites[i], 4));
+	}
+	if (count) fprintf(stdout, "\n");
+	free(sites);
+}
+
+/* return a monotonic time in nanoseconds */
+static unsigned long long _Leaker_Now(void)
+{
+#ifdef __cplusplus
+	return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+#elif defined(CLOCK_MONOTONIC)
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+#else
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+/* return 1 if lifetimes and latencies are timed */
+static int _Leaker_Timing(void)
+{
+	_Leaker_Configure();
+	return atomic_load_explicit(&_leaker_timing, memory_order_relaxed) != 0;
+}
+
+/* return the time before an allocator call, or 0 if timing is off */
+static unsigned long long _Leaker_Start_Timing(void)
+{
+	return _Leaker_Timing() ? _Leaker_Now() : 0;
+}
+
+/* record the latency of an allocator call timed from start in one of the
+ * thread's histograms, unless start is 0; returns the time it completed, or 0 */
+static unsigned long long _Leaker_Stop_Timing(unsigned long long start, size_t hist, double weight)
+{
+	unsigned long long time;
+
+	if (!start) return 0;
+	time = _Leaker_Now();
+	_Leaker_Record(hist, time - start, weight);
+	return time;
+}
+
+/* return the histogram bucket of a value */
+static unsigned int _Leaker_Bucket(size_t value)
+{
+	unsigned int exponent = 0;
+
+	if (value < ((size_t)1 << HIST_SUB_BITS)) return (unsigned int)value;
+
+#if defined(__GNUC__)
+	exponent = (unsigned int)(sizeof(unsigned long long) * 8 - 1
+		- __builtin_clzll((unsigned long long)value));
+#else
+	while (value >> (exponent + 1)) exponent++;
+#endif
+	return ((exponent - HIST_SUB_BITS + 1) << HIST_SUB_BITS)
+		+ (unsigned int)((value >> (exponent - HIST_SUB_BITS)) & ((1 << HIST_SUB_BITS) - 1));
+}
+
+/* return the smallest value that falls in a bucket */
+static size_t _Leaker_Bucket_Floor(unsigned int bucket)
+{
+	unsigned int exponent;
+
+	if (bucket < (1u << HIST_SUB_BITS)) return bucket;
+
+	exponent = (bucket >> HIST_SUB_BITS) + HIST_SUB_BITS - 1;
+	return ((size_t)((1u << HIST_SUB_BITS) + (bucket & ((1u << HIST_SUB_BITS) - 1))))
+		<< (exponent - HIST_SUB_BITS);
+}
+
+/* add a value to one of the calling thread's histograms, given by its offset
+ * in _THREAD_T */
+static void _Leaker_Record(size_t hist, size_t value, double weight)
+{
+	_THREAD_T *thread = _Leaker_Thread();
+
+	_Leaker_Enter(thread);
+	_Leaker_Add_Value((_HIST_T *)((char *)thread + hist), value, _Leaker_Draw_Count(weight));
+	_Leaker_Leave(thread);
+}
+
+/* add a value to a histogram count times; a sampled allocation counts as the
+ * number of allocations it stands for */
+static void _Leaker_Add_Value(_HIST_T *hist, size_t value, size_t count)
+{
+	hist->buckets[_Leaker_Bucket(value)] += count;
+	hist->count += count;
+	hist->sum += value * count;
+	if (value > hist->max) hist->max = value;
+}
+
+/* add up one histogram, given by its offset in _THREAD_T, over every thread;
+ * called with the threads stopped */
+static void _Leaker_Gather(_HIST_T *total, size_t hist)
+{
+	_THREAD_T *thread;
+	unsigned int i;
+
+	memset(total, 0, sizeof(*total));
+	for (thread = _leaker_threads; thread; thread = thread->next)
+	{
+		_HIST_T *part = (_HIST_T *)((char *)thread + hist);
+
+		for (i = 0; i < HIST_BUCKETS; i++)
+			total->buckets[i] += part->buckets[i];
+		total->count += part->count;
+		total->sum += part->sum;
+		if (part->max > total->max) total->max = part->max;
+	}
+}
+
+/* print a histogram's percentiles, then its counts per power of two */
+static void _Leaker_Print_Histogram(_HIST_T *hist, const char *name, const char *unit)
+{
+	static const double percentiles[] = { 50, 90, 99, 99.9 };
+	size_t *counts = hist->buckets;
+	size_t count = 0, seen = 0, max = hist->max;
+	unsigned int i, p = 0;
+
+	for (i = 0; i < HIST_BUCKETS; i++)
+		count += counts[i];
+
+	fprintf(stdout, "%s (%s): %lu recorded", name, unit, (unsigned long)count);
+	if (!count)
+	{
+		fprintf(stdout, ".\n");
+		return;
+	}
+	fprintf(stdout, ", mean %.1f", (double)hist->sum / (double)count);
+
+	/* report the top of the bucket each percentile falls in */
+	for (i = 0; i < HIST_BUCKETS && p < 4; i++)
+	{
+		seen += counts[i];
+		while (p < 4 && (double)seen >= percentiles[p] / 100.0 * (double)count)
+		{
+			size_t top = i + 1 < HIST_BUCKETS ? _Leaker_Bucket_Floor(i + 1) - 1 : max;
+			fprintf(stdout, ", p%g %lu", percentiles[p], (unsigned long)(top < max ? top : max));
+			p++;
+		}
+	}
+	fprintf(stdout, ", max %lu.\n", (unsigned long)max);
+
+	for (i = 0; i < HIST_BUCKETS; i += 1u << HIST_SUB_BITS)
+	{
+		unsigned int j, last = i + (1u << HIST_SUB_BITS);
+		size_t power = 0;
+
+		for (j = i; j < last; j++)
+			power += counts[j];
+		if (power)
+			fprintf(stdout, "  %lu-%lu: %lu (%.1f%%)\n", (unsigned long)_Leaker_Bucket_Floor(i),
+				(unsigned long)(last < HIST_BUCKETS ? _Leaker_Bucket_Floor(last) - 1 : max),
+				(unsigned long)power, 100.0 * (double)power / (double)count);
+	}
+}
+
+/* print every histogram; called with the threads stopped, which also keeps
+ * other reports from using the totals */
+static void _Leaker_Print_Histograms(void)
+{
+	static _HIST_T sizes, lifetimes, alloc_times, free_times;	/* too large for some stacks */
+
+	_Leaker_Gather(&sizes, _LEAKER_SIZES);
+	_Leaker_Gather(&lifetimes, _LEAKER_LIFETIMES);
+	_Leaker_Gather(&alloc_times, _LEAKER_ALLOC_TIMES);
+	_Leaker_Gather(&free_times, _LEAKER_FREE_TIMES);
+
+	_Leaker_Print_Histogram(&sizes, "Allocation sizes", "bytes");
+	if (!_Leaker_Timing() && !lifetimes.count && !alloc_times.count)
+	{
+		fprintf(stdout, "Lifetimes and latencies not timed (set LEAKER_TIMING=1).\n\n");
+		return;
+	}
+	_Leaker_Print_Histogram(&lifetimes, "Lifetimes until deallocated", "ns");
+	_Leaker_Print_Histogram(&alloc_times, "Allocation latency", "ns");
+	_Leaker_Print_Histogram(&free_times, "Deallocation latency", "ns");
+	fprintf(stdout, "\n");
+}
+
+/* return 1 if the allocator and deallocator are compatible, 0 otherwise */
+static int _Leaker_Check_Dealloc(const char *alloc, const char *dealloc)
+{
+	if (dealloc == _leaker_free || dealloc == _leaker_realloc)
+		return alloc == _leaker_malloc || alloc == _leaker_calloc || alloc == _leaker_realloc;
+	if (alloc == _leaker_new && dealloc == _leaker_delete)
 		return 1;
-	if ((strcmp(alloc, "new[]") == 0) && (strcmp(dealloc, "delete[]") == 0))
+	if (alloc == _leaker_new_array && dealloc == _leaker_delete_array)
 		return 1;
 
 	return 0;
@@ -515,13 +1647,13 @@ static int _Leaker_Check_Dealloc(const char *alloc, const char *dealloc)
 /* initialize the guard at the end of the allocation */
 static void _Leaker_Init_Guard(void *addr, size_t size)
 {
-	strncpy((char *)addr + size - GUARD_SIZE, GUARD_STR, GUARD_SIZE);
+	memcpy((char *)addr + size - GUARD_SIZE, GUARD_STR, GUARD_SIZE);
 }
 
 /* verify the guard at the end of the allocation, return 1 if successful */
 static int _Leaker_Check_Guard(void *addr, size_t size)
 {
-	return (strncmp((char *)addr + size - GUARD_SIZE, GUARD_STR, GUARD_SIZE)
+	return (memcmp((char *)addr + size - GUARD_SIZE, GUARD_STR, GUARD_SIZE)
 		== 0);
 }
 
@@ -531,68 +1663,153 @@ static void _Leaker_Scribble(void *ptr, size_t size)
 	memset(ptr, '\0', size);
 }
 
-/* report leaks and errors, and deallocate all remaining memory */
+/* report leaks and errors; the records are kept, as static objects destroyed
+ * after this still deallocate */
 static void _Leaker_Report(void)
 {
-	if (!(_leaker.count || _leaker.mismatches || _leaker.overflows
-		|| _leaker.bad_frees))
+	_LEAKER_SUM_T sum;
+	const char *profile = getenv("LEAKER_PROFILE");
+
+	if (profile && *profile && !_Leaker_Write_Profile(profile, getenv("LEAKER_PROFILE_METRIC")))
+		fprintf(stdout, "\nLEAKER: could not write profile to %s.\n", profile);
+
+	_Leaker_Stop_All();
+	_Leaker_Sum(&sum);
+
+	if (!(sum.count || sum.mismatches || sum.overflows || sum.bad_frees))
 	{
-		if (_leaker.table) free(_leaker.table);
+		_Leaker_Start_All();
 		return;
 	}
 
 	fprintf(stdout, "\nLEAKER: errors found!\n");
 
-	if (_leaker.count) /* print out list of leaks, clean up */
+	if (sum.count) /* print leaks per call site */
 	{
-		unsigned int i;
-		_LEAK_T **table = _Leaker_Build_List();
+		size_t count, i, top = _Leaker_Report_Top();
+		size_t rest = 0, rest_leaks = 0, rest_bytes = 0;
+		int sampling = _Leaker_Sampling();
+		_SITE_T **sites = _Leaker_Collect_Leaks(&count);
+		_LEAKER_BUFFER_T buffer = { NULL, 0, 0 };
 
-		fprintf(stdout, "Leaks found: %lu allocations (%lu bytes).\n",
-			_leaker.count, _leaker.bytes - _leaker.count * GUARD_SIZE);
+		_Leaker_Append(&buffer, "Leaks found: %lu allocations (%lu bytes) from %lu call sites.\n",
+			(unsigned long)sum.count, (unsigned long)(sum.bytes - sum.count * GUARD_SIZE),
+			(unsigned long)count);
 
-		for (i = 0; i < _leaker.count; i++)
+		for (i = 0; i < count; i++)
 		{
-			_Leaker_Print_Entry(table[i]);
-			free(table[i]->addr);
-			free(table[i]);
+			_SITE_T *site = sites[i];
+			char name[512];
+
+			if (top && i >= top)
+			{
+				rest++;
+				rest_leaks += site->leaks;
+				rest_bytes += site->leaked_bytes;
+				continue;
+			}
+
+			_Leaker_Site_Name(site, name, sizeof(name));
+			_Leaker_Append(&buffer, "%s memory leak: %lu allocations (%lu bytes) not deallocated",
+				name, (unsigned long)site->leaks, (unsigned long)site->leaked_bytes);
+			if (sampling)
+				_Leaker_Append(&buffer, ", estimated ~%.0f allocations (~%.0f bytes)",
+					site->estimated_leaks, site->estimated_bytes);
+			if (site->overflowed)
+				_Leaker_Append(&buffer, ", %lu wrote off end", (unsigned long)site->overflowed);
+			_Leaker_Append(&buffer, ".\n");
 		}
-
-		fprintf(stdout, "\n");
-		free(table);
+		if (rest)
+			_Leaker_Append(&buffer, "... %lu more call sites: %lu allocations (%lu bytes).\n",
+				(unsigned long)rest, (unsigned long)rest_leaks, (unsigned long)rest_bytes);
+		_Leaker_Append(&buffer, "\n");
+
+		if (buffer.data) fwrite(buffer.data, 1, buffer.length, stdout);
+		free(buffer.data);
+		free(sites);
 	}
 
-	if (_leaker.table) free(_leaker.table);
-
 	/* report other errors */
-	if (_leaker.mismatches)
+	_Leaker_Sum(&sum);
+	if (sum.mismatches)
 		fprintf(stdout, "Mismatches: %lu allocation/deallocations don't match.\n",
-			_leaker.mismatches);
+			sum.mismatches);
 
-	if (_leaker.overflows)
+	if (sum.overflows)
 		fprintf(stdout, "Overflows: %lu allocations overflowed (wrote off end).\n",
-			_leaker.overflows);
-	if (_leaker.bad_frees)
+			sum.overflows);
+	if (sum.bad_frees)
 		fprintf(stdout, "Bad deallocs: %lu attempts made to deallocate unallocated pointers.\n",
-			_leaker.bad_frees);
+			sum.bad_frees);
 
+	_Leaker_Start_All();
 }
 
-/* print the given entry */
-static void _Leaker_Print_Entry(_LEAK_T *entry)
+/* total the outstanding allocations of each call site and check their guards;
+ * returns the sites with leaks, most bytes first. Entries are visited slab by
+ * slab rather than through the tables, which keeps the walk roughly in
+ * allocation order. The leaked blocks themselves are left to the operating
+ * system, as freeing millions of them one by one would take most of the time.
+ * Called with the threads stopped. */
+static _SITE_T **_Leaker_Collect_Leaks(size_t *count)
 {
-	fprintf(stdout, "%s:%s():%lu memory leak: memory was not deallocated.\n",
-		entry->file, entry->func, entry->line);
-	if (!_Leaker_Check_Guard(entry->addr, entry->size))
+	_SITE_T *leaked = NULL, **sites;
+	_THREAD_T *thread;
+	size_t i;
+
+	*count = 0;
+	for (thread = _leaker_threads; thread; thread = thread->next)
 	{
-		fprintf(stdout, "%s:%s():%lu checking error: wrote off end of allocation.\n",
-			entry->file, entry->func, entry->line);
-		_leaker.overflows++;
+		_SLAB_T *slab;
+		size_t used = thread->carved;
+
+		for (slab = thread->slabs; slab; slab = slab->next, used = SLAB_ENTRIES)
+		{
+			for (i = 0; i < used; i++)
+			{
+				_LEAK_T *entry = &slab->entries[i];
+				_SITE_T *site = entry->site;
+
+				if (!entry->addr) continue;
+
+				if (!site->leaks)
+				{
+					site->leaked_bytes = 0;
+					site->overflowed = 0;
+					site->estimated_leaks = 0;
+					site->estimated_bytes = 0;
+					site->leaked_next = leaked;
+					leaked = site;
+					(*count)++;
+				}
+				site->leaks++;
+				site->leaked_bytes += entry->size - GUARD_SIZE;
+				site->estimated_leaks += entry->weight;
+				site->estimated_bytes += entry->weight * (double)(entry->size - GUARD_SIZE);
+
+				if (!_Leaker_Check_Guard(entry->addr, entry->size))
+				{
+					site->overflowed++;
+					thread->overflows++;
+				}
+			}
+		}
 	}
-}
 
-/* dump the given entry */
-static void _Leaker_Dump_Entry(_LEAK_T *entry)
+	if (!(sites = (_SITE_T **)malloc(sizeof(_SITE_T *) * (*count ? *count : 1))))
+	{
+		fprintf(stdout, "%s:%s():%i aborting: malloc failed!\n",
+			__FILE__, __func__, __LINE__);
+		exit(2);
+	}
+	for (i = 0; leaked; leaked = leaked->leaked_next)
+		sites[i++] = leaked;
+
+	qsort((void *)sites, *count, sizeof(_SITE_T *), _Leaker_Compare_Leaks);
+	return sites;
+}
+/* dump the given entry; returns 1 if it overflowed */
+static int _Leaker_Dump_Entry(_LEAK_T *entry)
 {
 	fprintf(stdout, "%s:%s():%lu address: %p bytes: %lu",
 		entry->file, entry->func, entry->line, entry->addr,
@@ -600,10 +1817,10 @@ static void _Leaker_Dump_Entry(_LEAK_T *entry)
 	if (!_Leaker_Check_Guard(entry->addr, entry->size))
 	{
 		fprintf(stdout, " OVERFLOWED.\n");
-		_leaker.overflows++;
+		return 1;
 	}
-	else
-		fprintf(stdout, ".\n");
+	fprintf(stdout, ".\n");
+	return 0;
 }
 
 /* compare two leak entries based upon their sequence number */
@@ -611,18 +1828,110 @@ static int _Leaker_Compare_Entries(const void *first, const void *second)
 {
 	const _LEAK_T *f = *(_LEAK_T **)first, *s = *(_LEAK_T **)second;
 
-	return (int)(f->sequence - s->sequence);
+	return (f->sequence > s->sequence) - (f->sequence < s->sequence);
+}
+
+/* order leak entries by call site */
+static int _Leaker_Compare_Sites(const void *first, const void *second)
+{
+	const _SITE_T *f = (*(_LEAK_T **)first)->site, *s = (*(_LEAK_T **)second)->site;
+
+	return (f > s) - (f < s);
+}
+
+/* print estimated allocations and bytes per call site from sampled entries;
+ * reorders table */
+static void _Leaker_Print_Estimates(_LEAK_T **table, size_t count)
+{
+	double total_count = 0, total_bytes = 0;
+	size_t i = 0;
+
+	qsort((void *)table, count, sizeof(_LEAK_T *), _Leaker_Compare_Sites);
+
+	fprintf(stdout, "Sampling one allocation per %lu bytes; estimated by call site:\n",
+		(unsigned long)_Leaker_Get_Sample_Rate());
+	while (i < count)
+	{
+		_SITE_T *site = table[i]->site;
+		double site_count = 0, site_bytes = 0;
+		char name[512];
+
+		for (; i < count && table[i]->site == site; i++)
+		{
+			site_count += table[i]->weight;
+			site_bytes += table[i]->weight * (double)(table[i]->size - GUARD_SIZE);
+		}
+		_Leaker_Site_Name(site, name, sizeof(name));
+		fprintf(stdout, "%s ~%.0f allocations (~%.0f bytes).\n",
+			name, site_count, site_bytes);
+		total_count += site_count;
+		total_bytes += site_bytes;
+	}
+	fprintf(stdout, "Estimated total: ~%.0f allocations (~%.0f bytes).\n\n",
+		total_count, total_bytes);
+}
+
+/* order sites by bytes leaked, largest first */
+static int _Leaker_Compare_Leaks(const void *first, const void *second)
+{
+	const _SITE_T *f = *(_SITE_T **)first, *s = *(_SITE_T **)second;
+
+	return (f->leaked_bytes < s->leaked_bytes) - (f->leaked_bytes > s->leaked_bytes);
+}
+
+/* return the number of call sites the exit report lists, 0 for all */
+static size_t _Leaker_Report_Top(void)
+{
+	size_t top = atomic_load_explicit(&_leaker_report_top, memory_order_relaxed);
+	const char *env;
+
+	if (top) return top - 1;
+	env = getenv("LEAKER_REPORT_TOP");
+	return env ? (size_t)strtoul(env, NULL, 10) : 0;
 }
 
-/* build and return a sorted list of leak entry pointers */
-static _LEAK_T **_Leaker_Build_List(void)
+/* append formatted text to a report buffer, growing it as needed */
+static void _Leaker_Append(_LEAKER_BUFFER_T *buffer, const char *format, ...)
+{
+	va_list args;
+	int length;
+
+	for (;;)
+	{
+		size_t room = buffer->capacity - buffer->length;
+
+		va_start(args, format);
+		length = vsnprintf(buffer->data ? buffer->data + buffer->length : NULL, room, format, args);
+		va_end(args);
+
+		if (length < 0) return;
+		if ((size_t)length < room)
+		{
+			buffer->length += (size_t)length;
+			return;
+		}
+
+		buffer->capacity = buffer->capacity * 2 + (size_t)length + 1;
+		if (!(buffer->data = (char *)realloc(buffer->data, buffer->capacity)))
+		{
+			fprintf(stdout, "%s:%s():%i aborting: realloc failed!\n",
+				__FILE__, __func__, __LINE__);
+			exit(2);
+		}
+	}
+}
+
+/* build and return a sorted list of the count entries of all threads;
+ * called with the threads stopped */
+static _LEAK_T **_Leaker_Build_List(size_t count)
 {
 	_LEAK_T **table, **mover;
-	unsigned int i;
+	_THREAD_T *thread;
+	size_t i;
 
-	if (!_leaker.table || !_leaker.count) return NULL;
+	if (!count) return NULL;
 
-	if (!(table = (_LEAK_T **)malloc(sizeof(_LEAK_T *) * _leaker.count)))
+	if (!(table = (_LEAK_T **)malloc(sizeof(_LEAK_T *) * count)))
 	{
 		fprintf(stdout, "%s:%s():%i aborting: malloc failed!\n",
 			__FILE__, __func__, __LINE__);
@@ -631,19 +1940,22 @@ static _LEAK_T **_Leaker_Build_List(void)
 
 	mover = table;
 
-	for (i = 0; i < _leaker.rows; i++)
+	for (thread = _leaker_threads; thread; thread = thread->next)
 	{
-		_LEAK_T *temp = _leaker.table[i];
+		_SLAB_T *slab;
+		size_t used = thread->carved;
 
-		while (temp)
+		for (slab = thread->slabs; slab; slab = slab->next, used = SLAB_ENTRIES)
 		{
-			*mover = temp;
-			mover++;
-			temp = temp->next;
+			for (i = 0; i < used; i++)
+			{
+				if (slab->entries[i].addr)
+					*mover++ = &slab->entries[i];
+			}
 		}
 	}
 
-	qsort((void *)table, _leaker.count, sizeof(_LEAK_T *), _Leaker_Compare_Entries);
+	qsort((void *)table, count, sizeof(_LEAK_T *), _Leaker_Compare_Entries);
 
 	return table;
 }
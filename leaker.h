@@ -11,6 +11,12 @@
 /* 0.1 2011-10-15
 Modified by Joshua Fox 2019-5-30 to ignore delete called on nullptr
 Modified by Joshua Fox 2020-1-30 to fix warnings due to deprecated features
+Modified 2026-10 for thread safety: sharded table, thread-local call sites
+Modified 2026-10 to add sampling mode (LEAKER_SAMPLE_RATE)
+Modified 2026-10 to add call site profiles (LEAKER_PROFILE)
+Modified 2026-10 to add size, lifetime and latency histograms
+Modified 2026-10 to report leaks per call site (LEAKER_REPORT_TOP)
+Modified 2026-10 to record allocations per thread, found from a block header
 */
 
 #ifndef _LEAKER_H
@@ -23,6 +29,10 @@ Modified by Joshua Fox 2020-1-30 to fix warnings due to deprecated features
 
 #ifdef __cplusplus
 #include <memory>
+#include <atomic>
+#include <thread>
+#else
+#include <stdatomic.h>
 #endif
 
 /* Visual C++ fixes */
@@ -33,10 +43,17 @@ Modified by Joshua Fox 2020-1-30 to fix warnings due to deprecated features
 #pragma warning (disable : 4996)
 #endif
 
-#define START_SIZE  128     /* Initial size of memory allocation table */
+#define SERIAL_BLOCK 256    /* Sequence numbers a thread reserves at a time */
+#define SLAB_ENTRIES 256    /* Entries allocated together by a thread's pool */
+#define SITE_ROWS   1024    /* Rows of the call site table */
+#define TALLY_ROWS  64      /* Call sites a thread keeps unadded totals for (power of two) */
+#define TALLY_OPS   64      /* Allocations and frees a tally holds before adding them in */
+#define HIST_SUB_BITS 3     /* Histogram buckets per power of two, as a power of two */
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) << HIST_SUB_BITS)
 
 #define GUARD_SIZE  4       /* Padding at the end of each allocated block */
 #define GUARD_STR   "\014\033\014"  /* magic string to pad allocation */
+#define HEADER_SIZE 16      /* Bytes before each tracked block, keeping malloc's alignment */
 
 typedef struct _LEAK_T
 {
@@ -47,27 +64,168 @@ typedef struct _LEAK_T
     const char *file;       /* name of file where allocation made       */
     const char *func;       /* name of function where allocation made   */
     size_t line;			/* line number where allocation made        */
-    struct _LEAK_T *next;   /* linked list pointer                      */
+    double weight;          /* allocations this one stands for when sampled */
+    size_t count;           /* weight as counted in the site's totals    */
+    size_t bytes;           /* bytes it stands for in the site's totals  */
+    struct _SITE_T *site;   /* call site the allocation is counted for   */
+    unsigned long long time;	/* when allocated (ns, monotonic clock)  */
+    struct _THREAD_T *owner;	/* thread whose pool the entry came from */
+    struct _LEAK_T *next;   /* next unused entry in the pool            */
 } _LEAK_T;
 
+/* placed before each tracked block, so a deallocation finds its entry without a
+ * table; magic tells it apart from blocks leaker did not track */
 typedef struct
 {
-    _LEAK_T **table;
-    size_t rows;			/* number of rows in table                */
-    size_t count;			/* number of entries in table             */
-    size_t bytes;			/* number of bytes currently allocated    */
-    size_t serial;			/* number of next insertion               */
-    
+    _LEAK_T *entry;         /* information about the allocation          */
+    size_t magic;           /* _LEAKER_MAGIC while allocated            */
+} _HEADER_T;
+
+/* a block of entries carved up by a thread's pool */
+typedef struct _SLAB_T
+{
+    struct _SLAB_T *next;   /* previously allocated slab                */
+    _LEAK_T entries[SLAB_ENTRIES];
+} _SLAB_T;
+
+/* thread-local storage and atomics usable from both C and C++ */
+#ifdef __cplusplus
+#define _LEAKER_TLS thread_local
+typedef std::atomic_flag _LEAKER_LOCK_T;
+typedef std::atomic_size_t _LEAKER_COUNTER_T;
+#else
+#define _LEAKER_TLS _Thread_local
+typedef atomic_flag _LEAKER_LOCK_T;
+typedef atomic_size_t _LEAKER_COUNTER_T;
+#endif
+
+#ifdef __cplusplus
+typedef std::atomic<struct _SITE_T *> _LEAKER_SITE_LINK_T;
+typedef std::atomic<_LEAK_T *> _LEAKER_LEAK_LINK_T;
+#else
+typedef _Atomic(struct _SITE_T *) _LEAKER_SITE_LINK_T;
+typedef _Atomic(_LEAK_T *) _LEAKER_LEAK_LINK_T;
+#endif
+
+/* totals for one call site; sites are never removed, so they can be read without
+ * locks. Allocations from code the new macro did not see (e.g. headers included
+ * before leaker.h) are told apart by the address new was called from. Threads
+ * add to the totals TALLY_OPS operations at a time, so peak is exact only for
+ * a site one thread uses; otherwise it is off by up to that many per thread. */
+typedef struct _SITE_T
+{
+    const char *file;       /* name of file where allocations made      */
+    const char *func;       /* name of function where allocations made  */
+    size_t line;            /* line number where allocations made       */
+    void *caller;           /* return address of new, NULL if file known */
+    _LEAKER_COUNTER_T count;	/* allocations made                     */
+    _LEAKER_COUNTER_T bytes;	/* bytes allocated                      */
+    _LEAKER_COUNTER_T live;		/* bytes currently allocated            */
+    _LEAKER_COUNTER_T peak;		/* largest value live has reached       */
+    _LEAKER_COUNTER_T frees;	/* allocations deallocated              */
+    _LEAKER_SITE_LINK_T next;	/* next site in the same row            */
+
+    /* used by the exit report only, with every thread stopped */
+    size_t leaks;           /* allocations still outstanding            */
+    size_t leaked_bytes;    /* bytes still outstanding                  */
+    size_t overflowed;      /* outstanding allocations written past     */
+    double estimated_leaks; /* leaks the sampled ones stand for         */
+    double estimated_bytes; /* bytes the sampled ones stand for         */
+    struct _SITE_T *leaked_next;	/* next site with leaks             */
+} _SITE_T;
+
+/* log-linear histogram: values below 2^HIST_SUB_BITS get a bucket each, every
+ * larger power of two is split into 2^HIST_SUB_BITS buckets, so a value is
+ * known to within 1/2^HIST_SUB_BITS of itself */
+typedef struct
+{
+    size_t buckets[HIST_BUCKETS];
+    size_t count;           /* values recorded                          */
+    size_t sum;             /* sum of the values recorded               */
+    size_t max;             /* largest value recorded                   */
+} _HIST_T;
+
+/* a thread's changes to one site's totals not yet added to the site */
+typedef struct
+{
+    _SITE_T *site;          /* site the changes are for, NULL if unused */
+    size_t count;           /* allocations made                         */
+    size_t bytes;           /* bytes allocated                          */
+    size_t live;            /* change in bytes allocated, modulo 2^n    */
+    size_t high;            /* highest live has been since emptied      */
+    size_t frees;           /* allocations deallocated                  */
+    size_t ops;             /* allocations and frees held               */
+} _TALLY_T;
+
+/* what one thread has recorded. Only the thread itself changes it, without
+ * atomic read-modify-writes; it sets busy while it does, and a report stops
+ * every thread outside that section before reading. Counters are changes
+ * made by the thread, so a block freed by another thread is taken off there,
+ * and only their sum over all threads is meaningful. Entries freed by other
+ * threads come back through returned. When a thread exits its record is
+ * kept, with its entries, for the next new thread to take over. */
+typedef struct _THREAD_T
+{
+    _LEAKER_COUNTER_T busy;	/* nonzero while the thread changes its record */
+    struct _THREAD_T *next;	/* next record, in the order created      */
+    int exited;				/* 1 once the thread has ended             */
+
+    _LEAK_T *spare;			/* entries returned to the pool           */
+    _LEAKER_LEAK_LINK_T returned;	/* entries other threads freed      */
+    _SLAB_T *slabs;			/* every slab allocated, newest first     */
+    size_t carved;			/* entries handed out from the newest slab */
+
+    size_t count;			/* allocations outstanding                */
+    size_t bytes;			/* bytes outstanding                      */
     size_t overflows;		/* number of incorrect deallocations      */
     size_t mismatches;		/* number of mismatched allocs/deallocs   */
     size_t bad_frees;		/* number of bad attempts to free         */
-} _HTABLE_T;
 
-extern _HTABLE_T _leaker;
+    _TALLY_T tallies[TALLY_ROWS];	/* site totals not yet added in     */
+
+    /* sizes of tracked allocations (bytes), how long they lived until
+     * deallocated, and how long the C library's allocation and deallocation
+     * calls took (ns); added up when the report is printed */
+    _HIST_T sizes;
+    _HIST_T lifetimes;
+    _HIST_T alloc_times;
+    _HIST_T free_times;
+} _THREAD_T;
 
-/* report information on current memory allocations */
+/* report information on current memory allocations, per call site totals, and
+ * histograms of allocation size, lifetime and allocation/deallocation latency */
 void _Leaker_Dump(void);
 
+/* sampling mode: track on average one allocation per rate bytes allocated, chosen
+ * by Poisson byte sampling, instead of every allocation. Leaks are then reported
+ * as unbiased estimates per call site, and freeing an unknown pointer is no longer
+ * reported since it may simply not have been sampled. The rate is read from the
+ * LEAKER_SAMPLE_RATE environment variable; 0 (the default) tracks everything. */
+void _Leaker_Set_Sample_Rate(size_t rate);
+size_t _Leaker_Get_Sample_Rate(void);
+
+/* timing: record how long tracked allocations live and how long the C library's
+ * allocation and deallocation calls take, for the histograms in the report. It
+ * reads the clock around every tracked call, so it is off unless turned on here
+ * or by setting the LEAKER_TIMING environment variable to 1. */
+void _Leaker_Set_Timing(int on);
+int _Leaker_Get_Timing(void);
+
+/* write one line per call site in folded-stack format ("site value"), readable by
+ * flamegraph.pl, speedscope and similar tools. metric is "bytes" (allocated, the
+ * default when NULL), "count", "live", "peak" or "frees". Returns 0 if the file
+ * cannot be written or the metric is unknown. At exit the profile is written to
+ * the LEAKER_PROFILE environment variable's path, using LEAKER_PROFILE_METRIC.
+ * Sites outside files that include leaker.h are named from the symbol table,
+ * which needs the program linked with -rdynamic, plus the offset of the call in
+ * the function ("main+0x8b"); addr2line -i gives its file and line. */
+int _Leaker_Write_Profile(const char *path, const char *metric);
+
+/* at exit leaks are reported one line per call site, most bytes first; list
+ * only the given number of sites (0, the default, lists all). The
+ * LEAKER_REPORT_TOP environment variable sets it too. */
+void _Leaker_Set_Report_Top(size_t sites);
+
 /* replacement for standard C allocation and deallocation functions */
 void *_malloc(size_t size, const char *file, const char *func,
                      unsigned long line);
@@ -86,10 +244,11 @@ void _free(void *ptr, const char *file, const char *func,
 
 #ifdef __cplusplus
 
-/* hackish solution to the problem of overriding C++ operator new/delete */
-extern const char *_leaker_file;
-extern const char *_leaker_func;
-extern unsigned long _leaker_line;
+/* hackish solution to the problem of overriding C++ operator new/delete;
+ * thread-local so that concurrent threads do not overwrite each other's call site */
+extern _LEAKER_TLS const char *_leaker_file;
+extern _LEAKER_TLS const char *_leaker_func;
+extern _LEAKER_TLS unsigned long _leaker_line;
 
 #define new (_leaker_file=__FILE__, _leaker_func=__func__, \
     _leaker_line=__LINE__) && 0 ? 0 : new
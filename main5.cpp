@@ -0,0 +1,506 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include "ConcurrentList.h"
+#include "ConcurrentQueue.h"
+#include "RcuList.h"
+#include "leaker.h"
+#include "leaker.cpp"
+using namespace std;
+
+void TestDisjointRegions();
+void TestIndexOperations();
+void TestRcuReaders();
+void TestLinearizable();
+void TestQueueExactlyOnce();
+void TestQueueClose();
+
+int main()
+{
+	int testNum;
+	cin >> testNum;
+	if (testNum == 1)
+		TestDisjointRegions();
+	else if (testNum == 2)
+		TestIndexOperations();
+	else if (testNum == 3)
+		TestRcuReaders();
+	else if (testNum == 4)
+		TestLinearizable();
+	else if (testNum == 5)
+		TestQueueExactlyOnce();
+	else if (testNum == 6)
+		TestQueueClose();
+
+	return 0;
+}
+
+// Each thread owns the region between its own marker Node and the next thread's marker and
+// edits it with InsertBefore/InsertAfter/Remove(Node*). Afterwards every region must hold
+// exactly what its thread expects, in order.
+void TestDisjointRegions()
+{
+	cout << "=====Testing concurrent InsertBefore()/InsertAfter()/Remove() on disjoint regions=====" << endl;
+	const int threads = 8;
+	const int rounds = 20000;
+	ConcurrentList<int> data;
+	vector<ConcurrentList<int>::Node*> markers;
+	for (int t = 0; t < threads; t++)
+		markers.push_back(data.AddTail(-1 - t));
+
+	vector<vector<int>> expected(threads);
+	vector<thread> workers;
+	for (int t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&data, &markers, &expected, t]() {
+			mt19937 rng(t);
+			vector<ConcurrentList<int>::Node*> mine;	// Nodes of this region, in order
+			vector<int>& values = expected[t];
+			for (int i = 0; i < rounds; i++)
+			{
+				int value = t * rounds + i;
+				unsigned int choice = rng() % 4;
+				if (choice == 0 || mine.empty())
+				{
+					mine.insert(mine.begin(), data.InsertAfter(markers[t], value));
+					values.insert(values.begin(), value);
+				}
+				else if (choice == 1)
+				{
+					size_t at = rng() % mine.size();
+					mine.insert(mine.begin() + at + 1, data.InsertAfter(mine[at], value));
+					values.insert(values.begin() + at + 1, value);
+				}
+				else if (choice == 2)
+				{
+					size_t at = rng() % mine.size();
+					mine.insert(mine.begin() + at, data.InsertBefore(mine[at], value));
+					values.insert(values.begin() + at, value);
+				}
+				else
+				{
+					size_t at = rng() % mine.size();
+					data.Remove(mine[at]);
+					mine.erase(mine.begin() + at);
+					values.erase(values.begin() + at);
+				}
+			}
+		});
+	}
+	for (thread& worker : workers)
+		worker.join();
+
+	vector<int> all;
+	for (int t = 0; t < threads; t++)
+	{
+		all.push_back(-1 - t);
+		all.insert(all.end(), expected[t].begin(), expected[t].end());
+	}
+	vector<int> actual;
+	data.Snapshot(actual);
+
+	cout << "Links consistent: " << (data.Validate() ? "yes" : "no") << endl;
+	cout << "Regions match: " << (actual == all ? "yes" : "no") << endl;
+}
+
+// Threads insert unique values and remove at random indices. Afterwards the list must hold
+// exactly the inserted values that no RemoveAt returned.
+void TestIndexOperations()
+{
+	cout << "=====Testing concurrent InsertAt()/RemoveAt()=====" << endl;
+	const int threads = 8;
+	const int rounds = 5000;
+	ConcurrentList<int> data;
+	for (int i = 0; i < 100; i++)
+		data.AddTail(-1 - i);
+
+	vector<vector<int>> inserted(threads);
+	vector<vector<int>> removed(threads);
+	vector<thread> workers;
+	for (int t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&data, &inserted, &removed, t]() {
+			mt19937 rng(100 + t);
+			for (int i = 0; i < rounds; i++)
+			{
+				unsigned int index = rng() % (data.NodeCount() + 1);
+				if (rng() % 2 == 0)
+				{
+					int value = t * rounds + i;
+					if (data.InsertAt(value, index))
+						inserted[t].push_back(value);
+				}
+				else
+				{
+					int value;
+					if (data.RemoveAt(index, &value))
+						removed[t].push_back(value);
+				}
+			}
+		});
+	}
+	for (thread& worker : workers)
+		worker.join();
+
+	vector<int> remaining;
+	for (int i = 0; i < 100; i++)
+		remaining.push_back(-1 - i);
+	for (int t = 0; t < threads; t++)
+		remaining.insert(remaining.end(), inserted[t].begin(), inserted[t].end());
+	vector<int> gone;
+	for (int t = 0; t < threads; t++)
+		gone.insert(gone.end(), removed[t].begin(), removed[t].end());
+	sort(remaining.begin(), remaining.end());
+	sort(gone.begin(), gone.end());
+	vector<int> expected;
+	set_difference(remaining.begin(), remaining.end(), gone.begin(), gone.end(), back_inserter(expected));
+
+	vector<int> actual;
+	data.Snapshot(actual);
+	sort(actual.begin(), actual.end());
+
+	cout << "Links consistent: " << (data.Validate() ? "yes" : "no") << endl;
+	cout << "Contents match: " << (actual == expected ? "yes" : "no") << endl;
+	cout << "Node count matches: " << (data.NodeCount() == expected.size() ? "yes" : "no") << endl;
+}
+
+// Readers walk an RcuList while a writer replaces Nodes in place and inserts and removes extra
+// keys around them. Every traversal must see each of the original keys exactly once.
+void TestRcuReaders()
+{
+	cout << "=====Testing RcuList readers during updates=====" << endl;
+	const int keys = 64;
+	const int readers = 4;
+	RcuList<int> data;
+	for (int i = 0; i < keys; i++)
+		data.AddTail(i);
+
+	atomic<bool> done(false);
+	atomic<int> badTraversals(0);
+	vector<thread> workers;
+	for (int r = 0; r < readers; r++)
+	{
+		workers.emplace_back([&data, &done, &badTraversals]() {
+			while (!done.load())
+			{
+				vector<int> seen(keys, 0);
+				data.ForEach([&seen](const int& value) {
+					if (value < keys)
+						seen[value]++;
+				});
+				if (count(seen.begin(), seen.end(), 1) != keys)
+					badTraversals++;
+			}
+		});
+	}
+
+	mt19937 rng(7);
+	for (int i = 0; i < 20000; i++)
+	{
+		unsigned int index = rng() % data.NodeCount();
+		int value = 0;
+		if (data.GetAt(index, value))
+			data.Replace(index, value);
+		data.InsertAt(keys + i, rng() % (data.NodeCount() + 1));
+		if (i >= 8)
+			data.Remove(keys + i - 8);
+	}
+	done.store(true);
+	for (thread& worker : workers)
+		worker.join();
+	data.Reclaim();
+
+	vector<int> actual;
+	data.ForEach([&actual](const int& value) { actual.push_back(value); });
+	sort(actual.begin(), actual.end());
+	bool complete = actual.size() == (size_t)keys + 8;
+	for (int i = 0; complete && i < keys; i++)
+		complete = actual[i] == i;
+
+	cout << "Traversals consistent: " << (badTraversals.load() == 0 ? "yes" : "no") << endl;
+	cout << "All keys present: " << (complete ? "yes" : "no") << endl;
+}
+
+// one call made by a thread of TestLinearizable, with what it returned
+struct Call
+{
+	int kind;				// 0 InsertAt, 1 RemoveAt, 2 Find
+	int value;				// inserted or searched for, or removed by RemoveAt
+	unsigned int index;		// passed to InsertAt or RemoveAt
+	bool result;			// returned: inserted, removed, found
+	int start;				// clock reading before the call
+	int end;				// clock reading after it returned
+};
+
+// Tries to order the calls not yet in done, starting from the list model, so that each call takes
+// effect at one point between its start and its end, returns what a sequential list would have
+// returned at that point, and the list ends up as final.
+bool Linearize(const vector<Call>& calls, vector<bool>& done, vector<int>& model, const vector<int>& final)
+{
+	int firstEnd = -1;
+	for (size_t i = 0; i < calls.size(); i++)
+	{
+		if (!done[i] && (firstEnd < 0 || calls[i].end < firstEnd))
+			firstEnd = calls[i].end;
+	}
+	if (firstEnd < 0)
+		return model == final;
+
+	// a call can go next only if it started before every pending call ended
+	for (size_t i = 0; i < calls.size(); i++)
+	{
+		const Call& call = calls[i];
+		if (done[i] || call.start > firstEnd)
+			continue;
+		vector<int> before = model;
+		bool matches;
+		if (call.kind == 0)
+		{
+			matches = call.result == (call.index <= model.size());
+			if (matches && call.result)
+				model.insert(model.begin() + call.index, call.value);
+		}
+		else if (call.kind == 1)
+		{
+			matches = call.result == (call.index < model.size());
+			if (matches && call.result)
+			{
+				matches = model[call.index] == call.value;
+				model.erase(model.begin() + call.index);
+			}
+		}
+		else
+			matches = call.result == (find(model.begin(), model.end(), call.value) != model.end());
+		if (matches)
+		{
+			done[i] = true;
+			if (Linearize(calls, done, model, final))
+				return true;
+			done[i] = false;
+		}
+		model = before;
+	}
+	return false;
+}
+
+// Three threads at a time make a few InsertAt/RemoveAt/Find calls on a short list, recording
+// when each call started and returned on a shared clock. Every round's history must be
+// linearizable: explained by some order of the calls, each taking effect between its start and
+// its end, against a sequential list, which must also end up as the ConcurrentList did.
+void TestLinearizable()
+{
+	cout << "=====Testing linearizability of InsertAt()/RemoveAt()/Find() histories=====" << endl;
+	const int threads = 3;
+	const int callsPerThread = 3;
+	const int rounds = 2000;
+	int failures = 0;
+	for (int round = 0; round < rounds; round++)
+	{
+		ConcurrentList<int> data;
+		vector<int> initial;
+		for (int i = 0; i < 4; i++)
+		{
+			data.AddTail(i);
+			initial.push_back(i);
+		}
+
+		atomic<int> clock(0);
+		atomic<int> ready(0);
+		vector<vector<Call>> histories(threads);
+		vector<thread> workers;
+		for (int t = 0; t < threads; t++)
+		{
+			workers.emplace_back([&data, &clock, &ready, &histories, round, t]() {
+				mt19937 rng(round * threads + t);
+				ready++;
+				while (ready.load() < threads)
+					this_thread::yield();
+				for (int i = 0; i < callsPerThread; i++)
+				{
+					Call call = { (int)(rng() % 3), 0, (unsigned int)(rng() % 6), false, 0, 0 };
+					if (call.kind == 0)
+						call.value = 100 + t * callsPerThread + i;
+					else if (call.kind == 2)
+						call.value = rng() % 2 == 0 ? (int)(rng() % 4) : 100 + (int)(rng() % (threads * callsPerThread));
+					call.start = clock++;
+					if (call.kind == 0)
+						call.result = data.InsertAt(call.value, call.index);
+					else if (call.kind == 1)
+						call.result = data.RemoveAt(call.index, &call.value);
+					else
+						call.result = data.Find(call.value) != nullptr;
+					call.end = clock++;
+					histories[t].push_back(call);
+				}
+			});
+		}
+		for (thread& worker : workers)
+			worker.join();
+
+		vector<Call> calls;
+		for (int t = 0; t < threads; t++)
+			calls.insert(calls.end(), histories[t].begin(), histories[t].end());
+		vector<bool> done(calls.size(), false);
+		vector<int> model = initial;
+		vector<int> actual;
+		data.Snapshot(actual);
+		if (!data.Validate() || !Linearize(calls, done, model, actual))
+			failures++;
+	}
+	cout << "Rounds: " << rounds << endl;
+	cout << "Histories linearizable: " << (failures == 0 ? "yes" : "no") << endl;
+}
+
+// Producers push unique values into a queue far smaller than what passes through it, one at a
+// time and in arrays, so that producers and consumers both block; consumers pop one at a time and
+// in arrays until Close. Every value pushed must be popped exactly once, and each consumer must
+// see any one producer's values in the order they were pushed.
+void TestQueueExactlyOnce()
+{
+	cout << "=====Testing ConcurrentQueue with many producers and consumers=====" << endl;
+	const int producers = 4;
+	const int consumers = 4;
+	const int rounds = 20000;
+	ConcurrentQueue<int> queue(8);
+
+	vector<thread> producing;
+	for (int p = 0; p < producers; p++)
+	{
+		producing.emplace_back([&queue, p]() {
+			int batch[5];
+			for (int i = 0; i < rounds; )
+			{
+				if (i % 10 == 0 && rounds - i >= 5)
+				{
+					for (int b = 0; b < 5; b++)
+						batch[b] = p * rounds + i + b;
+					queue.AddNodesTail(batch, 5);
+					i += 5;
+				}
+				else
+				{
+					queue.AddTail(p * rounds + i);
+					i++;
+				}
+			}
+		});
+	}
+
+	vector<vector<int>> received(consumers);
+	vector<thread> consuming;
+	for (int c = 0; c < consumers; c++)
+	{
+		consuming.emplace_back([&queue, &received, c]() {
+			int batch[3];
+			for (unsigned int round = 0; ; round++)
+			{
+				if (round % 2 == 0)
+				{
+					int value;
+					if (!queue.RemoveHead(value))
+						break;
+					received[c].push_back(value);
+				}
+				else
+				{
+					unsigned int count = queue.RemoveNodesHead(batch, 3);
+					if (count == 0)
+						break;
+					received[c].insert(received[c].end(), batch, batch + count);
+				}
+			}
+		});
+	}
+
+	for (thread& producer : producing)
+		producer.join();
+	queue.Close();
+	for (thread& consumer : consuming)
+		consumer.join();
+
+	vector<int> times(producers * rounds, 0);
+	bool ordered = true;
+	size_t total = 0;
+	for (int c = 0; c < consumers; c++)
+	{
+		vector<int> last(producers, -1);
+		for (int value : received[c])
+		{
+			times[value]++;
+			if (value % rounds <= last[value / rounds])
+				ordered = false;
+			last[value / rounds] = value % rounds;
+		}
+		total += received[c].size();
+	}
+	cout << "Values popped: " << total << " of " << producers * rounds << endl;
+	cout << "Every value popped exactly once: "
+		<< (all_of(times.begin(), times.end(), [](int n) { return n == 1; }) ? "yes" : "no") << endl;
+	cout << "Each producer's order kept: " << (ordered ? "yes" : "no") << endl;
+	cout << "Empty after Close: " << (queue.NodeCount() == 0 ? "yes" : "no") << endl;
+}
+
+// Consumers block on an empty queue and a producer on a full one; Close must wake all of them,
+// the consumers returning false and the producer's element refused. Elements queued before Close
+// are still handed out, and only then does RemoveHead report the end.
+void TestQueueClose()
+{
+	cout << "=====Testing ConcurrentQueue Close() with blocked threads=====" << endl;
+	const int consumers = 3;
+	ConcurrentQueue<int> empty(4);
+	atomic<int> started(0);
+	atomic<int> woken(0);
+	vector<thread> consuming;
+	for (int c = 0; c < consumers; c++)
+	{
+		consuming.emplace_back([&empty, &started, &woken]() {
+			int value;
+			started++;
+			if (!empty.RemoveHead(value))
+				woken++;
+		});
+	}
+
+	ConcurrentQueue<int> full(2);
+	for (unsigned int i = 0; i < full.Capacity(); i++)
+		full.AddTail((int)i);
+	atomic<bool> producerStarted(false);
+	atomic<int> refused(0);
+	thread producer([&full, &producerStarted, &refused]() {
+		producerStarted = true;
+		if (!full.AddTail(99))
+			refused++;
+	});
+
+	while (started < consumers || !producerStarted)
+		this_thread::yield();
+	this_thread::sleep_for(chrono::milliseconds(100));
+	cout << "Woken before Close: " << woken + refused << endl;
+	empty.Close();
+	full.Close();
+
+	// a thread Close failed to wake would block forever, so give up waiting after a while
+	auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+	while ((woken < consumers || refused < 1) && chrono::steady_clock::now() < deadline)
+		this_thread::sleep_for(chrono::milliseconds(1));
+	cout << "Consumers woken by Close: " << woken << " of " << consumers << endl;
+	cout << "Producer refused after Close: " << (refused == 1 ? "yes" : "no") << endl;
+	if (woken < consumers || refused < 1)
+		_Exit(1);
+	for (thread& consumer : consuming)
+		consumer.join();
+	producer.join();
+
+	int value;
+	int drained = 0;
+	while (full.RemoveHead(value))
+		drained++;
+	cout << "Drained after Close: " << drained << " of " << full.Capacity()
+		<< ", AddTail after Close: " << full.AddTail(1) << endl;
+}
@@ -0,0 +1,168 @@
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Channel.h"
+#include "leaker.h"
+#include "leaker.cpp"
+using namespace std;
+
+// Channel needs C++20: g++ -std=c++20 main6.cpp
+
+void TestHandOff();
+void TestBatchWake();
+void TestClose();
+
+int main()
+{
+	int testNum;
+	cin >> testNum;
+	if (testNum == 1)
+		TestHandOff();
+	else if (testNum == 2)
+		TestBatchWake();
+	else if (testNum == 3)
+		TestClose();
+
+	return 0;
+}
+
+// Takes count elements one co_await at a time and records them.
+Task Consume(Channel<int>& channel, vector<int>& received, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		optional<int> value = co_await channel.PopHead();
+		if (value)
+			received.push_back(*value);
+	}
+}
+
+// Adds count elements, letting the consumers run after each one.
+Task Produce(LocalExecutor& executor, Channel<int>& channel, int first, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		channel.AddTail(first + i);
+		co_await executor.Yield();
+	}
+}
+
+// Three consumers wait before any data exists, and a producer then adds one element at a time.
+// Waiters are served in the order they arrived, so the consumers take turns, and every element
+// is received exactly once in the order it was added.
+void TestHandOff()
+{
+	cout << "=====Testing co_await PopHead() with AddTail()=====" << endl;
+	LocalExecutor executor;
+	Channel<int> channel(executor);
+	vector<int> received[3];
+	for (int c = 0; c < 3; c++)
+		executor.Spawn(Consume(channel, received[c], 4));
+	executor.Run();
+	cout << "Consumers waiting: " << channel.Waiting() << endl;
+
+	executor.Spawn(Produce(executor, channel, 0, 12));
+	executor.Run();
+	for (int c = 0; c < 3; c++)
+	{
+		cout << "Consumer " << c << ":";
+		for (int value : received[c])
+			cout << " " << value;
+		cout << endl;
+	}
+	cout << "Consumers waiting: " << channel.Waiting() << endl;
+	cout << "Elements left: " << channel.NodeCount() << endl;
+}
+
+// Takes up to most elements per co_await until it has count of them.
+Task ConsumeBatches(Channel<int>& channel, vector<int>& received, int count, unsigned int most, int& resumes)
+{
+	while ((int)received.size() < count)
+	{
+		unsigned int taken = co_await channel.PopNodesHead(received, most);
+		resumes++;
+		if (taken == 0)
+			break;
+	}
+}
+
+// One AddNodesTail call wakes every waiter it can feed, and the executor then resumes each of
+// them once. A batch consumer takes many elements per resumption.
+void TestBatchWake()
+{
+	cout << "=====Testing AddNodesTail() waking several waiters=====" << endl;
+	LocalExecutor executor;
+	Channel<int> channel(executor);
+	vector<int> received[4];
+	for (int c = 0; c < 4; c++)
+		executor.Spawn(Consume(channel, received[c], 1));
+	executor.Run();
+
+	int data[6] = { 10, 11, 12, 13, 14, 15 };
+	channel.AddNodesTail(data, 6);
+	cout << "Consumers woken by one call: " << executor.Pending() << endl;
+	cout << "Elements left for later: " << channel.NodeCount() << endl;
+	executor.Run();
+	for (int c = 0; c < 4; c++)
+		cout << "Consumer " << c << " got: " << (received[c].empty() ? -1 : received[c][0]) << endl;
+
+	vector<int> batch;
+	int resumes = 0;
+	executor.Spawn(ConsumeBatches(channel, batch, 66, 32, resumes));
+	executor.Run();
+	int more[64];
+	for (int i = 0; i < 64; i++)
+		more[i] = 100 + i;
+	channel.AddNodesTail(more, 64);
+	executor.Run();
+	bool inOrder = batch.size() == 66 && batch[0] == 14 && batch[1] == 15;
+	for (int i = 2; inOrder && i < 66; i++)
+		inOrder = batch[i] == 98 + i;
+	cout << "Batch consumer got all 66 in order: " << (inOrder ? "yes" : "no") << endl;
+	cout << "Batch consumer resumptions: " << resumes << endl;
+}
+
+// Close wakes waiting consumers with nothing, refuses new data, and still lets consumers drain
+// what was added before.
+void TestClose()
+{
+	cout << "=====Testing Close()=====" << endl;
+	LocalExecutor executor;
+	Channel<string> channel(executor);
+	int finished = 0;
+	vector<string> received;
+	auto consume = [&]() -> Task {
+		while (true)
+		{
+			optional<string> value = co_await channel.PopHead();
+			if (!value)
+				break;
+			received.push_back(*value);
+		}
+		finished++;
+	};
+	executor.Spawn(consume());
+	executor.Spawn(consume());
+	executor.Run();
+
+	channel.AddTail("first");
+	channel.Close();
+	cout << "AddTail after Close: " << (channel.AddTail("late") ? "accepted" : "refused") << endl;
+	executor.Run();
+	cout << "Received: " << received.size() << " (" << (received.empty() ? "" : received[0]) << ")" << endl;
+	cout << "Consumers finished: " << finished << endl;
+
+	Channel<string> leftovers(executor);
+	leftovers.AddTail("a");
+	leftovers.AddTail("b");
+	leftovers.Close();
+	string drained;
+	auto drain = [&]() -> Task {
+		while (optional<string> value = co_await leftovers.PopHead())
+			drained += *value;
+	};
+	executor.Spawn(drain());
+	executor.Run();
+	cout << "Drained after Close: " << drained << endl;
+}
@@ -0,0 +1,640 @@
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "FixedLinkedList.h"
+#include "Ingest.h"
+#include "RingBuffer.h"
+#include "Serialize.h"
+#include "StringList.h"
+#include "Views.h"
+#include "leaker.h"
+#include "leaker.cpp"
+using namespace std;
+
+void TestSerializeFiles();
+void TestFixedCapacity();
+void TestBatchEdits();
+void TestViewChains();
+void TestRingBuffer();
+void TestIngestPipe();
+void TestStringList();
+
+int main()
+{
+	int testNum;
+	cin >> testNum;
+	if (testNum == 1)
+		TestSerializeFiles();
+	else if (testNum == 2)
+		TestFixedCapacity();
+	else if (testNum == 3)
+		TestBatchEdits();
+	else if (testNum == 4)
+		TestViewChains();
+	else if (testNum == 5)
+		TestRingBuffer();
+	else if (testNum == 6)
+		TestIngestPipe();
+	else if (testNum == 7)
+		TestStringList();
+
+	return 0;
+}
+
+// Returns the bytes of the file at path.
+string ReadFile(const string& path)
+{
+	ifstream in(path, ios::binary);
+	ostringstream bytes;
+	bytes << in.rdbuf();
+	return bytes.str();
+}
+
+// A stream buffer over bytes in memory that cannot seek, as a pipe or socket would be.
+class PipeBuffer : public streambuf
+{
+public:
+	explicit PipeBuffer(string& bytes)
+	{
+		setg(&bytes[0], &bytes[0], &bytes[0] + bytes.size());
+	}
+};
+
+// Replaces the file at path with bytes.
+void WriteFile(const string& path, const string& bytes)
+{
+	ofstream out(path, ios::binary | ios::trunc);
+	out.write(bytes.data(), (streamsize)bytes.size());
+}
+
+// Saves a list of ints and a list of strings to files and loads them back, then loads copies
+// that are cut short or damaged. Every bad file must be refused, leaving the list it was loaded
+// into empty rather than partly filled.
+void TestSerializeFiles()
+{
+	cout << "=====Testing Serialize()/Deserialize() through files=====" << endl;
+	LinkedList<int> numbers;
+	for (int i = 0; i < 10; i++)
+		numbers.AddTail(i * i);
+	LinkedList<string> words;
+	words.AddTail("alpha");
+	words.AddTail("");
+	words.AddTail("gamma delta");
+	words.AddTail(string(3000, 'x'));
+
+	cout << "Saved numbers: " << Serialize(numbers, "main7_numbers.bin") << endl;
+	cout << "Saved words: " << Serialize(words, "main7_words.bin") << endl;
+
+	LinkedList<int> loadedNumbers;
+	loadedNumbers.AddTail(-1);
+	cout << "Loaded numbers: " << Deserialize(loadedNumbers, "main7_numbers.bin")
+		<< ", equal: " << (loadedNumbers == numbers) << endl;
+	LinkedList<string> loadedWords;
+	cout << "Loaded words: " << Deserialize(loadedWords, "main7_words.bin")
+		<< ", equal: " << (loadedWords == words)
+		<< ", last length: " << loadedWords.Tail()->data.size() << endl;
+
+	MappedList<int> mapped;
+	cout << "Mapped numbers: " << mapped.Open("main7_numbers.bin")
+		<< ", count: " << mapped.NodeCount() << ", [7]: " << mapped[7] << endl;
+	mapped.Close();
+
+	// the last element cut in half
+	string numberBytes = ReadFile("main7_numbers.bin");
+	WriteFile("main7_bad.bin", numberBytes.substr(0, numberBytes.size() - sizeof(int) / 2));
+	cout << "Truncated numbers: " << Deserialize(loadedNumbers, "main7_bad.bin")
+		<< ", count: " << loadedNumbers.NodeCount() << endl;
+	cout << "Mapped truncated numbers: " << mapped.Open("main7_bad.bin") << endl;
+
+	// the header only, without any elements
+	WriteFile("main7_bad.bin", numberBytes.substr(0, sizeof(SerialHeader)));
+	loadedNumbers.AddTail(-1);
+	cout << "Header only: " << Deserialize(loadedNumbers, "main7_bad.bin")
+		<< ", count: " << loadedNumbers.NodeCount() << endl;
+
+	// ints read as a list of doubles
+	LinkedList<double> doubles;
+	cout << "Numbers as doubles: " << Deserialize(doubles, "main7_numbers.bin")
+		<< ", count: " << doubles.NodeCount() << endl;
+
+	// a damaged magic number
+	string damaged = numberBytes;
+	damaged[0] = 'X';
+	WriteFile("main7_bad.bin", damaged);
+	cout << "Bad magic: " << Deserialize(loadedNumbers, "main7_bad.bin")
+		<< ", count: " << loadedNumbers.NodeCount() << endl;
+
+	// the long last record cut short
+	string wordBytes = ReadFile("main7_words.bin");
+	WriteFile("main7_bad.bin", wordBytes.substr(0, wordBytes.size() - 1000));
+	loadedWords.AddTail("stale");
+	cout << "Truncated words: " << Deserialize(loadedWords, "main7_bad.bin")
+		<< ", count: " << loadedWords.NodeCount() << endl;
+
+	// the first record claiming to be far longer than the file
+	uint64_t huge = (uint64_t)1 << 60;
+	damaged = wordBytes;
+	memcpy(&damaged[(size_t)MakeSerialHeader<string>(0).dataOffset], &huge, sizeof(huge));
+	WriteFile("main7_bad.bin", damaged);
+	cout << "Huge record length: " << Deserialize(loadedWords, "main7_bad.bin")
+		<< ", count: " << loadedWords.NodeCount() << endl;
+
+	// the same, read from a stream that cannot tell how much is left
+	PipeBuffer pipe(damaged);
+	istream damagedStream(&pipe);
+	cout << "Huge record length from a pipe: " << Deserialize(loadedWords, damagedStream)
+		<< ", count: " << loadedWords.NodeCount() << endl;
+
+	cout << "Missing file: " << Deserialize(loadedWords, "main7_missing.bin") << endl;
+
+	remove("main7_numbers.bin");
+	remove("main7_words.bin");
+	remove("main7_bad.bin");
+}
+
+// Prints a FixedLinkedList on one line, head first.
+template<typename T, unsigned int N>
+void PrintLine(const FixedLinkedList<T, N>& list)
+{
+	for (auto node = list.Head(); node != nullptr; node = list.Next(node))
+		cout << " " << node->data;
+	cout << endl;
+}
+
+// Runs add, which should throw length_error, and says whether it did.
+template<typename Add>
+void ExpectFull(const char* name, Add add)
+{
+	try
+	{
+		add();
+		cout << name << " did not throw" << endl;
+	}
+	catch (const length_error&)
+	{
+		cout << name << " threw length_error" << endl;
+	}
+}
+
+// Builds a list at compile time that reuses a released Node: 1 2 3, then 2 3 4.
+constexpr int BuildAtCompileTime()
+{
+	FixedLinkedList<int, 3> list;
+	list.AddTail(1);
+	list.AddTail(2);
+	list.AddTail(3);
+	list.RemoveHead();
+	list.AddTail(4);
+	return list[0] * 100 + list[1] * 10 + list[2];
+}
+static_assert(BuildAtCompileTime() == 234, "FixedLinkedList should work in constant expressions");
+
+// Fills a list to capacity: every way of adding must then throw length_error and leave the list
+// as it was. Released Nodes must be reused, most recently released first, before the list runs
+// out again, and Clear must make the whole capacity available.
+void TestFixedCapacity()
+{
+	cout << "=====Testing a full FixedLinkedList and reuse of released Nodes=====" << endl;
+	FixedLinkedList<int, 4> list;
+	cout << "Capacity: " << list.Capacity() << ", index bytes: "
+		<< sizeof(FixedLinkedList<int, 4>::Index) << endl;
+	for (int i = 1; i <= 4; i++)
+		list.AddTail(i * 10);
+	cout << "Full: " << list.Full() << ", contents:";
+	PrintLine(list);
+
+	int more[] = { 50, 60, 70 };
+	ExpectFull("AddTail", [&]() { list.AddTail(50); });
+	ExpectFull("AddHead", [&]() { list.AddHead(50); });
+	ExpectFull("InsertAt", [&]() { list.InsertAt(50, 2); });
+	ExpectFull("InsertAfter", [&]() { list.InsertAfter(list.Head(), 50); });
+	ExpectFull("AddNodesTail", [&]() { list.AddNodesTail(more, 1); });
+	cout << "After failed adds, count: " << list.NodeCount() << ", contents:";
+	PrintLine(list);
+
+	// two Nodes released, 20's and then 40's; the next adds take 40's and then 20's
+	const FixedLinkedList<int, 4>::Node* second = list.GetNode(1);
+	const FixedLinkedList<int, 4>::Node* fourth = list.GetNode(3);
+	list.Remove(20);
+	list.RemoveTail();
+	cout << "After removing 20 and the tail, full: " << list.Full() << ", contents:";
+	PrintLine(list);
+	ExpectFull("AddNodesHead of 3", [&]() { list.AddNodesHead(more, 3); });
+	list.AddHead(5);
+	list.InsertAt(25, 2);
+	cout << "Added 5 in 40's Node: " << (list.Find(5) == fourth)
+		<< ", 25 in 20's Node: " << (list.Find(25) == second) << endl;
+	cout << "Full: " << list.Full() << ", contents:";
+	PrintLine(list);
+	ExpectFull("AddTail", [&]() { list.AddTail(70); });
+
+	list.Clear();
+	list.AddNodesTail(more, 2);
+	list.AddNodesHead(more, 2);
+	cout << "After Clear and adding 4, full: " << list.Full() << ", contents:";
+	PrintLine(list);
+	cout << "Built at compile time: " << BuildAtCompileTime() << endl;
+}
+
+// Prints a LinkedList on one line, head first, then again tail first.
+template<typename T>
+void PrintBothWays(const LinkedList<T>& list)
+{
+	for (auto node = list.Head(); node != nullptr; node = node->next)
+		cout << " " << node->data;
+	cout << " |";
+	for (auto node = list.Tail(); node != nullptr; node = node->prev)
+		cout << " " << node->data;
+	cout << endl;
+}
+
+// A value whose copy throws once copiesLeft reaches 0 (never while it is negative).
+struct Fussy
+{
+	static int copiesLeft;
+	int value;
+
+	Fussy(int v) : value(v)
+	{
+	}
+
+	Fussy(const Fussy& other) : value(other.value)
+	{
+		if (copiesLeft == 0)
+			throw runtime_error("copy refused");
+		if (copiesLeft > 0)
+			copiesLeft--;
+	}
+
+	Fussy& operator=(const Fussy& other) = default;
+
+	bool operator==(const Fussy& other) const
+	{
+		return value == other.value;
+	}
+};
+int Fussy::copiesLeft = -1;
+
+ostream& operator<<(ostream& out, const Fussy& fussy)
+{
+	return out << fussy.value;
+}
+
+// Records insertions and removals at the same positions, a second removal of one Node and edits
+// at both ends, then applies them in one go. Positions refer to the list as recorded, so the
+// result is known in advance. Then a Batch is left stale by shrinking the list, and one whose
+// Nodes fail to copy: both Apply calls must throw, leave the list as it was and keep the edits.
+void TestBatchEdits()
+{
+	cout << "=====Testing Batch with mixed edits at the same positions=====" << endl;
+	LinkedList<int> list;
+	for (int i = 0; i < 6; i++)
+		list.AddTail(i * 10);
+	cout << "Before:";
+	PrintBothWays(list);
+
+	LinkedList<int>::Batch batch(list);
+	batch.InsertAt(100, 2);
+	batch.RemoveAt(2);
+	batch.InsertAt(101, 2);
+	batch.RemoveAt(2);
+	batch.RemoveAt(5);
+	batch.AddTail(200);
+	batch.InsertAt(99, 0);
+	batch.RemoveAt(0);
+	cout << "Recorded: " << batch.EditCount() << ", RemoveAt(6) accepted: " << batch.RemoveAt(6) << endl;
+	batch.Apply();
+	cout << "After Apply, count " << list.NodeCount() << ", edits left " << batch.EditCount() << ":";
+	PrintBothWays(list);
+
+	// the tail recorded for removal is gone by the time the edits are applied
+	batch.RemoveAt(6);
+	batch.AddTail(300);
+	list.RemoveTail();
+	list.RemoveTail();
+	try
+	{
+		batch.Apply();
+		cout << "Stale Apply did not throw" << endl;
+	}
+	catch (const out_of_range&)
+	{
+		cout << "Stale Apply threw out_of_range" << endl;
+	}
+	cout << "Count " << list.NodeCount() << ", edits kept " << batch.EditCount() << ":";
+	PrintBothWays(list);
+	list.AddTail(1);
+	list.AddTail(2);
+	batch.Apply();
+	cout << "After restoring the size and applying:";
+	PrintBothWays(list);
+
+	// the second new Node fails to copy its data
+	LinkedList<Fussy> fussies;
+	fussies.AddTail(Fussy(1));
+	fussies.AddTail(Fussy(2));
+	LinkedList<Fussy>::Batch fussyBatch(fussies);
+	fussyBatch.InsertAt(Fussy(10), 1);
+	fussyBatch.RemoveAt(0);
+	fussyBatch.AddTail(Fussy(20));
+	fussyBatch.InsertAt(Fussy(11), 1);
+	Fussy::copiesLeft = 1;
+	try
+	{
+		fussyBatch.Apply();
+		cout << "Apply did not throw" << endl;
+	}
+	catch (const runtime_error&)
+	{
+		cout << "Apply threw when a copy failed" << endl;
+	}
+	Fussy::copiesLeft = -1;
+	cout << "Count " << fussies.NodeCount() << ", edits kept " << fussyBatch.EditCount() << ":";
+	PrintBothWays(fussies);
+	fussyBatch.Apply();
+	cout << "Applied again:";
+	PrintBothWays(fussies);
+}
+
+// Prints the elements of a view on one line.
+template<typename View>
+void PrintView(const char* name, const View& view)
+{
+	cout << name << ":";
+	for (auto&& value : view)
+		cout << " " << value;
+	cout << endl;
+}
+
+// Chains stages of the same kind and checks, from the type of the view built, that they fused
+// into one stage, and from its elements that the fused stage does what the chain would. Then
+// reverses Filters whose first and last elements fail the test, so the reversed walk has to
+// skip them from the end, including through a Transform and a Drop.
+void TestViewChains()
+{
+	cout << "=====Testing fusion of chained views and Reverse() over Filter()=====" << endl;
+	LinkedList<int> list;
+	for (int i = 0; i <= 10; i++)
+		list.AddTail(i);
+	typedef RefView<LinkedList<int>> Whole;
+
+	auto isEven = [](int x) { return x % 2 == 0; };
+	auto isBig = [](int x) { return x > 3; };
+	auto twoFilters = list | Filter(isEven) | Filter(isBig);
+	cout << "Filter | Filter fused: "
+		<< is_same<decltype(twoFilters), FilterView<Whole, BothOf<decltype(isEven), decltype(isBig)>>>::value << endl;
+	PrintView("Even and > 3", twoFilters);
+
+	auto triple = [](int x) { return x * 3; };
+	auto plusOne = [](int x) { return x + 1; };
+	auto twoTransforms = list | Transform(triple) | Transform(plusOne);
+	cout << "Transform | Transform fused: "
+		<< is_same<decltype(twoTransforms), TransformView<Whole, Composed<decltype(triple), decltype(plusOne)>>>::value << endl;
+	PrintView("Times 3 plus 1", twoTransforms | Take(4));
+
+	auto twoTakes = list | Take(5) | Take(3);
+	auto twoDrops = list | Drop(2) | Drop(5);
+	auto hugeDrops = list | Drop(UINT_MAX - 1) | Drop(5);
+	cout << "Take | Take fused: " << is_same<decltype(twoTakes), TakeView<Whole>>::value
+		<< ", most " << twoTakes.Most() << ", count " << twoTakes.Count() << endl;
+	cout << "Drop | Drop fused: " << is_same<decltype(twoDrops), DropView<Whole>>::value
+		<< ", skipped " << twoDrops.Skipped() << ", count " << twoDrops.Count() << endl;
+	cout << "Drop near UINT_MAX | Drop saturates: " << (hugeDrops.Skipped() == UINT_MAX)
+		<< ", empty " << hugeDrops.Empty() << endl;
+	auto twoReverses = list | Reverse() | Reverse();
+	cout << "Reverse | Reverse is the list: " << is_same<decltype(twoReverses), Whole>::value << endl;
+
+	// 0 and 10 fail the test, so both ends of the source are skipped
+	auto isOdd = [](int x) { return x % 2 != 0; };
+	PrintView("Odd reversed", list | Filter(isOdd) | Reverse());
+	PrintView("Multiples of 3 above 3, reversed", list | Filter(isBig) | Filter([](int x) { return x % 3 == 0; }) | Reverse());
+	PrintView("Odd squared, reversed", list | Filter(isOdd) | Transform([](int x) { return x * x; }) | Reverse());
+	PrintView("Odd after the first 2, reversed", list | Filter(isOdd) | Drop(2) | Reverse());
+	PrintView("Odd reversed twice", list | Filter(isOdd) | Reverse() | Reverse());
+	cout << "Reverse of a Filter nothing passes is empty: "
+		<< (list | Filter([](int x) { return x > 100; }) | Reverse()).Empty() << endl;
+
+	vector<int> collected;
+	(list | Filter(isEven) | Reverse() | Take(3)).ToVector(collected);
+	cout << "First 3 even from the end:";
+	for (int value : collected)
+		cout << " " << value;
+	cout << endl;
+}
+
+// Prints a Ring list on one line, head first, with its capacity.
+template<typename T>
+void PrintRing(const char* name, const LinkedList<T, Ring>& list)
+{
+	cout << name << " (capacity " << list.Capacity() << "):";
+	for (unsigned int i = 0; i < list.NodeCount(); i++)
+		cout << " " << list[i];
+	cout << endl;
+}
+
+// A value whose move assignment throws while failMoves is set, as a Ring moves Nodes when it grows.
+struct Brittle
+{
+	static bool failMoves;
+	int value = 0;
+
+	Brittle() = default;
+
+	Brittle(int v) : value(v)
+	{
+	}
+
+	Brittle(const Brittle&) = default;
+	Brittle& operator=(const Brittle&) = default;
+
+	Brittle& operator=(Brittle&& other)
+	{
+		if (failMoves)
+			throw runtime_error("move refused");
+		value = other.value;
+		return *this;
+	}
+};
+bool Brittle::failMoves = false;
+
+// Wraps a Ring list around the end of its buffer, then grows it from both ends while wrapped and
+// shrinks it from both ends: the order must survive every growth. Sizes past the largest
+// capacity must throw length_error before anything is allocated, and a move that throws while
+// growing must leave the list as it was (leaker reports the new buffer if it is leaked).
+void TestRingBuffer()
+{
+	cout << "=====Testing LinkedList<T, Ring> wraparound and growth=====" << endl;
+	LinkedList<int, Ring> ring;
+	for (int i = 0; i < 10; i++)
+		ring.AddTail(i);
+	for (int i = 0; i < 6; i++)
+		ring.RemoveHead();
+	for (int i = 10; i < 22; i++)
+		ring.AddTail(i);
+	PrintRing("Wrapped and full", ring);
+
+	ring.AddTail(22);
+	PrintRing("AddTail past full", ring);
+	for (int i = 0; i < 3; i++)
+		ring.RemoveTail();
+	for (int i = 0; i < 10; i++)
+		ring.RemoveHead();
+	for (int i = 1; i <= 29; i++)
+		ring.AddHead(-i);
+	PrintRing("AddHead past full while wrapped", ring);
+	while (ring.NodeCount() > 4)
+	{
+		ring.RemoveTail();
+		ring.RemoveHead();
+	}
+	PrintRing("Shrunk from both ends", ring);
+
+	LinkedList<int, Ring> copy(ring);
+	cout << "Copy equal: " << (copy == ring);
+	copy.AddHead(100);
+	LinkedList<int, Ring> assigned;
+	assigned = copy;
+	cout << ", after AddHead: " << (copy == ring) << ", assigned equal to copy: " << (assigned == copy) << endl;
+
+	int values[] = { 1, 2, 3 };
+	try
+	{
+		ring.Reserve(0x80000001u);
+		cout << "Reserve past the largest capacity did not throw" << endl;
+	}
+	catch (const length_error&)
+	{
+		cout << "Reserve past the largest capacity threw length_error" << endl;
+	}
+	try
+	{
+		ring.AddNodesTail(values, UINT_MAX);
+		cout << "AddNodesTail of UINT_MAX did not throw" << endl;
+	}
+	catch (const length_error&)
+	{
+		cout << "AddNodesTail of UINT_MAX threw length_error" << endl;
+	}
+	PrintRing("After the refused sizes", ring);
+
+	LinkedList<Brittle, Ring> brittle;
+	for (int i = 0; i < 16; i++)
+		brittle.AddTail(Brittle(i));
+	Brittle::failMoves = true;
+	try
+	{
+		brittle.AddTail(Brittle(16));
+		cout << "Growth did not throw" << endl;
+	}
+	catch (const runtime_error&)
+	{
+		cout << "Growth threw when a move failed" << endl;
+	}
+	Brittle::failMoves = false;
+	cout << "Count " << brittle.NodeCount() << ", capacity " << brittle.Capacity()
+		<< ", tail " << brittle.Tail()->data.value << endl;
+}
+
+// Reads tokens from a pipe, which returns far less than a block per read, with one token three
+// times longer than a read block between two short ones. The long token must come through whole
+// and be moved only while its space doubles, not once per read, so the arena (1 MB blocks) ends
+// up with a few blocks rather than one for every read.
+void TestIngestPipe()
+{
+	cout << "=====Testing IngestTokens() from a pipe with a token longer than a block=====" << endl;
+	int ends[2];
+	if (pipe(ends) != 0)
+	{
+		cout << "pipe() failed" << endl;
+		return;
+	}
+	string longToken(3 * ingestBlockBytes, 'x');
+	longToken[0] = 'a';
+	longToken[longToken.size() - 1] = 'z';
+	string input = "first\n" + longToken + "\nlast";
+	thread writer([&input, &ends]()
+	{
+		size_t sent = 0;
+		while (sent < input.size())
+		{
+			ssize_t wrote = write(ends[1], input.data() + sent, input.size() - sent);
+			if (wrote <= 0)
+				break;
+			sent += (size_t)wrote;
+		}
+		close(ends[1]);
+	});
+
+	LinkedList<string_view> list;
+	StringArena arena(ingestBlockBytes);
+	bool complete = IngestTokens(ends[0], list, arena);
+	writer.join();
+	close(ends[0]);
+
+	cout << "Complete: " << complete << ", tokens: " << list.NodeCount() << endl;
+	cout << "First: " << list[0] << ", last: " << list[2] << endl;
+	cout << "Long token intact: " << (list[1] == longToken) << endl;
+	cout << "Arena blocks: " << arena.Blocks() << ", bytes: " << arena.Bytes() << endl;
+}
+
+// Prints a LinkedList<string, Strings> on one line, head first, with its arena bytes.
+void PrintStrings(const char* name, const LinkedList<string, Strings>& list)
+{
+	cout << name << ":";
+	for (const LinkedList<string, Strings>::Node* node = list.Head(); node != nullptr; node = node->next)
+		cout << " [" << node->Data() << "]";
+	cout << " (" << list.NodeCount() << " nodes, " << list.Bytes() << " bytes, "
+		<< list.RemovedBytes() << " removed)" << endl;
+}
+
+// Edits a LinkedList<string, Strings> from both ends and the middle, including removing by a view
+// of the list's own head, which must still read correctly while equal Nodes are removed. Compact
+// must give back the bytes of removed Nodes, copies must be equal and independent, and emptying
+// the list must start its arena over.
+void TestStringList()
+{
+	cout << "=====Testing LinkedList<string, Strings> edits, Compact and copies=====" << endl;
+	LinkedList<string, Strings> list;
+	list.AddTail("beta");
+	list.AddTail("gamma");
+	list.AddHead("alpha");
+	list.AddTail("a string longer than the small-string buffer of std::string");
+	list.InsertAt("", 1);
+	list.InsertAt("beta", 4);
+	PrintStrings("Added", list);
+
+	cout << "RemoveAt(1): " << list.RemoveAt(1) << ", RemoveAt(9): " << list.RemoveAt(9) << endl;
+	cout << "Remove(\"beta\"): " << list.Remove("beta") << endl;
+	PrintStrings("Removed", list);
+
+	list.AddHead("gamma");
+	cout << "Remove(Head()->Data()): " << list.Remove(list.Head()->Data()) << endl;
+	PrintStrings("Removed by the head's own view", list);
+
+	list.Compact();
+	PrintStrings("Compacted", list);
+
+	LinkedList<string, Strings> copy(list);
+	LinkedList<string, Strings> assigned;
+	assigned.AddTail("replaced");
+	assigned = list;
+	cout << "Copy equal: " << (copy == list) << ", assigned equal: " << (assigned == list);
+	copy.RemoveHead();
+	assigned.AddTail("delta");
+	cout << ", after edits: " << (copy == list) << " " << (assigned == list) << endl;
+	PrintStrings("Original after editing the copies", list);
+
+	while (list.RemoveTail())
+	{
+	}
+	PrintStrings("Emptied", list);
+	list.AddTail("again");
+	PrintStrings("Reused", list);
+}